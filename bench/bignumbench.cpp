@@ -0,0 +1,268 @@
+/**
+ * Copyright (c) 2024 Stefan Uhrig
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+//------------------------------------------------------------------------------
+#include "bignum.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+//------------------------------------------------------------------------------
+using namespace bn;
+using namespace std;
+//------------------------------------------------------------------------------
+namespace {
+//------------------------------------------------------------------------------
+// Operand sizes are given in digits of impl::digit_t. The sizes of the
+// quadratic and cubic operations are capped, so that a single iteration takes
+// at most a few seconds.
+constexpr int64_t maxLinear = 1 << 20;
+constexpr int64_t maxQuadratic = 1 << 14;
+constexpr int64_t maxCubic = 1 << 8;
+//------------------------------------------------------------------------------
+// Returns a random number with exactly numDigits digits.
+Unsigned randomUnsigned(int64_t numDigits, mt19937& gen)
+{
+    const size_t bits = static_cast<size_t>(numDigits) * impl::bitsPerDigit;
+    return Unsigned::random(bits - 1, gen) | (Unsigned(1) << (bits - 1));
+}
+//------------------------------------------------------------------------------
+void unsignedAdd(benchmark::State& state)
+{
+    mt19937 gen(0);
+    const Unsigned u = randomUnsigned(state.range(0), gen);
+    const Unsigned v = randomUnsigned(state.range(0), gen);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(u + v);
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(unsignedAdd)->RangeMultiplier(16)->Range(1, maxLinear)->Complexity();
+//------------------------------------------------------------------------------
+void unsignedSubtract(benchmark::State& state)
+{
+    mt19937 gen(0);
+    const Unsigned u = randomUnsigned(state.range(0), gen) << 1;
+    const Unsigned v = randomUnsigned(state.range(0), gen);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(u - v);
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(unsignedSubtract)
+    ->RangeMultiplier(16)
+    ->Range(1, maxLinear)
+    ->Complexity();
+//------------------------------------------------------------------------------
+void unsignedMultiply(benchmark::State& state)
+{
+    mt19937 gen(0);
+    const Unsigned u = randomUnsigned(state.range(0), gen);
+    const Unsigned v = randomUnsigned(state.range(0), gen);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(u * v);
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(unsignedMultiply)
+    ->RangeMultiplier(4)
+    ->Range(1, maxQuadratic)
+    ->Complexity();
+//------------------------------------------------------------------------------
+// Divides a number of 2n digits by a number of n digits.
+void unsignedDivide(benchmark::State& state)
+{
+    mt19937 gen(0);
+    const Unsigned u = randomUnsigned(2 * state.range(0), gen);
+    const Unsigned v = randomUnsigned(state.range(0), gen);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(u / v);
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(unsignedDivide)
+    ->RangeMultiplier(4)
+    ->Range(1, maxQuadratic)
+    ->Complexity();
+//------------------------------------------------------------------------------
+void unsignedModulo(benchmark::State& state)
+{
+    mt19937 gen(0);
+    const Unsigned u = randomUnsigned(2 * state.range(0), gen);
+    const Unsigned v = randomUnsigned(state.range(0), gen);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(u % v);
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(unsignedModulo)
+    ->RangeMultiplier(4)
+    ->Range(1, maxQuadratic)
+    ->Complexity();
+//------------------------------------------------------------------------------
+void unsignedPowmod(benchmark::State& state)
+{
+    mt19937 gen(0);
+    const Unsigned b = randomUnsigned(state.range(0), gen);
+    const Unsigned e = randomUnsigned(state.range(0), gen);
+    const Unsigned m = randomUnsigned(state.range(0), gen);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bn::powmod(b, e, m));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(unsignedPowmod)->RangeMultiplier(4)->Range(1, maxCubic)->Complexity();
+//------------------------------------------------------------------------------
+void unsignedGcd(benchmark::State& state)
+{
+    mt19937 gen(0);
+    const Unsigned u = randomUnsigned(state.range(0), gen);
+    const Unsigned v = randomUnsigned(state.range(0), gen);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bn::gcd(u, v));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(unsignedGcd)
+    ->RangeMultiplier(4)
+    ->Range(1, maxQuadratic)
+    ->Complexity();
+//------------------------------------------------------------------------------
+void unsignedSqrt(benchmark::State& state)
+{
+    mt19937 gen(0);
+    const Unsigned u = randomUnsigned(state.range(0), gen);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bn::sqrt(u));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(unsignedSqrt)
+    ->RangeMultiplier(4)
+    ->Range(1, maxQuadratic)
+    ->Complexity();
+//------------------------------------------------------------------------------
+void unsignedStr(benchmark::State& state)
+{
+    mt19937 gen(0);
+    const Unsigned u = randomUnsigned(state.range(0), gen);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(u.str());
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(unsignedStr)
+    ->RangeMultiplier(4)
+    ->Range(1, maxQuadratic)
+    ->Complexity();
+//------------------------------------------------------------------------------
+void unsignedStrHex(benchmark::State& state)
+{
+    mt19937 gen(0);
+    const Unsigned u = randomUnsigned(state.range(0), gen);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(u.str(16));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(unsignedStrHex)
+    ->RangeMultiplier(16)
+    ->Range(1, maxLinear)
+    ->Complexity();
+//------------------------------------------------------------------------------
+void unsignedParse(benchmark::State& state)
+{
+    mt19937 gen(0);
+    const string s = randomUnsigned(state.range(0), gen).str();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Unsigned(s.c_str()));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(unsignedParse)
+    ->RangeMultiplier(4)
+    ->Range(1, maxQuadratic)
+    ->Complexity();
+//------------------------------------------------------------------------------
+void unsignedParseHex(benchmark::State& state)
+{
+    mt19937 gen(0);
+    const string s = randomUnsigned(state.range(0), gen).str(16);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Unsigned::fromString(s, 16));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(unsignedParseHex)
+    ->RangeMultiplier(16)
+    ->Range(1, maxLinear)
+    ->Complexity();
+//------------------------------------------------------------------------------
+Rational randomRational(int64_t numDigits, mt19937& gen)
+{
+    return Rational(
+        Signed(randomUnsigned(numDigits, gen)), randomUnsigned(numDigits, gen));
+}
+//------------------------------------------------------------------------------
+void rationalAdd(benchmark::State& state)
+{
+    mt19937 gen(0);
+    const Rational x = randomRational(state.range(0), gen);
+    const Rational y = randomRational(state.range(0), gen);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(x + y);
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(rationalAdd)
+    ->RangeMultiplier(4)
+    ->Range(1, maxQuadratic)
+    ->Complexity();
+//------------------------------------------------------------------------------
+void rationalMultiply(benchmark::State& state)
+{
+    mt19937 gen(0);
+    const Rational x = randomRational(state.range(0), gen);
+    const Rational y = randomRational(state.range(0), gen);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(x * y);
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(rationalMultiply)
+    ->RangeMultiplier(4)
+    ->Range(1, maxQuadratic)
+    ->Complexity();
+//------------------------------------------------------------------------------
+}  // namespace
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::AddCustomContext(
+        "bn_digit_bits", std::to_string(impl::bitsPerDigit));
+    benchmark::AddCustomContext("bn_threads", std::to_string(threadCount()));
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -49,21 +49,52 @@
 #define BN_BIGNUM_H
 //------------------------------------------------------------------------------
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cctype>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <istream>
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <new>
 #include <ostream>
 #include <random>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <system_error>
 #include <type_traits>
 #include <utility>
+#include <vector>
+#ifdef BN_THREADS
+#include <condition_variable>
+#include <thread>
+#endif
+// Thresholds measured by bignumtune are picked up from bignum_tuning.h if it
+// can be found. Thresholds defined explicitly take precedence.
+#if !defined(BN_NO_TUNING) && !defined(BN_TUNE_PROGRAM) \
+    && defined(__has_include)
+#if __has_include("bignum_tuning.h")
+#include "bignum_tuning.h"
+#endif
+#endif
+#if defined(BN_WITH_MMAP) && (defined(__unix__) || defined(__APPLE__))
+#define BN_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 //------------------------------------------------------------------------------
 namespace bn {
 //------------------------------------------------------------------------------
@@ -85,6 +116,19 @@ static_assert(!std::is_const<digit_t>::value, "digit_t must not be const");
 static_assert(!std::is_same<bool, digit_t>::value, "digit_t must not be bool");
 //------------------------------------------------------------------------------
 constexpr unsigned bitsPerDigit = 8 * sizeof(digit_t);
+#ifdef BN_TUNED_DIGIT_BITS
+static_assert(
+    bitsPerDigit == BN_TUNED_DIGIT_BITS,
+    "bignum_tuning.h was generated for a different digit type");
+#endif
+//------------------------------------------------------------------------------
+// The thresholds are constants, except in bignumtune, which varies them at
+// runtime to measure the crossover points.
+#ifdef BN_TUNE_PROGRAM
+#define BN_TUNABLE static
+#else
+#define BN_TUNABLE constexpr
+#endif
 //------------------------------------------------------------------------------
 inline constexpr unsigned computeMaxDecDigitsPerDigit(digit_t val)
 {
@@ -100,6 +144,100 @@ inline constexpr digit_t computeMaxPow10PerDigit(digit_t val)
 constexpr digit_t maxPow10PerDigit =
     computeMaxPow10PerDigit(std::numeric_limits<digit_t>::max());
 //------------------------------------------------------------------------------
+// Compile-time parsing of decimal literals.
+//
+// A number is represented as a list of digits with the least significant digit
+// first. Parsing multiplies the list by 10 and adds the next decimal digit for
+// every character. The multiplication splits each digit into two halves, so
+// that no intermediate result exceeds digit_t.
+//------------------------------------------------------------------------------
+template<digit_t... D>
+struct DigitList
+{
+};
+//------------------------------------------------------------------------------
+constexpr unsigned bitsPerHalfDigit = bitsPerDigit / 2;
+constexpr digit_t halfDigitMask =
+    static_cast<digit_t>((static_cast<digit_t>(1) << bitsPerHalfDigit) - 1);
+//------------------------------------------------------------------------------
+inline constexpr digit_t mul10LowHalf(digit_t d, digit_t carry)
+{
+    return static_cast<digit_t>(10 * (d & halfDigitMask) + carry);
+}
+//------------------------------------------------------------------------------
+inline constexpr digit_t mul10HighHalf(digit_t d, digit_t carry)
+{
+    return static_cast<digit_t>(
+        10 * (d >> bitsPerHalfDigit)
+        + (mul10LowHalf(d, carry) >> bitsPerHalfDigit));
+}
+//------------------------------------------------------------------------------
+inline constexpr digit_t mul10Add(digit_t d, digit_t carry)
+{
+    return static_cast<digit_t>(
+        (static_cast<digit_t>(mul10HighHalf(d, carry) << bitsPerHalfDigit))
+        | (mul10LowHalf(d, carry) & halfDigitMask));
+}
+//------------------------------------------------------------------------------
+inline constexpr digit_t mul10Carry(digit_t d, digit_t carry)
+{
+    return static_cast<digit_t>(mul10HighHalf(d, carry) >> bitsPerHalfDigit);
+}
+//------------------------------------------------------------------------------
+template<typename Done, digit_t Carry, digit_t... Todo>
+struct MulAdd10;
+
+template<digit_t... Done, digit_t Carry>
+struct MulAdd10<DigitList<Done...>, Carry>
+{
+    using type = typename std::conditional<
+        Carry == 0,
+        DigitList<Done...>,
+        DigitList<Done..., Carry>>::type;
+};
+
+template<digit_t... Done, digit_t Carry, digit_t First, digit_t... Todo>
+struct MulAdd10<DigitList<Done...>, Carry, First, Todo...>
+    : MulAdd10<
+          DigitList<Done..., mul10Add(First, Carry)>,
+          mul10Carry(First, Carry),
+          Todo...>
+{
+};
+//------------------------------------------------------------------------------
+template<typename List, digit_t Add>
+struct AppendDecimal;
+
+template<digit_t... D, digit_t Add>
+struct AppendDecimal<DigitList<D...>, Add> : MulAdd10<DigitList<>, Add, D...>
+{
+};
+//------------------------------------------------------------------------------
+template<typename List, char... C>
+struct ParseDecimal
+{
+    using type = List;
+};
+
+template<typename List, char First, char... Rest>
+struct ParseDecimal<List, First, Rest...>
+    : ParseDecimal<
+          typename AppendDecimal<List, static_cast<digit_t>(First - '0')>::type,
+          Rest...>
+{
+    static_assert(
+        (First >= '0') && (First <= '9'),
+        "only decimal integer literals are supported");
+    // A leading zero would make the literal octal in C++.
+    static_assert(
+        (First != '0') || (sizeof...(Rest) == 0)
+            || !std::is_same<List, DigitList<>>::value,
+        "decimal integer literals must not have leading zeros");
+};
+//------------------------------------------------------------------------------
+template<digit_t... D>
+class UnsignedLiteral;
+//------------------------------------------------------------------------------
 // The seven primitive operations on which all algorithms are based.
 //------------------------------------------------------------------------------
 /*
@@ -184,15 +322,343 @@ template<typename T>
 typename std::enable_if<std::is_unsigned<T>::value, std::size_t>::type
     countTrailingZeroes(T val);
 //------------------------------------------------------------------------------
+// The built-in integer types that the arithmetic operators accept without
+// converting them to a number first.
+template<typename T>
+struct IsNativeIntegral
+    : std::integral_constant<
+          bool,
+          std::is_integral<T>::value && !std::is_same<T, bool>::value
+              && (sizeof(T) <= sizeof(std::uint64_t))>
+{
+};
+template<typename T, typename R>
+using IfNative = typename std::enable_if<IsNativeIntegral<T>::value, R>::type;
+//------------------------------------------------------------------------------
+// Absolute value and sign of a built-in integer.
+template<typename T>
+typename std::enable_if<std::is_signed<T>::value, std::uint64_t>::type
+    magnitude(T i);
+template<typename T>
+typename std::enable_if<std::is_unsigned<T>::value, std::uint64_t>::type
+    magnitude(T i);
+template<typename T>
+typename std::enable_if<std::is_signed<T>::value, int>::type signum(T i);
+template<typename T>
+typename std::enable_if<std::is_unsigned<T>::value, int>::type signum(T i);
+// Returns the magnitude of i and throws std::invalid_argument if i is negative.
+template<typename T>
+std::uint64_t nonNegative(T i);
+bool fitsInDigit(std::uint64_t m);
+std::uint64_t gcd64(std::uint64_t a, std::uint64_t b);
+// Returns the inverse of an odd digit modulo the base.
+digit_t inverseDigit(digit_t d);
+//------------------------------------------------------------------------------
 class Store;
+struct Radix;
+class RadixPowers;
 //------------------------------------------------------------------------------
 }  // namespace impl
 //------------------------------------------------------------------------------
 template<typename T>
 struct EnableUserDefinedIntegral;
 class Unsigned;
+class UnsignedView;
+struct PowmodScratch;
 class Signed;
 class Rational;
+template<std::size_t Bits>
+class FixedUnsigned;
+template<std::size_t Bits>
+class FixedSigned;
+template<std::size_t Bits>
+class UnsignedBatch;
+//------------------------------------------------------------------------------
+namespace impl {
+//------------------------------------------------------------------------------
+template<typename Reader>
+Rational readRational(Reader& reader);
+//------------------------------------------------------------------------------
+}  // namespace impl
+//------------------------------------------------------------------------------
+/*******************************************************************************
+ * Result of bn::to_chars.
+ ******************************************************************************/
+struct ToCharsResult
+{
+    /// One past the last written character or the end of the range on error.
+    char* ptr;
+    /// The error code, which is value-initialized on success.
+    std::errc ec;
+};
+
+/*******************************************************************************
+ * Result of bn::from_chars.
+ ******************************************************************************/
+struct FromCharsResult
+{
+    /// The first character not consumed or the beginning of the range on error.
+    const char* ptr;
+    /// The error code, which is value-initialized on success.
+    std::errc ec;
+};
+
+/*******************************************************************************
+ * Byte order of the binary representation used by Unsigned::fromBytes and
+ * Unsigned::toBytes.
+ ******************************************************************************/
+enum class Endianness
+{
+    /// The least significant byte comes first.
+    little,
+    /// The most significant byte comes first.
+    big,
+    /// Words are ordered from least to most significant and the bytes in each
+    /// word are in the byte order of the platform, like in an array of native
+    /// unsigned integers.
+    native
+};
+
+/**
+ * Sets the number of threads used by parallel algorithms.
+ *
+ * The calling thread of an operation counts as one of the threads, so a count
+ * of 1 disables parallel execution, which is the default. Operations only run
+ * in parallel above size thresholds where the work outweighs the costs of
+ * synchronization, e.g. BN_PARALLEL_MUL_THRESHOLD for multiplication. Work
+ * forked by recursive algorithms such as binary splitting is distributed over
+ * the threads by work stealing, and nested parallel operations share the same
+ * threads. Threads are only used if the library is compiled with BN_THREADS,
+ * otherwise this function has no effect.
+ *
+ * This function must not be called while other threads use the library.
+ *
+ * @param n  The number of threads or 0 to use the number of hardware threads.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+void setThreadCount(std::size_t n);
+
+/**
+ * Returns the number of threads used by parallel algorithms.
+ *
+ * @return  Returns the number of threads including the calling thread.
+ *
+ * @par  Runtime complexity
+ *       O(1)
+ */
+std::size_t threadCount();
+
+/**
+ * Precomputes the tables used to convert numbers with up to numChars
+ * characters in the given base from and to strings.
+ *
+ * The divide-and-conquer conversion of large numbers uses the powers
+ * base^(k*2^i), where base^k is the largest power of base that fits into a
+ * digit. They are computed on first use and cached for the whole process, up to
+ * the limit set by setCacheLimit(), so that later conversions in any thread
+ * reuse them. Calling this function at startup moves the cost of computing
+ * them out of the first conversions. The cache is thread-safe and cached
+ * tables are read without locking.
+ *
+ * @param numChars  The maximum number of characters.
+ * @param base      The base of the conversions.
+ * @throw std::invalid_argument  Thrown if base is not in the range [2, 36].
+ *
+ * @par  Runtime complexity
+ *       O(n^2), where n is numChars.
+ */
+void prewarmCaches(std::size_t numChars, unsigned base = 10);
+
+/**
+ * Sets the maximum memory used by the process-wide caches.
+ *
+ * Tables that would exceed the limit are computed for each operation instead
+ * of being cached. Lowering the limit does not free tables that are already
+ * cached, see clearCaches(). The default limit is BN_CACHE_LIMIT bytes.
+ *
+ * @param bytes  The limit in bytes.
+ *
+ * @par  Runtime complexity
+ *       O(1)
+ */
+void setCacheLimit(std::size_t bytes);
+
+/**
+ * Returns the maximum memory used by the process-wide caches.
+ *
+ * @return  Returns the limit in bytes.
+ *
+ * @par  Runtime complexity
+ *       O(1)
+ */
+std::size_t cacheLimit();
+
+/**
+ * Returns the memory currently used by the process-wide caches.
+ *
+ * @return  Returns the number of bytes.
+ *
+ * @par  Runtime complexity
+ *       O(1)
+ */
+std::size_t cacheMemory();
+
+/**
+ * Frees all tables of the process-wide caches.
+ *
+ * This function must not be called while other threads use the library.
+ *
+ * @par  Runtime complexity
+ *       O(n), where n is the number of cached tables.
+ */
+void clearCaches();
+
+/*******************************************************************************
+ * Operations counted when the library is compiled with BN_INSTRUMENT.
+ *
+ * Operations of Signed, Rational and the convenience functions are counted as
+ * the operations on Unsigned they are implemented with.
+ ******************************************************************************/
+enum class Operation
+{
+    /// Addition.
+    add,
+    /// Subtraction.
+    subtract,
+    /// Multiplication.
+    multiply,
+    /// Division with quotient and remainder.
+    divide,
+    /// Modular exponentiation.
+    powmod,
+    /// Integer square root.
+    sqrt,
+    /// Greatest common divisor.
+    gcd,
+    /// Conversion to a string.
+    format,
+    /// Conversion from a string. The operand size is the maximum number of
+    /// digits of the result.
+    parse
+};
+
+/// The number of values of Operation.
+constexpr std::size_t numOperations = 9;
+/// The number of buckets of the operand size histograms.
+constexpr std::size_t numSizeBuckets = 32;
+
+/*******************************************************************************
+ * Counters of one operation, see Statistics.
+ ******************************************************************************/
+struct OperationStatistics
+{
+    /// The number of calls.
+    std::uint64_t calls;
+    /// The time spent in the calls in nanoseconds, including the time of
+    /// nested operations, which are counted as well.
+    std::uint64_t nanoseconds;
+    /// sizes[k] is the number of calls whose largest operand has between
+    /// 2^(k-1) and 2^k - 1 digits, so sizes[0] counts calls on zeros. The last
+    /// bucket also counts all larger operands.
+    std::uint64_t sizes[numSizeBuckets];
+};
+
+/*******************************************************************************
+ * Snapshot of the counters of the instrumentation, see statistics().
+ ******************************************************************************/
+struct Statistics
+{
+    /// The counters of each operation, indexed by Operation.
+    OperationStatistics operations[numOperations];
+    /// The number of digit buffers allocated on the heap.
+    std::uint64_t allocations;
+    /// The number of bytes of the allocated digit buffers.
+    std::uint64_t allocatedBytes;
+    /// The number of allocations that replaced the buffer of a number when it
+    /// was resized. They are included in allocations.
+    std::uint64_t reallocations;
+    /// The number of digit buffers freed.
+    std::uint64_t deallocations;
+};
+
+/**
+ * Returns a snapshot of the counters of the instrumentation.
+ *
+ * The counters are only updated if the library is compiled with BN_INSTRUMENT,
+ * otherwise all counters are 0. They are process-wide and updated atomically,
+ * so a snapshot taken while other threads use the library is consistent for
+ * each single counter.
+ *
+ * @return  Returns the counters.
+ *
+ * @par  Runtime complexity
+ *       O(1)
+ */
+Statistics statistics();
+
+/**
+ * Resets all counters of the instrumentation to 0.
+ *
+ * @par  Runtime complexity
+ *       O(1)
+ */
+void resetStatistics();
+
+/**
+ * Returns the name of an operation, e.g. "multiply".
+ *
+ * @param op  The operation.
+ * @return    Returns the name.
+ *
+ * @par  Runtime complexity
+ *       O(1)
+ */
+const char* operationName(Operation op);
+
+/*******************************************************************************
+ * An operation reported to the hook set with setTraceHook().
+ ******************************************************************************/
+struct TraceEvent
+{
+    /// The operation.
+    Operation operation;
+    /// The name of the operation, see operationName().
+    const char* name;
+    /// The number of digits of the operands in the order of the parameters of
+    /// the operation. Unused entries are 0.
+    std::size_t digits[3];
+    /// The duration of the operation, including nested operations.
+    std::chrono::nanoseconds elapsed;
+};
+
+/**
+ * Sets a hook that is called after operations on large operands or that take
+ * long, e.g. to find the inputs causing latency spikes in production.
+ *
+ * An operation is reported if its largest operand has at least minDigits
+ * digits or if it takes at least minTime. A threshold of 0 disables its
+ * condition, so only the other threshold applies. If both are 0, every
+ * operation is reported. The operations and their operand sizes are those of
+ * Operation. Operations called by the hook itself are not
+ * reported. The hook may be called concurrently from all threads using the
+ * library and must not throw.
+ *
+ * While no hook is set, checking for it costs a relaxed atomic load per
+ * operation. The hook can be set and removed at any time.
+ *
+ * @param hook       The hook or an empty function to remove the hook.
+ * @param minDigits  The minimum operand size that is reported.
+ * @param minTime    The minimum duration that is reported.
+ *
+ * @par  Runtime complexity
+ *       O(1)
+ */
+void setTraceHook(
+    std::function<void(const TraceEvent&)> hook,
+    std::size_t minDigits,
+    std::chrono::nanoseconds minTime);
 //------------------------------------------------------------------------------
 namespace impl {
 //------------------------------------------------------------------------------
@@ -218,6 +684,9 @@ public:
     const impl::digit_t& operator[](std::size_t i) const noexcept;
     impl::digit_t& operator[](std::size_t i) noexcept;
     void resize(std::size_t newsize);
+    // Like resize, but never releases memory, so that numbers used as
+    // destinations keep their capacity.
+    void setSize(std::size_t newsize);
 
 private:
     static void deallocate(void* ptr);
@@ -339,6 +808,16 @@ public:
      */
     Unsigned(const char* dec);
 
+    /**
+     * Constructs a number from a view by copying the viewed digits.
+     *
+     * @param v  The view to copy the number from.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    explicit Unsigned(UnsignedView v);
+
     /**
      * Copy assigns another number to this number.
      *
@@ -378,6 +857,55 @@ public:
     template<typename Generator>
     static Unsigned random(std::size_t numBits, Generator& gen);
 
+    /**
+     * Parses a number from a string.
+     *
+     * Letters represent the digits from 10 to 35 and may be upper or lower
+     * case.
+     *
+     * @param s     The string to parse.
+     * @param base  The base of the string, which must be from 2 to 36.
+     * @return      Returns the parsed number.
+     *
+     * @exception std::invalid_argument  Thrown if the base is invalid, if the
+     *                                   string is empty or if it contains a
+     *                                   character that is not a digit in the
+     *                                   base.
+     *
+     * @par  Runtime complexity
+     *       O(n) if base is a power of two, O(n^2) otherwise
+     */
+    static Unsigned fromString(const std::string& s, unsigned base);
+
+    /**
+     * Constructs a number from its binary representation.
+     *
+     * The bytes are divided into words of wordSize bytes. The word size only
+     * matters for Endianness::native, in which case the representation matches
+     * an array of native unsigned integers of that size. If the word size
+     * equals the size of bn::impl::digit_t or the representation is little
+     * endian on a little endian platform, the bytes are copied with memcpy.
+     *
+     * @param data      Pointer to the bytes.
+     * @param len       The number of bytes, which must be a multiple of the
+     *                  word size.
+     * @param order     The byte order of the representation.
+     * @param wordSize  The number of bytes per word.
+     * @return          Returns the number represented by the bytes. An empty
+     *                  range represents 0.
+     *
+     * @exception std::invalid_argument  Thrown if the word size is 0 or if len
+     *                                   is not a multiple of the word size.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    static Unsigned fromBytes(
+        const void* data,
+        std::size_t len,
+        Endianness order = Endianness::little,
+        std::size_t wordSize = 1);
+
 public:
     /**
      * Pre-increment operator.
@@ -548,6 +1076,93 @@ public:
      */
     Unsigned& operator%=(const Unsigned& v);
 
+    /**
+     * Adds a built-in integer to this number.
+     *
+     * The integer is not converted to a number first if it fits into a digit.
+     *
+     * @tparam T  A built-in integer type of at most 64 bits.
+     * @param v   The integer.
+     * @return    Returns a reference to this number.
+     *
+     * @exception std::invalid_argument  Thrown if v is negative.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    template<typename T>
+    impl::IfNative<T, Unsigned&> operator+=(T v);
+
+    /**
+     * Subtracts a built-in integer from this number.
+     *
+     * The integer is not converted to a number first if it fits into a digit.
+     *
+     * @tparam T  A built-in integer type of at most 64 bits.
+     * @param v   The integer.
+     * @return    Returns a reference to this number.
+     *
+     * @exception std::invalid_argument  Thrown if v is negative or greater
+     *                                   than this number.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    template<typename T>
+    impl::IfNative<T, Unsigned&> operator-=(T v);
+
+    /**
+     * Multiplies this number with a built-in integer.
+     *
+     * The integer is not converted to a number first if it fits into a digit.
+     *
+     * @tparam T  A built-in integer type of at most 64 bits.
+     * @param v   The integer.
+     * @return    Returns a reference to this number.
+     *
+     * @exception std::invalid_argument  Thrown if v is negative.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    template<typename T>
+    impl::IfNative<T, Unsigned&> operator*=(T v);
+
+    /**
+     * Divides this number by a built-in integer.
+     *
+     * The integer is not converted to a number first if it fits into a digit.
+     *
+     * @tparam T  A built-in integer type of at most 64 bits.
+     * @param v   The integer.
+     * @return    Returns a reference to this number.
+     *
+     * @exception std::invalid_argument  Thrown if v is negative or 0.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    template<typename T>
+    impl::IfNative<T, Unsigned&> operator/=(T v);
+
+    /**
+     * Computes the remainder when dividing this number by a built-in integer.
+     *
+     * The remainder is computed without storing the quotient if the integer
+     * fits into a digit.
+     *
+     * @tparam T  A built-in integer type of at most 64 bits.
+     * @param v   The integer.
+     * @return    Returns a reference to this number.
+     *
+     * @exception std::invalid_argument  Thrown if v is negative or 0.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    template<typename T>
+    impl::IfNative<T, Unsigned&> operator%=(T v);
+
     /**
      * Divides this number by the passed number and returns the remainder of the
      * division.
@@ -620,25 +1235,86 @@ public:
     std::string str() const;
 
     /**
-     * Returns the number of digits in this number, which is the number of
-     * bn::impl::digit_t elements in this number.
+     * Returns the string representation of this number in the given base.
      *
-     * @return  Returns the number of digits in this number, which is the number
-     *          of bn::impl::digit_t elements in this number.
+     * @param base       The base, which must be from 2 to 36.
+     * @param uppercase  Whether to use upper case letters for the digits from
+     *                   10 to 35.
+     * @return           Returns the string representation of this number.
+     *
+     * @exception std::invalid_argument  Thrown if the base is invalid.
      *
      * @par  Runtime complexity
-     *       O(1)
+     *       O(n) if base is a power of two, O(n^2) otherwise
      */
-    std::size_t digits() const;
+    std::string str(unsigned base, bool uppercase = false) const;
 
-public:
-    struct QR;
-
-private:
-    template<int S, typename T>
-    static typename std::enable_if<S >= 8 * sizeof(T), T>::type
-        safeRightShift(T val);
-    template<int S, typename T>
+    /**
+     * Writes the binary representation of this number to a buffer.
+     *
+     * The representation is padded with zero bytes to fill the buffer. See
+     * fromBytes for the meaning of the byte order and the word size.
+     *
+     * @param data      Pointer to the buffer.
+     * @param len       The size of the buffer in bytes, which must be a
+     *                  multiple of the word size.
+     * @param order     The byte order of the representation.
+     * @param wordSize  The number of bytes per word.
+     *
+     * @exception std::invalid_argument  Thrown if the word size is 0 or if len
+     *                                   is not a multiple of the word size.
+     * @exception std::overflow_error    Thrown if this number needs more than
+     *                                   len bytes.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    void toBytes(
+        void* data,
+        std::size_t len,
+        Endianness order = Endianness::little,
+        std::size_t wordSize = 1) const;
+
+    /**
+     * Returns the binary representation of this number.
+     *
+     * The representation consists of the smallest number of words that can hold
+     * this number, so it is empty for 0. See fromBytes for the meaning of the
+     * byte order and the word size.
+     *
+     * @param order     The byte order of the representation.
+     * @param wordSize  The number of bytes per word.
+     * @return          Returns the bytes.
+     *
+     * @exception std::invalid_argument  Thrown if the word size is 0.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    std::vector<std::uint8_t> toBytes(
+        Endianness order = Endianness::little,
+        std::size_t wordSize = 1) const;
+
+    /**
+     * Returns the number of digits in this number, which is the number of
+     * bn::impl::digit_t elements in this number.
+     *
+     * @return  Returns the number of digits in this number, which is the number
+     *          of bn::impl::digit_t elements in this number.
+     *
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    std::size_t digits() const;
+
+public:
+    struct QR;
+
+private:
+    template<int S, typename T>
+    static typename std::enable_if<S >= 8 * sizeof(T), T>::type
+        safeRightShift(T val);
+    template<int S, typename T>
         static typename std::enable_if
         < S<8 * sizeof(T), T>::type safeRightShift(T val);
     template<typename T>
@@ -658,10 +1334,52 @@ private:
 
     std::size_t countLeadingZeroes() const;
 
+    static std::size_t maxChars(std::size_t numBits, unsigned base);
+    char* format(char* last, unsigned base, bool uppercase) const;
+    char* formatPow2(char* last, unsigned log2Base, bool uppercase) const;
+    static char* formatRecursive(
+        const Unsigned& u,
+        std::size_t level,
+        const impl::RadixPowers& pows,
+        char* last,
+        const impl::Radix& radix,
+        bool uppercase,
+        bool pad);
+    static bool
+        parse(const char* first, const char* last, unsigned base, Unsigned& u);
+    static bool parsePow2(
+        const char* first,
+        const char* last,
+        unsigned log2Base,
+        Unsigned& u);
+    static bool parseRecursive(
+        const char* first,
+        const char* last,
+        const impl::RadixPowers& pows,
+        const impl::Radix& radix,
+        Unsigned& u);
+
+    static void multiply(UnsignedView u, UnsignedView v, Unsigned& w);
+    static void multiplyParallel(UnsignedView u, UnsignedView v, Unsigned& w);
+    static void multiplyAny(UnsignedView u, UnsignedView v, Unsigned& w);
+    static void
+        multiplyLow(UnsignedView u, UnsignedView v, std::size_t n, Unsigned& w);
+    static void multiplyHigh(
+        UnsignedView u,
+        UnsignedView v,
+        std::size_t n,
+        Unsigned& w);
+    static void multiplyMiddle(UnsignedView u, UnsignedView v, Unsigned& w);
+    static void
+        divide(UnsignedView u, UnsignedView v, Unsigned& q, Unsigned& r);
+
     void addDigit(impl::digit_t d);
     void subtractDigit(impl::digit_t d);
     void multiplyByDigit(impl::digit_t d);
     impl::digit_t divideByDigitReturnRem(impl::digit_t d);
+    impl::digit_t remainderByDigit(impl::digit_t d) const;
+    bool isDivisibleByOddDigit(impl::digit_t d) const;
+    bool isDivisibleByOdd(const Unsigned& v) const;
 
     static impl::digit_t findDivQuotient(
         impl::digit_t un,
@@ -676,7 +1394,8 @@ private:
         impl::digit_t vn2,
         std::size_t j);
 
-    void removeLeadingZeroDigits();
+    void assign(UnsignedView u);
+    void removeLeadingZeroDigits(bool keepCapacity = false);
 
 private:
     friend bool operator==(const Unsigned& u, const Unsigned& v);
@@ -700,11 +1419,56 @@ private:
     friend Unsigned operator%(const Unsigned& u, const Unsigned& v);
 
     friend Unsigned::QR div(const Unsigned& u, const Unsigned& v);
+    friend Unsigned divexact(const Unsigned& u, const Unsigned& d);
+    friend bool isDivisible(const Unsigned& u, const Unsigned& d);
+    friend bool isDivisibleBy2Exp(const Unsigned& u, std::size_t b);
+    friend bool
+        isCongruent(const Unsigned& u, const Unsigned& c, const Unsigned& d);
+    friend Unsigned
+        mulLow(const Unsigned& u, const Unsigned& v, std::size_t n);
+    friend Unsigned
+        mulHigh(const Unsigned& u, const Unsigned& v, std::size_t n);
+    friend Unsigned mulMiddle(const Unsigned& u, const Unsigned& v);
+
+    template<typename T>
+    friend impl::IfNative<T, Unsigned> operator%(const Unsigned& u, T v);
+
+    friend Unsigned operator+(UnsignedView u, UnsignedView v);
+    friend Unsigned operator-(UnsignedView u, UnsignedView v);
+    friend Unsigned operator*(UnsignedView u, UnsignedView v);
+    friend Unsigned::QR div(UnsignedView u, UnsignedView v);
+    friend std::size_t maxChars(UnsignedView u, unsigned base);
+
+    friend std::size_t maxChars(const Unsigned& u, unsigned base);
+    friend ToCharsResult
+        to_chars(char* first, char* last, const Unsigned& u, unsigned base);
+    friend FromCharsResult from_chars(
+        const char* first,
+        const char* last,
+        Unsigned& u,
+        unsigned base);
 
     friend Unsigned
         powmod(const Unsigned& u, Unsigned exp, const Unsigned& mod);
 
+    friend void add(Unsigned& w, const Unsigned& u, const Unsigned& v);
+    friend void sub(Unsigned& w, const Unsigned& u, const Unsigned& v);
+    friend void mul(Unsigned& w, const Unsigned& u, const Unsigned& v);
+    friend void
+        divQR(Unsigned& q, Unsigned& r, const Unsigned& u, const Unsigned& v);
+    friend void powmod(
+        Unsigned& w,
+        const Unsigned& u,
+        const Unsigned& exp,
+        const Unsigned& mod,
+        PowmodScratch& scratch);
+
+    friend class UnsignedView;
     friend class Rational;
+    template<std::size_t Bits>
+    friend class FixedUnsigned;
+    template<impl::digit_t... D>
+    friend class impl::UnsignedLiteral;
 
 private:
     impl::Store digit;
@@ -720,6 +1484,23 @@ struct Unsigned::QR
     Unsigned rem;
 };
 
+/*******************************************************************************
+ * Intermediate numbers of bn::powmod.
+ *
+ * Passing the same scratch numbers to repeated calls of bn::powmod reuses their
+ * memory, so the calls do not allocate once the numbers have grown large
+ * enough.
+ ******************************************************************************/
+struct PowmodScratch
+{
+    /// The current power of the base.
+    Unsigned power;
+    /// The product before its reduction.
+    Unsigned product;
+    /// The quotient of the reduction, which is discarded.
+    Unsigned quotient;
+};
+
 /**
  * Equal comparison.
  *
@@ -923,6 +1704,372 @@ Unsigned operator/(const Unsigned& u, const Unsigned& v);
  */
 Unsigned operator%(const Unsigned& u, const Unsigned& v);
 
+/**
+ * Adds a number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The number.
+ * @param v   The integer.
+ * @return    Returns the sum.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Unsigned> operator+(const Unsigned& u, T v);
+
+/**
+ * Adds a number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The number.
+ * @return    Returns the sum.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Unsigned> operator+(T v, const Unsigned& u);
+
+/**
+ * Subtracts a built-in integer from a number.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The number.
+ * @param v   The integer.
+ * @return    Returns the difference.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative or the result
+ *                                   would be negative.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Unsigned> operator-(const Unsigned& u, T v);
+
+/**
+ * Subtracts a number from a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The number.
+ * @return    Returns the difference.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative or the result
+ *                                   would be negative.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Unsigned> operator-(T v, const Unsigned& u);
+
+/**
+ * Multiplies a number with a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The number.
+ * @param v   The integer.
+ * @return    Returns the product.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Unsigned> operator*(const Unsigned& u, T v);
+
+/**
+ * Multiplies a number with a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The number.
+ * @return    Returns the product.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Unsigned> operator*(T v, const Unsigned& u);
+
+/**
+ * Divides a number by a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The number.
+ * @param v   The integer.
+ * @return    Returns the quotient.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative or the divisor
+ *                                   is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Unsigned> operator/(const Unsigned& u, T v);
+
+/**
+ * Divides a built-in integer by a number.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The number.
+ * @return    Returns the quotient.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative or the divisor
+ *                                   is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Unsigned> operator/(T v, const Unsigned& u);
+
+/**
+ * Computes the remainder of dividing a number by a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The number.
+ * @param v   The integer.
+ * @return    Returns the remainder.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative or the divisor
+ *                                   is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Unsigned> operator%(const Unsigned& u, T v);
+
+/**
+ * Computes the remainder of dividing a built-in integer by a number.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The number.
+ * @return    Returns the remainder.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative or the divisor
+ *                                   is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Unsigned> operator%(T v, const Unsigned& u);
+
+/**
+ * Equal comparison of a number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The number.
+ * @param v   The integer.
+ * @return    Returns true if both are equal, false otherwise.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator==(const Unsigned& u, T v);
+
+/**
+ * Equal comparison of a number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The number.
+ * @return    Returns true if both are equal, false otherwise.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator==(T v, const Unsigned& u);
+
+/**
+ * Inequal comparison of a number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The number.
+ * @param v   The integer.
+ * @return    Returns true if both are not equal, false otherwise.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator!=(const Unsigned& u, T v);
+
+/**
+ * Inequal comparison of a number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The number.
+ * @return    Returns true if both are not equal, false otherwise.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator!=(T v, const Unsigned& u);
+
+/**
+ * Less than comparison of a number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The number.
+ * @param v   The integer.
+ * @return    Returns true if the first operand is less than the second
+ *            operand, false otherwise.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator<(const Unsigned& u, T v);
+
+/**
+ * Less than comparison of a number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The number.
+ * @return    Returns true if the first operand is less than the second
+ *            operand, false otherwise.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator<(T v, const Unsigned& u);
+
+/**
+ * Greater than or equal comparison of a number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The number.
+ * @param v   The integer.
+ * @return    Returns true if the first operand is greater than or equal to the
+ *            second operand, false otherwise.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator>=(const Unsigned& u, T v);
+
+/**
+ * Greater than or equal comparison of a number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The number.
+ * @return    Returns true if the first operand is greater than or equal to the
+ *            second operand, false otherwise.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator>=(T v, const Unsigned& u);
+
+/**
+ * Greater than comparison of a number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The number.
+ * @param v   The integer.
+ * @return    Returns true if the first operand is greater than the second
+ *            operand, false otherwise.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator>(const Unsigned& u, T v);
+
+/**
+ * Greater than comparison of a number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The number.
+ * @return    Returns true if the first operand is greater than the second
+ *            operand, false otherwise.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator>(T v, const Unsigned& u);
+
+/**
+ * Less than or equal comparison of a number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The number.
+ * @param v   The integer.
+ * @return    Returns true if the first operand is less than or equal to the
+ *            second operand, false otherwise.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator<=(const Unsigned& u, T v);
+
+/**
+ * Less than or equal comparison of a number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The number.
+ * @return    Returns true if the first operand is less than or equal to the
+ *            second operand, false otherwise.
+ *
+ * @exception std::invalid_argument  Thrown if v is negative.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator<=(T v, const Unsigned& u);
+
 /**
  * Divides a number by another.
  *
@@ -1018,15 +2165,260 @@ Unsigned bgcd(const Unsigned& u, const Unsigned& v);
 Unsigned gcd(const Unsigned& u, const Unsigned& v);
 
 /**
- * Writes a number in base 10 to an output stream.
+ * Divides a number by one of its divisors.
  *
- * @param out  An output stream.
- * @param u    The number.
- * @return     Returns the output stream.
+ * The quotient is computed from the least significant digit upwards by
+ * multiplying with the inverse of the divisor modulo the base, which needs
+ * neither quotient digit estimates nor normalization. Use it where the
+ * division is known to be exact, e.g. after dividing by a common divisor.
+ *
+ * @param u  Divident. Must be a multiple of d.
+ * @param d  Divisor.
+ * @return   Returns u / d. The result is unspecified if d does not divide u.
+ *
+ * @exception std::invalid_argument  Thrown if the divisor is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n*m)
+ */
+Unsigned divexact(const Unsigned& u, const Unsigned& d);
+
+/**
+ * Checks whether a number is divisible by another.
+ *
+ * No quotient is stored. The check removes the trailing zero bits of d and
+ * clears u from the least significant digit upwards with the inverse of the
+ * lowest digit of d modulo the base, so divisors that fit into a digit need
+ * neither a division nor a copy of u.
+ *
+ * @param u  A number.
+ * @param d  The divisor. Only 0 is divisible by 0.
+ * @return   Returns true if d divides u.
+ *
+ * @par  Runtime complexity
+ *       O(n*m)
+ */
+bool isDivisible(const Unsigned& u, const Unsigned& d);
+
+/**
+ * Checks whether a number is divisible by a power of two.
+ *
+ * @param u  A number.
+ * @param b  The exponent of the power of two.
+ * @return   Returns true if the lowest b bits of u are 0.
+ *
+ * @par  Runtime complexity
+ *       O(b)
+ */
+bool isDivisibleBy2Exp(const Unsigned& u, std::size_t b);
+
+/**
+ * Checks whether two numbers are congruent modulo a third.
+ *
+ * @param u  A number.
+ * @param c  Another number.
+ * @param d  The modulus. Numbers are congruent modulo 0 if they are equal.
+ * @return   Returns true if d divides the difference of u and c.
+ *
+ * @par  Runtime complexity
+ *       O(n*m)
+ */
+bool isCongruent(const Unsigned& u, const Unsigned& c, const Unsigned& d);
+
+/**
+ * Computes the lowest digits of a product.
+ *
+ * Only the partial products that contribute to the lowest n digits are
+ * computed, which takes about half the time of the full product for numbers
+ * of n digits.
+ *
+ * @param u  The first factor.
+ * @param v  The second factor.
+ * @param n  The number of digits to compute.
+ * @return   Returns u*v mod base^n.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+Unsigned mulLow(const Unsigned& u, const Unsigned& v, std::size_t n);
+
+/**
+ * Computes an approximation of the highest digits of a product.
+ *
+ * The partial products below digit n - 1 are skipped, which takes about half
+ * the time of the full product if n is about the number of digits of u and v.
+ * The skipped part is less than (n - 1)*base^n, so the result r satisfies
+ * p - n < r <= p for n > 0, where p = u*v / base^n. For n = 0 the result is
+ * exact.
+ *
+ * @param u  The first factor.
+ * @param v  The second factor.
+ * @param n  The number of lowest digits to drop.
+ * @return   Returns the product without its lowest n digits, which may be too
+ *           small by less than n.
+ *
+ * @par  Runtime complexity
+ *       O(n*m)
+ */
+Unsigned mulHigh(const Unsigned& u, const Unsigned& v, std::size_t n);
+
+/**
+ * Computes the middle product of two numbers.
+ *
+ * If u has n digits and v has m digits, the middle product is the sum of all
+ * u[i]*v[j]*base^(i + j - m + 1) with m - 1 <= i + j <= n - 1, i.e. the
+ * middle n - m + 1 digit columns of u*v including the carries between them,
+ * but without the carries from the lower columns. Newton iterations use it to
+ * get the middle of a product whose low and high parts are already known.
+ *
+ * @param u  The first factor.
+ * @param v  The second factor, which must not have more digits than u.
+ * @return   Returns the middle product.
+ *
+ * @exception std::invalid_argument  Thrown if v has more digits than u.
+ *
+ * @par  Runtime complexity
+ *       O((n - m + 1)*m)
+ */
+Unsigned mulMiddle(const Unsigned& u, const Unsigned& v);
+
+/**
+ * Adds two numbers into an existing number.
+ *
+ * The result is written to w, reusing its memory, so that loops calling this
+ * function with the same destination do not allocate once the destination has
+ * grown large enough. w may be the same object as u or v.
+ *
+ * @param w  Receives the sum.
+ * @param u  First summand.
+ * @param v  Second summand.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+void add(Unsigned& w, const Unsigned& u, const Unsigned& v);
+
+/**
+ * Subtracts a number from a number into an existing number.
+ *
+ * The result is written to w, reusing its memory. w may be the same object as
+ * u or v.
+ *
+ * @param w  Receives the difference. Its value is unspecified if an exception
+ *           is thrown.
+ * @param u  Minuend.
+ * @param v  Subtrahend.
+ *
+ * @exception std::invalid_argument  Thrown if the subtrahend is greater than
+ *                                   the minuend.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+void sub(Unsigned& w, const Unsigned& u, const Unsigned& v);
+
+/**
+ * Multiplies two numbers into an existing number.
+ *
+ * The result is written to w, reusing its memory. w may be the same object as
+ * u or v, in which case the product is computed in a temporary number first.
+ *
+ * @param w  Receives the product.
+ * @param u  First factor.
+ * @param v  Second factor.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+void mul(Unsigned& w, const Unsigned& u, const Unsigned& v);
+
+/**
+ * Divides a number by another into existing numbers.
+ *
+ * The quotient and the remainder are written to q and r, reusing their memory.
+ * u may be the same object as q or r. v may be the same object as q or r, in
+ * which case the divisor is copied first.
+ *
+ * @param q  Receives the quotient.
+ * @param r  Receives the remainder.
+ * @param u  Divident.
+ * @param v  Divisor.
+ *
+ * @exception std::invalid_argument  Thrown if the divisor is 0 or if q and r
+ *                                   are the same object.
  *
  * @par  Runtime complexity
  *       O(n^2)
  */
+void divQR(Unsigned& q, Unsigned& r, const Unsigned& u, const Unsigned& v);
+
+/**
+ * Computes a power modulo a number into an existing number.
+ *
+ * The result is written to w, reusing its memory. The intermediate products
+ * are kept in three numbers that are reused for all steps, so the number of
+ * allocations does not depend on the exponent. w may be the same object as any
+ * of the other arguments.
+ *
+ * @param w    Receives the power.
+ * @param u    The base.
+ * @param exp  The exponent.
+ * @param mod  The modulus.
+ *
+ * @exception std::invalid_argument  Thrown if the modulus is 0 and the exponent
+ *                                   is not.
+ *
+ * @par  Runtime complexity
+ *       O(log(exp)*mod^2)
+ */
+void powmod(
+    Unsigned& w,
+    const Unsigned& u,
+    const Unsigned& exp,
+    const Unsigned& mod);
+
+/**
+ * Computes a power modulo a number into an existing number using scratch
+ * numbers of the caller.
+ *
+ * Like powmod(Unsigned&, const Unsigned&, const Unsigned&, const Unsigned&),
+ * but the intermediate products are kept in scratch, so a loop passing the
+ * same destination and scratch numbers does not allocate once they have grown
+ * large enough. The numbers in scratch must not be passed as the other
+ * arguments.
+ *
+ * @param w        Receives the power.
+ * @param u        The base.
+ * @param exp      The exponent.
+ * @param mod      The modulus.
+ * @param scratch  Scratch numbers, whose values are overwritten.
+ *
+ * @exception std::invalid_argument  Thrown if the modulus is 0 and the exponent
+ *                                   is not.
+ *
+ * @par  Runtime complexity
+ *       O(log(exp)*mod^2)
+ */
+void powmod(
+    Unsigned& w,
+    const Unsigned& u,
+    const Unsigned& exp,
+    const Unsigned& mod,
+    PowmodScratch& scratch);
+
+/**
+ * Writes a number to an output stream.
+ *
+ * The number is written in base 16 or 8 if std::hex or std::oct is set on the
+ * stream. std::showbase and std::uppercase are honored as well.
+ *
+ * @param out  An output stream.
+ * @param u    The number.
+ * @return     Returns the output stream.
+ *
+ * @par  Runtime complexity
+ *       O(n) for base 16 and 8, O(n^2) for base 10
+ */
 std::ostream& operator<<(std::ostream& out, const Unsigned& u);
 
 /**
@@ -1041,461 +2433,323 @@ std::ostream& operator<<(std::ostream& out, const Unsigned& u);
  */
 std::ostream& operator<<(std::ostream& out, const Unsigned::QR& qr);
 
+/**
+ * Returns an upper bound of the number of characters written by
+ * bn::to_chars.
+ *
+ * @param u     The number.
+ * @param base  The base, which must be from 2 to 36.
+ * @return      Returns the upper bound, which is exact for powers of two.
+ *
+ * @par  Runtime complexity
+ *       O(1)
+ */
+std::size_t maxChars(const Unsigned& u, unsigned base = 10);
+
+/**
+ * Writes the digits of a number to a character range.
+ *
+ * No terminating null character is written. Letters are lower case. If the
+ * range has at least bn::maxChars(u, base) characters, the output is written
+ * directly into the range. This function does not throw except for
+ * std::bad_alloc while converting to a base that is not a power of two.
+ *
+ * @param first  The beginning of the range.
+ * @param last   The end of the range.
+ * @param u      The number.
+ * @param base   The base, which must be from 2 to 36.
+ * @return       On success, returns the end of the written characters and a
+ *               value-initialized error code. Returns last and
+ *               std::errc::value_too_large if the range is too small and
+ *               std::errc::invalid_argument if the base is invalid.
+ *
+ * @par  Runtime complexity
+ *       O(n) if base is a power of two, O(n^2) otherwise
+ */
+ToCharsResult
+    to_chars(char* first, char* last, const Unsigned& u, unsigned base = 10);
+
+/**
+ * Parses a number from a character range.
+ *
+ * The range does not need to be null-terminated. As many characters are
+ * consumed as form a number in the given base. Letters may be upper or lower
+ * case.
+ *
+ * @param first  The beginning of the range.
+ * @param last   The end of the range.
+ * @param u      Receives the number on success. Left unchanged on failure.
+ * @param base   The base, which must be from 2 to 36.
+ * @return       On success, returns a pointer to the first character that was
+ *               not consumed and a value-initialized error code. Returns first
+ *               and std::errc::invalid_argument if the range does not start
+ *               with a digit or if the base is invalid.
+ *
+ * @par  Runtime complexity
+ *       O(n) if base is a power of two, O(n^2) otherwise
+ */
+FromCharsResult from_chars(
+    const char* first,
+    const char* last,
+    Unsigned& u,
+    unsigned base = 10);
+
 /*******************************************************************************
- * An integer of arbitrary precision.
+ * A read-only view of a natural number stored in externally owned memory.
+ *
+ * The view consists of a pointer to an array of bn::impl::digit_t elements,
+ * least significant digit first, and the number of digits. It does not own the
+ * memory, which must outlive the view. This allows computing on numbers stored
+ * in memory-mapped files or other buffers without copying them into a
+ * bn::Unsigned first.
+ *
+ * A bn::Unsigned converts implicitly to a view, so the operators taking views
+ * also accept any mix of views and numbers. Results are returned as
+ * bn::Unsigned.
  ******************************************************************************/
-class Signed
+class UnsignedView final
 {
 public:
     /**
      * Default constructor.
      *
-     * Initializes the integer to 0.
+     * The view refers to the number 0.
      *
      * @par  Runtime complexity
      *       O(1)
      */
-    Signed() noexcept;
+    UnsignedView() noexcept;
 
     /**
-     * Copy constructor.
+     * Constructs a view of a digit array.
      *
-     * @param other  The integer to copy.
+     * Leading zero digits are ignored, so arrays of fixed-width numbers can be
+     * viewed directly.
+     *
+     * @param data  Pointer to the digits, least significant digit first. May be
+     *              null if size is 0.
+     * @param size  The number of digits.
      *
      * @par  Runtime complexity
      *       O(n)
      */
-    Signed(const Signed& other);
+    UnsignedView(const impl::digit_t* data, std::size_t size) noexcept;
 
     /**
-     * Move constructor.
+     * Constructs a view of a number.
      *
-     * @param other  The integer to move.
-     *
-     * @par  Runtime complexity
-     *       O(1)
-     */
-    Signed(Signed&& other) noexcept;
-
-    /**
-     * Copy constructor from a natural number.
+     * The view is invalidated by any modification of the number.
      *
-     * @param other  The natural number to copy.
+     * @param u  The number.
      *
      * @par  Runtime complexity
-     *       O(n)
+     *       O(1)
      */
-    Signed(const Unsigned& other);
+    UnsignedView(const Unsigned& u) noexcept;
 
+public:
     /**
-     * Move constructor from a natural number.
+     * Returns a pointer to the digits.
      *
-     * @param other  The natural number to move.
+     * @return  Returns a pointer to the digits, least significant digit first.
      *
      * @par  Runtime complexity
      *       O(1)
      */
-    Signed(Unsigned&& other) noexcept;
+    const impl::digit_t* data() const noexcept;
 
     /**
-     * Constructs an integer from a signed 32-bit integer.
+     * Returns the number of digits without leading zero digits.
      *
-     * @param i  The signed integer to construct the number from.
+     * @return  Returns the number of digits.
      *
      * @par  Runtime complexity
      *       O(1)
      */
-    Signed(std::int32_t i);
+    std::size_t digits() const noexcept;
 
     /**
-     * Constructs an integer from an unsigned 32-bit integer.
+     * Returns a digit.
      *
-     * @param i  The unsigned integer to construct the number from.
+     * @param i  The index of the digit, which must be less than digits().
+     * @return   Returns the digit.
      *
      * @par  Runtime complexity
      *       O(1)
      */
-    Signed(std::uint32_t i);
+    impl::digit_t operator[](std::size_t i) const noexcept;
 
     /**
-     * Constructs an integer from a signed 64-bit integer.
+     * Checks whether the viewed number is 0.
      *
-     * @param i  The signed integer to construct the number from.
+     * @return  Returns true if the viewed number is 0, false otherwise.
      *
      * @par  Runtime complexity
      *       O(1)
      */
-    Signed(std::int64_t i);
+    bool empty() const noexcept;
 
     /**
-     * Constructs an integer from an unsigned 64-bit integer.
+     * Returns the number of bits the viewed number consists of.
      *
-     * @param i  The unsigned integer to construct the number from.
+     * @return  Returns the position of the highest bit plus one.
      *
      * @par  Runtime complexity
      *       O(1)
      */
-    Signed(std::uint64_t i);
+    std::size_t bits() const noexcept;
 
     /**
-     * Constructs an integer from a null-terminated string.
-     *
-     * @param dec  The null-terminated string to construct the integer from.
+     * Returns the string representation of the viewed number in base 10.
      *
-     * @exception std::invalid_argument  Thrown if the string is empty or does
-     *                                   not match the regular expression
-     *                                   -?[0-9]+.
+     * @return  Returns the string representation in base 10.
      *
      * @par  Runtime complexity
      *       O(n^2)
      */
-    Signed(const char* dec);
+    std::string str() const;
 
     /**
-     * Copy assignment.
-     *
-     * @param other  The integer to assign.
-     * @return       Returns a reference to this integer.
+     * Returns the string representation of the viewed number in the given
+     * base.
      *
-     * @par  Runtime complexity
-     *       O(n)
-     */
-    Signed& operator=(const Signed& other);
-
-    /**
-     * Move assignment.
+     * @param base       The base, which must be from 2 to 36.
+     * @param uppercase  Whether to use upper case letters for the digits from
+     *                   10 to 35.
+     * @return           Returns the string representation.
      *
-     * @param other  The integer to assign.
-     * @return       Returns a reference to this integer.
+     * @exception std::invalid_argument  Thrown if the base is invalid.
      *
      * @par  Runtime complexity
-     *       O(1)
+     *       O(n) if base is a power of two, O(n^2) otherwise
      */
-    Signed& operator=(Signed&& other) noexcept;
+    std::string str(unsigned base, bool uppercase = false) const;
 
-public:
-    /**
-     * Returns the sign of this integer.
-     *
-     * @return  Returns -1 if the integer is negative, 1 if the integer is
-     *          positive and 0 if the integer is 0.
-     *
-     * @par  Runtime complexity
-     *       O(1)
-     */
-    int sgn() const;
+private:
+    const impl::digit_t* ptr;
+    std::size_t sz;
+};
 
-    /**
-     * Returns the absolute value of this integer as natural number.
-     *
-     * @return  Return the absolute value of this integer.
-     *
-     * @par  Runtime complexity
-     *       O(1)
-     */
-    const Unsigned& abs() const;
+/**
+ * Equal comparison of viewed numbers.
+ *
+ * @param u  First number.
+ * @param v  Second number.
+ * @return   Returns true if both numbers are equal, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+bool operator==(UnsignedView u, UnsignedView v);
 
-    /**
-     * Pre-increment operator.
-     *
-     * Increases this integer by 1.
-     *
-     * @return  Returns a reference to this integer.
-     *
-     * @par  Runtime complexity
-     *       O(n)
-     */
-    Signed& operator++();
-
-    /**
-     * Post-increment operator.
-     *
-     * Increases this integer by 1.
-     *
-     * @return  Returns the value of the integer before increasing.
-     *
-     * @par  Runtime complexity
-     *       O(n)
-     */
-    Signed operator++(int);
-
-    /**
-     * Pre-decrement operator.
-     *
-     * Decreases this integer by 1.
-     *
-     * @return  Returns a reference to this integer.
-     *
-     * @par  Runtime complexity
-     *       O(n)
-     */
-    Signed& operator--();
-
-    /**
-     * Post-decrement operator.
-     *
-     * Decreases this integer by 1.
-     *
-     * @return  Returns the value of the integer before decreasing.
-     *
-     * @par  Runtime complexity
-     *       O(n)
-     */
-    Signed operator--(int);
-
-    /**
-     * Adds the passed integer to this integer.
-     *
-     * @param v  The integer to add.
-     * @return   Returns a reference to this integer.
-     *
-     * @par  Runtime complexity
-     *       O(n)
-     */
-    Signed& operator+=(const Signed& v);
-
-    /**
-     * Substracts the passed integer to this integer.
-     *
-     * @param v  The integer to subtract.
-     * @return   Returns a reference to this integer.
-     *
-     * @par  Runtime complexity
-     *       O(n)
-     */
-    Signed& operator-=(const Signed& v);
-
-    /**
-     * Multiplies this integer with the passed integer.
-     *
-     * @param v  The integer to multiply with.
-     * @return   Returns a reference to this integer.
-     *
-     * @par  Runtime complexity
-     *       O(n^2)
-     */
-    Signed& operator*=(const Signed& v);
-
-    /**
-     * Divides this integer by the passed integer.
-     *
-     * @param v  The integer to divide by.
-     * @return   Returns a reference to this integer.
-     *
-     * @exception std::invalid_argument  Thrown if v is 0.
-     *
-     * @par  Runtime complexity
-     *       O(n^2)
-     */
-    Signed& operator/=(const Signed& v);
-
-    /**
-     * Computes the remainder when dividing this integer by the passed integer.
-     *
-     * @param v  The integer to divide by.
-     * @return   Returns a reference to this integer.
-     *
-     * @exception std::invalid_argument  Thrown if v is 0.
-     *
-     * @par  Runtime complexity
-     *       O(n^2)
-     */
-    Signed& operator%=(const Signed& v);
-
-    /**
-     * Divides this integer by the passed integer and returns the remainder of
-     * the division.
-     *
-     * @param v  The integer to divide by.
-     * @return   Returns the integer of the division.
-     *
-     * @exception std::invalid_argument  Thrown if v is 0.
-     *
-     * @par  Runtime complexity
-     *       O(n^2)
-     */
-    Signed div(const Signed& v);
-
-    /**
-     * Returns the string representation of this integer in base 10.
-     *
-     * @return  Returns the string representation of this integer in base 10.
-     *
-     * @par  Runtime complexity
-     *       O(n^2)
-     */
-    std::string str() const;
-
-public:
-    struct QR;
-
-private:
-    friend bool operator==(const Signed& u, const Signed& v);
-    friend bool operator!=(const Signed& u, const Signed& v);
-    friend bool operator<(const Signed& u, const Signed& v);
-    friend bool operator>=(const Signed& u, const Signed& v);
-    friend bool operator>(const Signed& u, const Signed& v);
-    friend bool operator<=(const Signed& u, const Signed& v);
-
-    friend Signed operator-(const Signed& u);
-
-    friend Signed operator+(const Signed& u, const Signed& v);
-    friend Signed operator-(const Signed& u, const Signed& v);
-    friend Signed operator*(const Signed& u, const Signed& v);
-    friend Signed operator/(const Signed& u, const Signed& v);
-    friend Signed operator%(const Signed& u, const Signed& v);
-
-    friend QR div(const Signed& u, const Signed& v);
-
-    friend std::ostream& operator<<(std::ostream& out, const Signed& s);
-
-    friend class Rational;
-    friend Rational operator/(const Rational& u, const Rational& v);
-
-private:
-    Unsigned val;
-    int8_t sign;
-};
-
-/*******************************************************************************
- * Result of an integer division.
- ******************************************************************************/
-struct Signed::QR
-{
-    /// The quotient.
-    Signed quot;
-    /// The remainder. The remainder will have the same sign as the divident.
-    Signed rem;
-};
-
-/**
- * Equal comparison.
- *
- * @param u  First integer.
- * @param v  Second integer.
- * @return   Returns true if the integers are equal, false otherwise.
- *
- * @par  Runtime complexity
- *       O(n)
- */
-bool operator==(const Signed& u, const Signed& v);
-
-/**
- * Inequal comparison.
- *
- * @param u  First integer.
- * @param v  Second integer.
- * @return   Returns true if the integer are not equal, false otherwise.
- *
- * @par  Runtime complexity
- *       O(n)
- */
-bool operator!=(const Signed& u, const Signed& v);
+/**
+ * Unequal comparison of viewed numbers.
+ *
+ * @param u  First number.
+ * @param v  Second number.
+ * @return   Returns true if the numbers are unequal, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+bool operator!=(UnsignedView u, UnsignedView v);
 
 /**
- * Less than comparison.
+ * Less than comparison of viewed numbers.
  *
- * @param u  First integer.
- * @param v  Second integer.
- * @return   Returns true if the first integer is less than the second integer,
+ * @param u  First number.
+ * @param v  Second number.
+ * @return   Returns true if the first number is less than the second number,
  *           false otherwise.
  *
  * @par  Runtime complexity
  *       O(n)
  */
-bool operator<(const Signed& u, const Signed& v);
-
-/**
- * Greater than or equal comparison.
- *
- * @param u  First integer.
- * @param v  Second integer.
- * @return   Returns true if the first integer is greater than or equal to the
- *           second integer, false otherwise.
- *
- * @par  Runtime complexity
- *       O(n)
- */
-bool operator>=(const Signed& u, const Signed& v);
+bool operator<(UnsignedView u, UnsignedView v);
 
 /**
- * Greater than comparison.
+ * Greater than or equal comparison of viewed numbers.
  *
- * @param u  First integer.
- * @param v  Second integer.
- * @return   Returns true if the first integer is greater than the second
- *           integer, false otherwise.
+ * @param u  First number.
+ * @param v  Second number.
+ * @return   Returns true if the first number is greater than or equal to the
+ *           second number, false otherwise.
  *
  * @par  Runtime complexity
  *       O(n)
  */
-bool operator>(const Signed& u, const Signed& v);
+bool operator>=(UnsignedView u, UnsignedView v);
 
 /**
- * Less than or equal comparison.
+ * Greater than comparison of viewed numbers.
  *
- * @param u  First integer.
- * @param v  Second integer.
- * @return   Returns true if the first integer is less than or equal to the
- *           second integer, false otherwise.
+ * @param u  First number.
+ * @param v  Second number.
+ * @return   Returns true if the first number is greater than the second number,
+ *           false otherwise.
  *
  * @par  Runtime complexity
  *       O(n)
  */
-bool operator<=(const Signed& u, const Signed& v);
+bool operator>(UnsignedView u, UnsignedView v);
 
 /**
- * Negates an integer.
+ * Less than or equal comparison of viewed numbers.
  *
- * @param u  The integer to negate.
- * @return   The negated integer.
+ * @param u  First number.
+ * @param v  Second number.
+ * @return   Returns true if the first number is less than or equal to the
+ *           second number, false otherwise.
  *
  * @par  Runtime complexity
  *       O(n)
  */
-Signed operator-(const Signed& u);
+bool operator<=(UnsignedView u, UnsignedView v);
 
 /**
- * Adds two integers.
+ * Adds two viewed numbers.
  *
  * @param u  First summand.
  * @param v  Second summand.
- * @return   Returns the sum.
+ * @return   Returns the sum of both numbers.
  *
  * @par  Runtime complexity
  *       O(n)
  */
-Signed operator+(const Signed& u, const Signed& v);
+Unsigned operator+(UnsignedView u, UnsignedView v);
 
 /**
- * Subtracts an integer from an integer.
+ * Subtracts two viewed numbers.
  *
- * @param u  Minuend.
- * @param v  Subtrahend.
+ * @param u  The minuend.
+ * @param v  The subtrahend.
  * @return   Returns the difference.
  *
+ * @exception std::invalid_argument  Thrown if the subtrahend is larger than the
+ *                                   minuend.
+ *
  * @par  Runtime complexity
  *       O(n)
  */
-Signed operator-(const Signed& u, const Signed& v);
+Unsigned operator-(UnsignedView u, UnsignedView v);
 
 /**
- * Multiplies two integers with each other.
+ * Multiplies two viewed numbers.
  *
- * @param u  First factor.
- * @param v  Second factor.
+ * @param u  The multiplicand.
+ * @param v  The multiplier.
  * @return   Returns the product.
  *
  * @par  Runtime complexity
  *       O(n^2)
  */
-Signed operator*(const Signed& u, const Signed& v);
+Unsigned operator*(UnsignedView u, UnsignedView v);
 
 /**
- * Divides an integer by another.
+ * Divides two viewed numbers.
  *
- * @param u  Divident.
- * @param v  Divisor.
+ * @param u  The dividend.
+ * @param v  The divisor.
  * @return   Returns the quotient.
  *
  * @exception std::invalid_argument  Thrown if the divisor is 0.
@@ -1503,13 +2757,13 @@ Signed operator*(const Signed& u, const Signed& v);
  * @par  Runtime complexity
  *       O(n^2)
  */
-Signed operator/(const Signed& u, const Signed& v);
+Unsigned operator/(UnsignedView u, UnsignedView v);
 
 /**
- * Computes the remainder of a division.
+ * Computes the remainder of the division of two viewed numbers.
  *
- * @param u  Divident.
- * @param v  Divisor. if the divisor is 0.
+ * @param u  The dividend.
+ * @param v  The divisor.
  * @return   Returns the remainder.
  *
  * @exception std::invalid_argument  Thrown if the divisor is 0.
@@ -1517,432 +2771,804 @@ Signed operator/(const Signed& u, const Signed& v);
  * @par  Runtime complexity
  *       O(n^2)
  */
-Signed operator%(const Signed& u, const Signed& v);
+Unsigned operator%(UnsignedView u, UnsignedView v);
 
 /**
- * Divides an integer by another.
+ * Divides two viewed numbers and returns quotient and remainder.
  *
- * @param u  Divident.
- * @param v  Divisor.
- * @return   Returns the quotient and remainder.
+ * @param u  The dividend.
+ * @param v  The divisor.
+ * @return   Returns quotient and remainder.
  *
  * @exception std::invalid_argument  Thrown if the divisor is 0.
  *
  * @par  Runtime complexity
  *       O(n^2)
  */
-Signed::QR div(const Signed& u, const Signed& v);
+Unsigned::QR div(UnsignedView u, UnsignedView v);
 
 /**
- * Writes an integer in base 10 to an output stream.
+ * Writes a viewed number in base 10 to an output stream.
+ *
+ * The number is formatted like a bn::Unsigned.
  *
  * @param out  An output stream.
- * @param s    An integer.
+ * @param u    The viewed number.
  * @return     Returns the output stream.
  *
  * @par  Runtime complexity
  *       O(n^2)
  */
-std::ostream& operator<<(std::ostream& out, const Signed& s);
+std::ostream& operator<<(std::ostream& out, UnsignedView u);
 
-/*******************************************************************************
- * A rational number.
+/**
+ * Returns an upper bound of the number of characters of a viewed number.
  *
- * The numerator is an integer and the denominator a natural number, which must
- * not be 0.
+ * @param u     The viewed number.
+ * @param base  The base, which must be from 2 to 36.
+ * @return      Returns the upper bound or 0 if the base is invalid.
  *
- * This class maintains the invariant that the greatest common divisor of
- * numerator and denominator is always 1. This requires a reduction step after
- * most operations. As the reduction costs O(n^2), the costs of those operations
- * is at least O(n^2).
+ * @par  Runtime complexity
+ *       O(1)
+ */
+std::size_t maxChars(UnsignedView u, unsigned base = 10);
+
+/**
+ * Writes the digits of a viewed number to a character range.
+ *
+ * Behaves like the overload for bn::Unsigned. The digits are copied once as
+ * the conversion modifies a working copy of the number.
+ *
+ * @param first  The beginning of the range.
+ * @param last   The end of the range.
+ * @param u      The viewed number.
+ * @param base   The base, which must be from 2 to 36.
+ * @return       See the overload for bn::Unsigned.
+ *
+ * @par  Runtime complexity
+ *       O(n) if base is a power of two, O(n^2) otherwise
+ */
+ToCharsResult
+    to_chars(char* first, char* last, UnsignedView u, unsigned base = 10);
+
+/*******************************************************************************
+ * A column of natural numbers stored contiguously.
+ *
+ * The digits of all numbers are stored in a single array and an array of
+ * offsets marks where each number starts, so a column of many numbers needs
+ * two allocations instead of one object plus a separate buffer per number.
+ * Elements are accessed as bn::UnsignedView.
+ *
+ * Columns can be saved to a file and loaded again. If BN_WITH_MMAP is defined
+ * on a POSIX system, the file is memory-mapped, so loading is O(1) apart from
+ * validating the offsets and the elements refer directly to the mapped file.
+ * A loaded column is read-only while it is mapped. Otherwise the file is read
+ * into memory. BN_WITH_MMAP is opt-in because the POSIX headers it includes
+ * declare functions such as read and close in the global namespace.
+ *
+ * The file format stores digits in the native byte order and digit size, so
+ * files can only be loaded by programs using the same bn::impl::digit_t on
+ * platforms with the same byte order.
  ******************************************************************************/
-class Rational
+class UnsignedColumn final
 {
 public:
     /**
-     * Constructor.
+     * Default constructor.
      *
-     * Initializes the value to 0.
+     * Creates an empty column.
      *
      * @par  Runtime complexity
      *       O(1)
      */
-    Rational() noexcept;
+    UnsignedColumn();
+
+    UnsignedColumn(const UnsignedColumn& other) = delete;
 
     /**
-     * Constructor.
+     * Move constructor.
      *
-     * The rational number will be automically reduced.
+     * @param other  The column to move.
      *
-     * @param num  The numerator.
-     * @param den  The denominator.
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    UnsignedColumn(UnsignedColumn&& other) noexcept;
+
+    /**
+     * Destructor.
      *
-     * @exception std::invalid_argument  Thrown if the denominator is 0.
+     * Unmaps the file of a mapped column.
+     */
+    ~UnsignedColumn();
+
+    UnsignedColumn& operator=(const UnsignedColumn& other) = delete;
+
+    /**
+     * Move assignment.
+     *
+     * @param other  The column to move.
+     * @return       Returns a reference to this column.
      *
      * @par  Runtime complexity
-     *       O(n^2)
+     *       O(1)
      */
-    Rational(const Signed& num, const Unsigned& den);
+    UnsignedColumn& operator=(UnsignedColumn&& other) noexcept;
 
     /**
-     * Constructor.
+     * Loads a column from a file written by save().
      *
-     * The rational number will be automically reduced.
+     * @param path  The path of the file.
+     * @param map   Whether to memory-map the file. Ignored if memory mapping
+     *              is not available, in which case the file is read.
+     * @return      Returns the loaded column.
      *
-     * @param num  The numerator.
-     * @param den  The denominator.
+     * @exception std::runtime_error  Thrown if the file cannot be read or is
+     *                                not a valid column file for this digit
+     *                                type and platform.
      *
-     * @exception std::invalid_argument  Thrown if the denominator is 0.
+     * @par  Runtime complexity
+     *       O(k) if the file is mapped, where k is the number of elements,
+     *       O(n) otherwise, where n is the total number of digits
+     */
+    static UnsignedColumn load(const std::string& path, bool map = true);
+
+public:
+    /**
+     * Returns the number of elements.
+     *
+     * @return  Returns the number of elements.
      *
      * @par  Runtime complexity
-     *       O(n^2)
+     *       O(1)
      */
-    Rational(Signed&& num, Unsigned&& den);
+    std::size_t size() const noexcept;
 
     /**
-     * Constructs a rational from a double-precision floating point number.
+     * Returns the total number of digits of all elements.
      *
-     * The rational will have exactly the same value as the floating point
-     * number.
+     * @return  Returns the total number of digits.
      *
-     * @param d  A double-precision floating point number.
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    std::size_t totalDigits() const noexcept;
+
+    /**
+     * Returns a view of an element.
      *
-     * @exception  std::invalid_argument  Thrown if the passed floating point
-     *                                    number is not finite.
+     * The view remains valid until the column is modified or destroyed.
+     *
+     * @param i  The index of the element, which must be less than size().
+     * @return   Returns a view of the element.
      *
      * @par  Runtime complexity
      *       O(1)
      */
-    Rational(double d);
+    UnsignedView operator[](std::size_t i) const noexcept;
 
     /**
-     * Constructor.
+     * Checks whether this column refers to a memory-mapped file.
      *
-     * @param v  The value this rational is initialized to.
+     * @return  Returns true if the column is mapped, false otherwise.
+     *
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    bool mapped() const noexcept;
+
+    /**
+     * Reserves memory for elements.
+     *
+     * @param count   The number of elements to reserve memory for.
+     * @param digits  The total number of digits to reserve memory for.
+     *
+     * @exception std::logic_error  Thrown if the column is mapped.
      *
      * @par  Runtime complexity
      *       O(n)
      */
-    Rational(const Unsigned& v);
+    void reserve(std::size_t count, std::size_t digits);
 
     /**
-     * Constructor.
+     * Appends a number to the column.
      *
-     * @param v  The value this rational is initialized to.
+     * @param u  The number to append.
+     *
+     * @exception std::logic_error  Thrown if the column is mapped.
      *
      * @par  Runtime complexity
-     *       O(1)
+     *       O(n) amortized
      */
-    Rational(Unsigned&& v);
+    void push_back(UnsignedView u);
 
     /**
-     * Constructor.
+     * Saves the column to a file.
      *
-     * @param v  The value this rational is initialized to.
+     * @param path  The path of the file, which is overwritten if it exists.
+     *
+     * @exception std::runtime_error  Thrown if the file cannot be written.
      *
      * @par  Runtime complexity
      *       O(n)
      */
-    Rational(const Signed& v);
+    void save(const std::string& path) const;
+
+private:
+    void checkWritable() const;
+    void updatePointers() noexcept;
+    void unmap() noexcept;
+
+private:
+    std::vector<std::uint64_t> offsetStore;
+    std::vector<impl::digit_t> digitStore;
+    const std::uint64_t* offsets;
+    const impl::digit_t* digitData;
+    std::size_t count;
+    void* mapping;
+    std::size_t mappingSize;
+};
 
+/*******************************************************************************
+ * An integer of arbitrary precision.
+ ******************************************************************************/
+class Signed
+{
+public:
     /**
-     * Constructor.
+     * Default constructor.
      *
-     * @param v  The value this rational is initialized to.
+     * Initializes the integer to 0.
      *
      * @par  Runtime complexity
      *       O(1)
      */
-    Rational(Signed&& v);
+    Signed() noexcept;
 
     /**
      * Copy constructor.
      *
-     * @param other  A rational number.
+     * @param other  The integer to copy.
      *
      * @par  Runtime complexity
      *       O(n)
      */
-    Rational(const Rational& other) = default;
+    Signed(const Signed& other);
 
     /**
      * Move constructor.
      *
-     * @param other  A rational number.
+     * @param other  The integer to move.
      *
      * @par  Runtime complexity
      *       O(1)
      */
-    Rational(Rational&& other) noexcept = default;
+    Signed(Signed&& other) noexcept;
 
     /**
-     * Copy assignment.
+     * Copy constructor from a natural number.
      *
-     * @param other  A rational number.
-     * @return       Returns a reference to this rational number.
+     * @param other  The natural number to copy.
      *
      * @par  Runtime complexity
      *       O(n)
      */
-    Rational& operator=(const Rational& other) = default;
+    Signed(const Unsigned& other);
 
     /**
-     * Move assignment.
+     * Move constructor from a natural number.
      *
-     * @param other  A rational number.
-     * @return       Returns a reference to this rational number.
+     * @param other  The natural number to move.
      *
      * @par  Runtime complexity
      *       O(1)
      */
-    Rational& operator=(Rational&& other) noexcept = default;
+    Signed(Unsigned&& other) noexcept;
 
-public:
     /**
-     * Returns the numerator.
+     * Constructs an integer from a signed 32-bit integer.
      *
-     * @return  Returns the numerator.
+     * @param i  The signed integer to construct the number from.
      *
      * @par  Runtime complexity
      *       O(1)
      */
-    const Signed& numerator() const;
+    Signed(std::int32_t i);
 
     /**
-     * Returns the denominator.
+     * Constructs an integer from an unsigned 32-bit integer.
      *
-     * @return  Returns the denominator.
+     * @param i  The unsigned integer to construct the number from.
      *
      * @par  Runtime complexity
      *       O(1)
      */
-    const Unsigned& denominator() const;
+    Signed(std::uint32_t i);
 
     /**
-     * Returns the reciprocal of this rational number.
-     *
-     * @return  Returns the reciprocal of this rational number.
+     * Constructs an integer from a signed 64-bit integer.
      *
-     * @exception std::logic_error  Thrown if the numerator is 0.
+     * @param i  The signed integer to construct the number from.
      *
      * @par  Runtime complexity
-     *       O(n)
+     *       O(1)
      */
-    Rational reciprocal() const;
+    Signed(std::int64_t i);
 
     /**
-     * Adds the passed rational number to this rational number.
+     * Constructs an integer from an unsigned 64-bit integer.
      *
-     * @param v  The rational number to add.
-     * @return   Returns a reference to this rational number.
+     * @param i  The unsigned integer to construct the number from.
      *
      * @par  Runtime complexity
-     *       O(n^2)
+     *       O(1)
      */
-    Rational& operator+=(const Rational& v);
+    Signed(std::uint64_t i);
 
     /**
-     * Substracts the passed rational number to this rational number.
+     * Constructs an integer from a null-terminated string.
      *
-     * @param v  The rational number to subtract.
-     * @return   Returns a reference to this rational number.
+     * @param dec  The null-terminated string to construct the integer from.
+     *
+     * @exception std::invalid_argument  Thrown if the string is empty or does
+     *                                   not match the regular expression
+     *                                   -?[0-9]+.
      *
      * @par  Runtime complexity
      *       O(n^2)
      */
-    Rational& operator-=(const Rational& v);
+    Signed(const char* dec);
 
     /**
-     * Multiplies this rational number with the passed rational number.
+     * Copy assignment.
      *
-     * @param v  The rational number to multiply with.
-     * @return   Returns a reference to this rational number.
+     * @param other  The integer to assign.
+     * @return       Returns a reference to this integer.
      *
      * @par  Runtime complexity
-     *       O(n^2)
+     *       O(n)
      */
-    Rational& operator*=(const Rational& v);
+    Signed& operator=(const Signed& other);
 
     /**
-     * Divides this rational number by the passed rational number.
+     * Move assignment.
      *
-     * @param v  The rational number to divide by. Will throw an
-     *           std::invalid_argument exception if the rational number is 0.
-     * @return   Returns a reference to this rational number.
+     * @param other  The integer to assign.
+     * @return       Returns a reference to this integer.
      *
      * @par  Runtime complexity
-     *       O(n^2)
+     *       O(1)
      */
-    Rational& operator/=(const Rational& v);
+    Signed& operator=(Signed&& other) noexcept;
 
+public:
     /**
-     * Converts this rational number to the closest double-precision floating
-     * point number.
+     * Returns the sign of this integer.
      *
-     * The convertion will use the round to nearest rounding mode. Ties will be
-     * rounded to the nearest even digit.
+     * @return  Returns -1 if the integer is negative, 1 if the integer is
+     *          positive and 0 if the integer is 0.
      *
-     * If this rational number is too huge to be converted to double-precision
-     * floating point number, infinity is returned.
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    int sgn() const;
+
+    /**
+     * Returns the absolute value of this integer as natural number.
      *
-     * @return  Returns the closest double-precision floating point number of
-     *          this rational number.
+     * @return  Return the absolute value of this integer.
      *
      * @par  Runtime complexity
      *       O(1)
      */
-    explicit operator double() const;
+    const Unsigned& abs() const;
 
     /**
-     * Returns a string representation of this rational number to base 10 in
-     * format numerator "/" denominator.
+     * Pre-increment operator.
      *
-     * @return  Returns a string representation of this rational number to base
-     * 10 in format numerator "/" denominator.
+     * Increases this integer by 1.
+     *
+     * @return  Returns a reference to this integer.
      *
      * @par  Runtime complexity
-     *       O(n^2)
+     *       O(n)
      */
-    std::string str() const;
-
-private:
-    void reduce();
-
-private:
-    friend bool operator==(const Rational& u, const Rational& v);
-    friend bool operator!=(const Rational& u, const Rational& v);
-    friend bool operator<(const Rational& u, const Rational& v);
-    friend bool operator>=(const Rational& u, const Rational& v);
-    friend bool operator>(const Rational& u, const Rational& v);
-    friend bool operator<=(const Rational& u, const Rational& v);
+    Signed& operator++();
 
-    friend Rational operator-(const Rational& u);
+    /**
+     * Post-increment operator.
+     *
+     * Increases this integer by 1.
+     *
+     * @return  Returns the value of the integer before increasing.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    Signed operator++(int);
 
-    friend Rational operator+(const Rational& u, const Rational& v);
-    friend Rational operator-(const Rational& u, const Rational& v);
-    friend Rational operator*(const Rational& u, const Rational& v);
+    /**
+     * Pre-decrement operator.
+     *
+     * Decreases this integer by 1.
+     *
+     * @return  Returns a reference to this integer.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    Signed& operator--();
+
+    /**
+     * Post-decrement operator.
+     *
+     * Decreases this integer by 1.
+     *
+     * @return  Returns the value of the integer before decreasing.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    Signed operator--(int);
+
+    /**
+     * Adds the passed integer to this integer.
+     *
+     * @param v  The integer to add.
+     * @return   Returns a reference to this integer.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    Signed& operator+=(const Signed& v);
+
+    /**
+     * Substracts the passed integer to this integer.
+     *
+     * @param v  The integer to subtract.
+     * @return   Returns a reference to this integer.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    Signed& operator-=(const Signed& v);
+
+    /**
+     * Multiplies this integer with the passed integer.
+     *
+     * @param v  The integer to multiply with.
+     * @return   Returns a reference to this integer.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    Signed& operator*=(const Signed& v);
+
+    /**
+     * Divides this integer by the passed integer.
+     *
+     * @param v  The integer to divide by.
+     * @return   Returns a reference to this integer.
+     *
+     * @exception std::invalid_argument  Thrown if v is 0.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    Signed& operator/=(const Signed& v);
+
+    /**
+     * Computes the remainder when dividing this integer by the passed integer.
+     *
+     * @param v  The integer to divide by.
+     * @return   Returns a reference to this integer.
+     *
+     * @exception std::invalid_argument  Thrown if v is 0.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    Signed& operator%=(const Signed& v);
+
+    /**
+     * Adds a built-in integer to this integer.
+     *
+     * The integer is not converted to a number first if it fits into a digit.
+     *
+     * @tparam T  A built-in integer type of at most 64 bits.
+     * @param v   The integer.
+     * @return    Returns a reference to this integer.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    template<typename T>
+    impl::IfNative<T, Signed&> operator+=(T v);
+
+    /**
+     * Subtracts a built-in integer from this integer.
+     *
+     * The integer is not converted to a number first if it fits into a digit.
+     *
+     * @tparam T  A built-in integer type of at most 64 bits.
+     * @param v   The integer.
+     * @return    Returns a reference to this integer.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    template<typename T>
+    impl::IfNative<T, Signed&> operator-=(T v);
+
+    /**
+     * Multiplies this integer with a built-in integer.
+     *
+     * The integer is not converted to a number first if it fits into a digit.
+     *
+     * @tparam T  A built-in integer type of at most 64 bits.
+     * @param v   The integer.
+     * @return    Returns a reference to this integer.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    template<typename T>
+    impl::IfNative<T, Signed&> operator*=(T v);
+
+    /**
+     * Divides this integer by a built-in integer.
+     *
+     * The integer is not converted to a number first if it fits into a digit.
+     *
+     * @tparam T  A built-in integer type of at most 64 bits.
+     * @param v   The integer.
+     * @return    Returns a reference to this integer.
+     *
+     * @exception std::invalid_argument  Thrown if v is 0.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    template<typename T>
+    impl::IfNative<T, Signed&> operator/=(T v);
+
+    /**
+     * Computes the remainder when dividing this integer by a built-in integer.
+     *
+     * The remainder has the same sign as this integer.
+     *
+     * @tparam T  A built-in integer type of at most 64 bits.
+     * @param v   The integer.
+     * @return    Returns a reference to this integer.
+     *
+     * @exception std::invalid_argument  Thrown if v is 0.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    template<typename T>
+    impl::IfNative<T, Signed&> operator%=(T v);
+
+    /**
+     * Divides this integer by the passed integer and returns the remainder of
+     * the division.
+     *
+     * @param v  The integer to divide by.
+     * @return   Returns the integer of the division.
+     *
+     * @exception std::invalid_argument  Thrown if v is 0.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    Signed div(const Signed& v);
+
+    /**
+     * Parses an integer from a string.
+     *
+     * The string may start with a minus sign. Letters represent the digits from
+     * 10 to 35 and may be upper or lower case.
+     *
+     * @param s     The string to parse.
+     * @param base  The base of the string, which must be from 2 to 36.
+     * @return      Returns the parsed integer.
+     *
+     * @exception std::invalid_argument  Thrown if the base is invalid, if the
+     *                                   string has no digits or if it contains
+     *                                   a character that is not a digit in the
+     *                                   base.
+     *
+     * @par  Runtime complexity
+     *       O(n) if base is a power of two, O(n^2) otherwise
+     */
+    static Signed fromString(const std::string& s, unsigned base);
+
+    /**
+     * Returns the string representation of this integer in base 10.
+     *
+     * @return  Returns the string representation of this integer in base 10.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    std::string str() const;
+
+    /**
+     * Returns the string representation of this integer in the given base.
+     *
+     * @param base       The base, which must be from 2 to 36.
+     * @param uppercase  Whether to use upper case letters for the digits from
+     *                   10 to 35.
+     * @return           Returns the string representation of this integer.
+     *
+     * @exception std::invalid_argument  Thrown if the base is invalid.
+     *
+     * @par  Runtime complexity
+     *       O(n) if base is a power of two, O(n^2) otherwise
+     */
+    std::string str(unsigned base, bool uppercase = false) const;
+
+public:
+    struct QR;
+
+private:
+    friend bool operator==(const Signed& u, const Signed& v);
+    friend bool operator!=(const Signed& u, const Signed& v);
+    friend bool operator<(const Signed& u, const Signed& v);
+    friend bool operator>=(const Signed& u, const Signed& v);
+    friend bool operator>(const Signed& u, const Signed& v);
+    friend bool operator<=(const Signed& u, const Signed& v);
+
+    friend Signed operator-(const Signed& u);
+
+    friend Signed operator+(const Signed& u, const Signed& v);
+    friend Signed operator-(const Signed& u, const Signed& v);
+    friend Signed operator*(const Signed& u, const Signed& v);
+    friend Signed operator/(const Signed& u, const Signed& v);
+    friend Signed operator%(const Signed& u, const Signed& v);
+
+    friend QR div(const Signed& u, const Signed& v);
+    friend Signed divexact(const Signed& u, const Signed& d);
+    friend bool isDivisible(const Signed& u, const Signed& d);
+    friend bool isDivisibleBy2Exp(const Signed& u, std::size_t b);
+
+    friend std::ostream& operator<<(std::ostream& out, const Signed& s);
+
+    friend class Rational;
     friend Rational operator/(const Rational& u, const Rational& v);
 
-    friend std::ostream& operator<<(std::ostream& out, const Rational& u);
+private:
+    void addNative(std::uint64_t m, int s);
 
 private:
-    Signed num;
-    Unsigned den;
+    Unsigned val;
+    int8_t sign;
+};
+
+/*******************************************************************************
+ * Result of an integer division.
+ ******************************************************************************/
+struct Signed::QR
+{
+    /// The quotient.
+    Signed quot;
+    /// The remainder. The remainder will have the same sign as the divident.
+    Signed rem;
 };
 
 /**
  * Equal comparison.
  *
- * @param u  First rational number.
- * @param v  Second rational number.
- * @return   Returns true if the rational numbers are equal, false otherwise.
+ * @param u  First integer.
+ * @param v  Second integer.
+ * @return   Returns true if the integers are equal, false otherwise.
  *
  * @par  Runtime complexity
  *       O(n)
  */
-bool operator==(const Rational& u, const Rational& v);
+bool operator==(const Signed& u, const Signed& v);
 
 /**
  * Inequal comparison.
  *
- * @param u  First rational number.
- * @param v  Second rational number.
- * @return   Returns true if the rational number are not equal, false otherwise.
+ * @param u  First integer.
+ * @param v  Second integer.
+ * @return   Returns true if the integer are not equal, false otherwise.
  *
  * @par  Runtime complexity
  *       O(n)
  */
-bool operator!=(const Rational& u, const Rational& v);
+bool operator!=(const Signed& u, const Signed& v);
 
 /**
  * Less than comparison.
  *
- * @param u  First rational number.
- * @param v  Second rational number.
- * @return   Returns true if the first rational number is less than the second
- *           rational number, false otherwise.
+ * @param u  First integer.
+ * @param v  Second integer.
+ * @return   Returns true if the first integer is less than the second integer,
+ *           false otherwise.
  *
  * @par  Runtime complexity
- *       O(n^2)
+ *       O(n)
  */
-bool operator<(const Rational& u, const Rational& v);
+bool operator<(const Signed& u, const Signed& v);
 
 /**
  * Greater than or equal comparison.
  *
- * @param u  First rational number.
- * @param v  Second rational number.
- * @return   Returns true if the first rational number is greater than or equal
- *           to the second rational number, false otherwise.
+ * @param u  First integer.
+ * @param v  Second integer.
+ * @return   Returns true if the first integer is greater than or equal to the
+ *           second integer, false otherwise.
  *
  * @par  Runtime complexity
- *       O(n^2)
+ *       O(n)
  */
-bool operator>=(const Rational& u, const Rational& v);
+bool operator>=(const Signed& u, const Signed& v);
 
 /**
  * Greater than comparison.
  *
- * @param u  First rational number.
- * @param v  Second rational number.
- * @return   Returns true if the first rational number is greater than the
- *           second rational number, false otherwise.
+ * @param u  First integer.
+ * @param v  Second integer.
+ * @return   Returns true if the first integer is greater than the second
+ *           integer, false otherwise.
  *
  * @par  Runtime complexity
- *       O(n^2)
+ *       O(n)
  */
-bool operator>(const Rational& u, const Rational& v);
+bool operator>(const Signed& u, const Signed& v);
 
 /**
  * Less than or equal comparison.
  *
- * @param u  First rational number.
- * @param v  Second rational number.
- * @return   Returns true if the first rational number is less than or equal to
- *           the second rational number, false otherwise.
+ * @param u  First integer.
+ * @param v  Second integer.
+ * @return   Returns true if the first integer is less than or equal to the
+ *           second integer, false otherwise.
  *
  * @par  Runtime complexity
- *       O(n^2)
+ *       O(n)
  */
-bool operator<=(const Rational& u, const Rational& v);
+bool operator<=(const Signed& u, const Signed& v);
 
 /**
- * Negates a rational number.
+ * Negates an integer.
  *
- * @param u  The rational number to negate.
- * @return   The negated rational number.
+ * @param u  The integer to negate.
+ * @return   The negated integer.
  *
  * @par  Runtime complexity
  *       O(n)
  */
-Rational operator-(const Rational& u);
+Signed operator-(const Signed& u);
 
 /**
- * Adds two rational numbers.
+ * Adds two integers.
  *
  * @param u  First summand.
  * @param v  Second summand.
  * @return   Returns the sum.
  *
  * @par  Runtime complexity
- *       O(n^2)
+ *       O(n)
  */
-Rational operator+(const Rational& u, const Rational& v);
+Signed operator+(const Signed& u, const Signed& v);
 
 /**
- * Subtracts a rational number from a rational number.
+ * Subtracts an integer from an integer.
  *
  * @param u  Minuend.
  * @param v  Subtrahend.
  * @return   Returns the difference.
  *
  * @par  Runtime complexity
- *       O(n^2)
+ *       O(n)
  */
-Rational operator-(const Rational& u, const Rational& v);
+Signed operator-(const Signed& u, const Signed& v);
 
 /**
- * Multiplies two rational numbers with each other.
+ * Multiplies two integers with each other.
  *
  * @param u  First factor.
  * @param v  Second factor.
@@ -1951,1961 +3577,9857 @@ Rational operator-(const Rational& u, const Rational& v);
  * @par  Runtime complexity
  *       O(n^2)
  */
-Rational operator*(const Rational& u, const Rational& v);
+Signed operator*(const Signed& u, const Signed& v);
 
 /**
- * Divides a rational number by another.
+ * Divides an integer by another.
  *
  * @param u  Divident.
- * @param v  Divisor. if the divisor is 0, a std::invalid_argument execption is
- *           thrown.
+ * @param v  Divisor.
  * @return   Returns the quotient.
  *
+ * @exception std::invalid_argument  Thrown if the divisor is 0.
+ *
  * @par  Runtime complexity
  *       O(n^2)
  */
-Rational operator/(const Rational& u, const Rational& v);
+Signed operator/(const Signed& u, const Signed& v);
 
 /**
- * Writes a rational number in base 10 to an output stream.
+ * Computes the remainder of a division.
  *
- * The format of the number ist numerator "/" denominator.
+ * @param u  Divident.
+ * @param v  Divisor. if the divisor is 0.
+ * @return   Returns the remainder.
  *
- * @param out  An output stream.
- * @param u    A rational number.
- * @return     Returns the output stream.
+ * @exception std::invalid_argument  Thrown if the divisor is 0.
  *
  * @par  Runtime complexity
  *       O(n^2)
  */
-std::ostream& operator<<(std::ostream& out, const Rational& u);
+Signed operator%(const Signed& u, const Signed& v);
 
-//------------------------------------------------------------------------------
-namespace impl {
-//------------------------------------------------------------------------------
-inline Store::Store() noexcept : mem(smem), cap(smemsize), sz(0)
-{
-}
-//------------------------------------------------------------------------------
-inline Store::Store(const Store& other)
-{
-    if (other.sz <= smemsize) {
-        memcpy(smem, other.mem, other.sz * sizeof(impl::digit_t));
-        mem = smem;
-        cap = smemsize;
-        sz = other.sz;
-    } else {
-        mem = alloc_digits(other.sz);
-        memcpy(mem, other.mem, other.sz * sizeof(impl::digit_t));
-        cap = other.sz;
-        sz = other.sz;
-    }
-}
-//------------------------------------------------------------------------------
-inline Store::Store(Store&& other) noexcept
-{
-    if (other.cap == smemsize) {
-        memcpy(smem, other.smem, other.sz * sizeof(impl::digit_t));
-        mem = smem;
-        cap = other.cap;
-        sz = other.sz;
-    } else {
-        mem = other.mem;
-        cap = other.cap;
-        sz = other.sz;
-        other.mem = other.smem;
-        other.cap = smemsize;
-        other.sz = 0;
-    }
-}
-//------------------------------------------------------------------------------
-inline Store::~Store()
-{
-    if (cap != smemsize) {
-        deallocate(mem);
-    }
-}
-//------------------------------------------------------------------------------
-inline Store& Store::operator=(const Store& other)
-{
-    if (other.sz <= smemsize) {
-        if (cap >= (2 * smemsize)) {
-            deallocate(mem);
-            mem = smem;
-            cap = smemsize;
-        }
-    } else if (other.sz <= cap) {
-        if (cap >= (2 * other.sz)) {
-            impl::digit_t* temp = alloc_digits(other.sz);
-            deallocate(mem);
-            mem = temp;
-            cap = other.sz;
-        }
-    } else {
-        impl::digit_t* temp = alloc_digits(other.sz);
-        if (cap != smemsize) {
-            deallocate(mem);
-        }
-        mem = temp;
-    }
-    memcpy(mem, other.mem, other.sz * sizeof(impl::digit_t));
-    sz = other.sz;
-    return *this;
-}
-//------------------------------------------------------------------------------
-inline Store& Store::operator=(Store&& other) noexcept
-{
-    if (other.cap == smemsize) {
-        memcpy(smem, other.smem, other.sz * sizeof(impl::digit_t));
-        if (cap == smemsize) {
-            sz = other.sz;
-        } else {
-            other.mem = mem;
-            mem = smem;
-            other.cap = cap;
-            cap = smemsize;
-            std::swap(sz, other.sz);
-        }
-    } else {
-        if (cap == smemsize) {
-            memcpy(other.smem, smem, sz * sizeof(impl::digit_t));
-            mem = other.mem;
-            other.mem = other.smem;
-            cap = other.cap;
-            other.cap = smemsize;
-            std::swap(sz, other.sz);
-        } else {
-            std::swap(mem, other.mem);
-            std::swap(cap, other.cap);
-            std::swap(sz, other.sz);
-        }
-    }
+/**
+ * Adds a integer and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The integer.
+ * @param v   The integer.
+ * @return    Returns the sum.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Signed> operator+(const Signed& u, T v);
+
+/**
+ * Adds a integer and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The integer.
+ * @return    Returns the sum.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Signed> operator+(T v, const Signed& u);
+
+/**
+ * Subtracts a built-in integer from a integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The integer.
+ * @param v   The integer.
+ * @return    Returns the difference.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Signed> operator-(const Signed& u, T v);
+
+/**
+ * Subtracts a integer from a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The integer.
+ * @return    Returns the difference.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Signed> operator-(T v, const Signed& u);
+
+/**
+ * Multiplies a integer with a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The integer.
+ * @param v   The integer.
+ * @return    Returns the product.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Signed> operator*(const Signed& u, T v);
+
+/**
+ * Multiplies a integer with a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The integer.
+ * @return    Returns the product.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Signed> operator*(T v, const Signed& u);
+
+/**
+ * Divides a integer by a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The integer.
+ * @param v   The integer.
+ * @return    Returns the quotient.
+ *
+ * @exception std::invalid_argument  Thrown if the divisor is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Signed> operator/(const Signed& u, T v);
+
+/**
+ * Divides a built-in integer by a integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The integer.
+ * @return    Returns the quotient.
+ *
+ * @exception std::invalid_argument  Thrown if the divisor is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Signed> operator/(T v, const Signed& u);
+
+/**
+ * Computes the remainder of dividing a integer by a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The integer.
+ * @param v   The integer.
+ * @return    Returns the remainder.
+ *
+ * @exception std::invalid_argument  Thrown if the divisor is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Signed> operator%(const Signed& u, T v);
+
+/**
+ * Computes the remainder of dividing a built-in integer by a integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The integer.
+ * @return    Returns the remainder.
+ *
+ * @exception std::invalid_argument  Thrown if the divisor is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Signed> operator%(T v, const Signed& u);
+
+/**
+ * Equal comparison of a integer and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The integer.
+ * @param v   The integer.
+ * @return    Returns true if both are equal, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator==(const Signed& u, T v);
+
+/**
+ * Equal comparison of a integer and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The integer.
+ * @return    Returns true if both are equal, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator==(T v, const Signed& u);
+
+/**
+ * Inequal comparison of a integer and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The integer.
+ * @param v   The integer.
+ * @return    Returns true if both are not equal, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator!=(const Signed& u, T v);
+
+/**
+ * Inequal comparison of a integer and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The integer.
+ * @return    Returns true if both are not equal, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator!=(T v, const Signed& u);
+
+/**
+ * Less than comparison of a integer and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The integer.
+ * @param v   The integer.
+ * @return    Returns true if the first operand is less than the second
+ *            operand, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator<(const Signed& u, T v);
+
+/**
+ * Less than comparison of a integer and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The integer.
+ * @return    Returns true if the first operand is less than the second
+ *            operand, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator<(T v, const Signed& u);
+
+/**
+ * Greater than or equal comparison of a integer and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The integer.
+ * @param v   The integer.
+ * @return    Returns true if the first operand is greater than or equal to the
+ *            second operand, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator>=(const Signed& u, T v);
+
+/**
+ * Greater than or equal comparison of a integer and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The integer.
+ * @return    Returns true if the first operand is greater than or equal to the
+ *            second operand, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator>=(T v, const Signed& u);
+
+/**
+ * Greater than comparison of a integer and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The integer.
+ * @param v   The integer.
+ * @return    Returns true if the first operand is greater than the second
+ *            operand, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator>(const Signed& u, T v);
+
+/**
+ * Greater than comparison of a integer and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The integer.
+ * @return    Returns true if the first operand is greater than the second
+ *            operand, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator>(T v, const Signed& u);
+
+/**
+ * Less than or equal comparison of a integer and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The integer.
+ * @param v   The integer.
+ * @return    Returns true if the first operand is less than or equal to the
+ *            second operand, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator<=(const Signed& u, T v);
+
+/**
+ * Less than or equal comparison of a integer and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The integer.
+ * @return    Returns true if the first operand is less than or equal to the
+ *            second operand, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator<=(T v, const Signed& u);
+
+/**
+ * Divides an integer by another.
+ *
+ * @param u  Divident.
+ * @param v  Divisor.
+ * @return   Returns the quotient and remainder.
+ *
+ * @exception std::invalid_argument  Thrown if the divisor is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+Signed::QR div(const Signed& u, const Signed& v);
+
+/**
+ * Divides an integer by one of its divisors.
+ *
+ * @param u  Divident. Must be a multiple of d.
+ * @param d  Divisor.
+ * @return   Returns u / d. The result is unspecified if d does not divide u.
+ *
+ * @exception std::invalid_argument  Thrown if the divisor is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n*m)
+ *
+ * @see bn::divexact(const Unsigned&, const Unsigned&)
+ */
+Signed divexact(const Signed& u, const Signed& d);
+
+/**
+ * Checks whether an integer is divisible by another.
+ *
+ * @param u  An integer.
+ * @param d  The divisor. Only 0 is divisible by 0.
+ * @return   Returns true if d divides u.
+ *
+ * @par  Runtime complexity
+ *       O(n*m)
+ *
+ * @see bn::isDivisible(const Unsigned&, const Unsigned&)
+ */
+bool isDivisible(const Signed& u, const Signed& d);
+
+/**
+ * Checks whether an integer is divisible by a power of two.
+ *
+ * @param u  An integer.
+ * @param b  The exponent of the power of two.
+ * @return   Returns true if the lowest b bits of the absolute value are 0.
+ *
+ * @par  Runtime complexity
+ *       O(b)
+ */
+bool isDivisibleBy2Exp(const Signed& u, std::size_t b);
+
+/**
+ * Checks whether two integers are congruent modulo a third.
+ *
+ * @param u  An integer.
+ * @param c  Another integer.
+ * @param d  The modulus. Integers are congruent modulo 0 if they are equal.
+ * @return   Returns true if d divides u - c.
+ *
+ * @par  Runtime complexity
+ *       O(n*m)
+ */
+bool isCongruent(const Signed& u, const Signed& c, const Signed& d);
+
+/**
+ * Writes an integer to an output stream.
+ *
+ * The integer is written in base 16 or 8 if std::hex or std::oct is set on the
+ * stream. std::showbase and std::uppercase are honored as well.
+ *
+ * @param out  An output stream.
+ * @param s    An integer.
+ * @return     Returns the output stream.
+ *
+ * @par  Runtime complexity
+ *       O(n) for base 16 and 8, O(n^2) for base 10
+ */
+std::ostream& operator<<(std::ostream& out, const Signed& s);
+
+/**
+ * Returns an upper bound of the number of characters written by
+ * bn::to_chars.
+ *
+ * @param s     The integer.
+ * @param base  The base, which must be from 2 to 36.
+ * @return      Returns the upper bound including the minus sign.
+ *
+ * @par  Runtime complexity
+ *       O(1)
+ */
+std::size_t maxChars(const Signed& s, unsigned base = 10);
+
+/**
+ * Writes the digits of an integer to a character range.
+ *
+ * A minus sign is written for negative integers. Apart from that, this
+ * function behaves like the overload for bn::Unsigned.
+ *
+ * @param first  The beginning of the range.
+ * @param last   The end of the range.
+ * @param s      The integer.
+ * @param base   The base, which must be from 2 to 36.
+ * @return       On success, returns the end of the written characters and a
+ *               value-initialized error code. Returns last and
+ *               std::errc::value_too_large if the range is too small and
+ *               std::errc::invalid_argument if the base is invalid.
+ *
+ * @par  Runtime complexity
+ *       O(n) if base is a power of two, O(n^2) otherwise
+ */
+ToCharsResult
+    to_chars(char* first, char* last, const Signed& s, unsigned base = 10);
+
+/**
+ * Parses an integer from a character range.
+ *
+ * The digits may be preceded by a minus sign. Apart from that, this function
+ * behaves like the overload for bn::Unsigned.
+ *
+ * @param first  The beginning of the range.
+ * @param last   The end of the range.
+ * @param s      Receives the integer on success. Left unchanged on failure.
+ * @param base   The base, which must be from 2 to 36.
+ * @return       On success, returns a pointer to the first character that was
+ *               not consumed and a value-initialized error code. Returns first
+ *               and std::errc::invalid_argument if the range does not start
+ *               with a number or if the base is invalid.
+ *
+ * @par  Runtime complexity
+ *       O(n) if base is a power of two, O(n^2) otherwise
+ */
+FromCharsResult from_chars(
+    const char* first,
+    const char* last,
+    Signed& s,
+    unsigned base = 10);
+
+/*******************************************************************************
+ * A rational number.
+ *
+ * The numerator is an integer and the denominator a natural number, which must
+ * not be 0.
+ *
+ * This class maintains the invariant that the greatest common divisor of
+ * numerator and denominator is always 1. This requires a reduction step after
+ * most operations. As the reduction costs O(n^2), the costs of those operations
+ * is at least O(n^2).
+ ******************************************************************************/
+class Rational
+{
+public:
+    /**
+     * Constructor.
+     *
+     * Initializes the value to 0.
+     *
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    Rational() noexcept;
+
+    /**
+     * Constructor.
+     *
+     * The rational number will be automically reduced.
+     *
+     * @param num  The numerator.
+     * @param den  The denominator.
+     *
+     * @exception std::invalid_argument  Thrown if the denominator is 0.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    Rational(const Signed& num, const Unsigned& den);
+
+    /**
+     * Constructor.
+     *
+     * The rational number will be automically reduced.
+     *
+     * @param num  The numerator.
+     * @param den  The denominator.
+     *
+     * @exception std::invalid_argument  Thrown if the denominator is 0.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    Rational(Signed&& num, Unsigned&& den);
+
+    /**
+     * Constructs a rational from a double-precision floating point number.
+     *
+     * The rational will have exactly the same value as the floating point
+     * number.
+     *
+     * @param d  A double-precision floating point number.
+     *
+     * @exception  std::invalid_argument  Thrown if the passed floating point
+     *                                    number is not finite.
+     *
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    Rational(double d);
+
+    /**
+     * Constructor.
+     *
+     * @param v  The value this rational is initialized to.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    Rational(const Unsigned& v);
+
+    /**
+     * Constructor.
+     *
+     * @param v  The value this rational is initialized to.
+     *
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    Rational(Unsigned&& v);
+
+    /**
+     * Constructor.
+     *
+     * @param v  The value this rational is initialized to.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    Rational(const Signed& v);
+
+    /**
+     * Constructor.
+     *
+     * @param v  The value this rational is initialized to.
+     *
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    Rational(Signed&& v);
+
+    /**
+     * Copy constructor.
+     *
+     * @param other  A rational number.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    Rational(const Rational& other) = default;
+
+    /**
+     * Move constructor.
+     *
+     * @param other  A rational number.
+     *
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    Rational(Rational&& other) noexcept = default;
+
+    /**
+     * Copy assignment.
+     *
+     * @param other  A rational number.
+     * @return       Returns a reference to this rational number.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    Rational& operator=(const Rational& other) = default;
+
+    /**
+     * Move assignment.
+     *
+     * @param other  A rational number.
+     * @return       Returns a reference to this rational number.
+     *
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    Rational& operator=(Rational&& other) noexcept = default;
+
+public:
+    /**
+     * Returns the numerator.
+     *
+     * @return  Returns the numerator.
+     *
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    const Signed& numerator() const;
+
+    /**
+     * Returns the denominator.
+     *
+     * @return  Returns the denominator.
+     *
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    const Unsigned& denominator() const;
+
+    /**
+     * Returns the reciprocal of this rational number.
+     *
+     * @return  Returns the reciprocal of this rational number.
+     *
+     * @exception std::logic_error  Thrown if the numerator is 0.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    Rational reciprocal() const;
+
+    /**
+     * Adds the passed rational number to this rational number.
+     *
+     * @param v  The rational number to add.
+     * @return   Returns a reference to this rational number.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    Rational& operator+=(const Rational& v);
+
+    /**
+     * Substracts the passed rational number to this rational number.
+     *
+     * @param v  The rational number to subtract.
+     * @return   Returns a reference to this rational number.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    Rational& operator-=(const Rational& v);
+
+    /**
+     * Multiplies this rational number with the passed rational number.
+     *
+     * @param v  The rational number to multiply with.
+     * @return   Returns a reference to this rational number.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    Rational& operator*=(const Rational& v);
+
+    /**
+     * Divides this rational number by the passed rational number.
+     *
+     * @param v  The rational number to divide by. Will throw an
+     *           std::invalid_argument exception if the rational number is 0.
+     * @return   Returns a reference to this rational number.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    Rational& operator/=(const Rational& v);
+
+    /**
+     * Adds a built-in integer to this rational number.
+     *
+     * The sum needs no reduction, so no greatest common divisor is computed.
+     *
+     * @tparam T  A built-in integer type of at most 64 bits.
+     * @param v   The integer.
+     * @return    Returns a reference to this rational number.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    template<typename T>
+    impl::IfNative<T, Rational&> operator+=(T v);
+
+    /**
+     * Subtracts a built-in integer from this rational number.
+     *
+     * The difference needs no reduction, so no greatest common divisor is
+     * computed.
+     *
+     * @tparam T  A built-in integer type of at most 64 bits.
+     * @param v   The integer.
+     * @return    Returns a reference to this rational number.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    template<typename T>
+    impl::IfNative<T, Rational&> operator-=(T v);
+
+    /**
+     * Multiplies this rational number with a built-in integer.
+     *
+     * Only the greatest common divisor of the denominator and the integer is
+     * computed to keep the number reduced.
+     *
+     * @tparam T  A built-in integer type of at most 64 bits.
+     * @param v   The integer.
+     * @return    Returns a reference to this rational number.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    template<typename T>
+    impl::IfNative<T, Rational&> operator*=(T v);
+
+    /**
+     * Divides this rational number by a built-in integer.
+     *
+     * Only the greatest common divisor of the numerator and the integer is
+     * computed to keep the number reduced.
+     *
+     * @tparam T  A built-in integer type of at most 64 bits.
+     * @param v   The integer.
+     * @return    Returns a reference to this rational number.
+     *
+     * @exception std::invalid_argument  Thrown if v is 0.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    template<typename T>
+    impl::IfNative<T, Rational&> operator/=(T v);
+
+    /**
+     * Converts this rational number to the closest double-precision floating
+     * point number.
+     *
+     * The convertion will use the round to nearest rounding mode. Ties will be
+     * rounded to the nearest even digit.
+     *
+     * If this rational number is too huge to be converted to double-precision
+     * floating point number, infinity is returned.
+     *
+     * @return  Returns the closest double-precision floating point number of
+     *          this rational number.
+     *
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    explicit operator double() const;
+
+    /**
+     * Returns a string representation of this rational number to base 10 in
+     * format numerator "/" denominator.
+     *
+     * @return  Returns a string representation of this rational number to base
+     * 10 in format numerator "/" denominator.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    std::string str() const;
+
+private:
+    void reduce();
+    void addNative(std::uint64_t m, int s);
+    void multiplyNative(std::uint64_t m, int s);
+    void divideNative(std::uint64_t m, int s);
+
+private:
+    friend bool operator==(const Rational& u, const Rational& v);
+    friend bool operator!=(const Rational& u, const Rational& v);
+    friend bool operator<(const Rational& u, const Rational& v);
+    friend bool operator>=(const Rational& u, const Rational& v);
+    friend bool operator>(const Rational& u, const Rational& v);
+    friend bool operator<=(const Rational& u, const Rational& v);
+
+    friend Rational operator-(const Rational& u);
+
+    friend Rational operator+(const Rational& u, const Rational& v);
+    friend Rational operator-(const Rational& u, const Rational& v);
+    friend Rational operator*(const Rational& u, const Rational& v);
+    friend Rational operator/(const Rational& u, const Rational& v);
+
+    friend std::ostream& operator<<(std::ostream& out, const Rational& u);
+
+    friend Rational
+        bestApproximation(const Rational& x, const Unsigned& maxDen);
+
+    template<typename Reader>
+    friend Rational impl::readRational(Reader& reader);
+
+private:
+    Signed num;
+    Unsigned den;
+};
+
+/**
+ * Equal comparison.
+ *
+ * @param u  First rational number.
+ * @param v  Second rational number.
+ * @return   Returns true if the rational numbers are equal, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+bool operator==(const Rational& u, const Rational& v);
+
+/**
+ * Inequal comparison.
+ *
+ * @param u  First rational number.
+ * @param v  Second rational number.
+ * @return   Returns true if the rational number are not equal, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+bool operator!=(const Rational& u, const Rational& v);
+
+/**
+ * Less than comparison.
+ *
+ * @param u  First rational number.
+ * @param v  Second rational number.
+ * @return   Returns true if the first rational number is less than the second
+ *           rational number, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+bool operator<(const Rational& u, const Rational& v);
+
+/**
+ * Greater than or equal comparison.
+ *
+ * @param u  First rational number.
+ * @param v  Second rational number.
+ * @return   Returns true if the first rational number is greater than or equal
+ *           to the second rational number, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+bool operator>=(const Rational& u, const Rational& v);
+
+/**
+ * Greater than comparison.
+ *
+ * @param u  First rational number.
+ * @param v  Second rational number.
+ * @return   Returns true if the first rational number is greater than the
+ *           second rational number, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+bool operator>(const Rational& u, const Rational& v);
+
+/**
+ * Less than or equal comparison.
+ *
+ * @param u  First rational number.
+ * @param v  Second rational number.
+ * @return   Returns true if the first rational number is less than or equal to
+ *           the second rational number, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+bool operator<=(const Rational& u, const Rational& v);
+
+/**
+ * Negates a rational number.
+ *
+ * @param u  The rational number to negate.
+ * @return   The negated rational number.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+Rational operator-(const Rational& u);
+
+/**
+ * Adds two rational numbers.
+ *
+ * @param u  First summand.
+ * @param v  Second summand.
+ * @return   Returns the sum.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+Rational operator+(const Rational& u, const Rational& v);
+
+/**
+ * Subtracts a rational number from a rational number.
+ *
+ * @param u  Minuend.
+ * @param v  Subtrahend.
+ * @return   Returns the difference.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+Rational operator-(const Rational& u, const Rational& v);
+
+/**
+ * Multiplies two rational numbers with each other.
+ *
+ * @param u  First factor.
+ * @param v  Second factor.
+ * @return   Returns the product.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+Rational operator*(const Rational& u, const Rational& v);
+
+/**
+ * Divides a rational number by another.
+ *
+ * @param u  Divident.
+ * @param v  Divisor. if the divisor is 0, a std::invalid_argument execption is
+ *           thrown.
+ * @return   Returns the quotient.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+Rational operator/(const Rational& u, const Rational& v);
+
+/**
+ * Adds a rational number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The rational number.
+ * @param v   The integer.
+ * @return    Returns the sum.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Rational> operator+(const Rational& u, T v);
+
+/**
+ * Adds a rational number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The rational number.
+ * @return    Returns the sum.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Rational> operator+(T v, const Rational& u);
+
+/**
+ * Subtracts a built-in integer from a rational number.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The rational number.
+ * @param v   The integer.
+ * @return    Returns the difference.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Rational> operator-(const Rational& u, T v);
+
+/**
+ * Subtracts a rational number from a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The rational number.
+ * @return    Returns the difference.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Rational> operator-(T v, const Rational& u);
+
+/**
+ * Multiplies a rational number with a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The rational number.
+ * @param v   The integer.
+ * @return    Returns the product.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Rational> operator*(const Rational& u, T v);
+
+/**
+ * Multiplies a rational number with a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The rational number.
+ * @return    Returns the product.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Rational> operator*(T v, const Rational& u);
+
+/**
+ * Divides a rational number by a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The rational number.
+ * @param v   The integer.
+ * @return    Returns the quotient.
+ *
+ * @exception std::invalid_argument  Thrown if the divisor is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, Rational> operator/(const Rational& u, T v);
+
+/**
+ * Divides a built-in integer by a rational number.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The rational number.
+ * @return    Returns the quotient.
+ *
+ * @exception std::invalid_argument  Thrown if the divisor is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+template<typename T>
+impl::IfNative<T, Rational> operator/(T v, const Rational& u);
+
+/**
+ * Equal comparison of a rational number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The rational number.
+ * @param v   The integer.
+ * @return    Returns true if both are equal, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator==(const Rational& u, T v);
+
+/**
+ * Equal comparison of a rational number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The rational number.
+ * @return    Returns true if both are equal, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator==(T v, const Rational& u);
+
+/**
+ * Inequal comparison of a rational number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The rational number.
+ * @param v   The integer.
+ * @return    Returns true if both are not equal, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator!=(const Rational& u, T v);
+
+/**
+ * Inequal comparison of a rational number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The rational number.
+ * @return    Returns true if both are not equal, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator!=(T v, const Rational& u);
+
+/**
+ * Less than comparison of a rational number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The rational number.
+ * @param v   The integer.
+ * @return    Returns true if the first operand is less than the second
+ *            operand, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator<(const Rational& u, T v);
+
+/**
+ * Less than comparison of a rational number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The rational number.
+ * @return    Returns true if the first operand is less than the second
+ *            operand, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator<(T v, const Rational& u);
+
+/**
+ * Greater than or equal comparison of a rational number and a built-in
+ * integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The rational number.
+ * @param v   The integer.
+ * @return    Returns true if the first operand is greater than or equal to the
+ *            second operand, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator>=(const Rational& u, T v);
+
+/**
+ * Greater than or equal comparison of a rational number and a built-in
+ * integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The rational number.
+ * @return    Returns true if the first operand is greater than or equal to the
+ *            second operand, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator>=(T v, const Rational& u);
+
+/**
+ * Greater than comparison of a rational number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The rational number.
+ * @param v   The integer.
+ * @return    Returns true if the first operand is greater than the second
+ *            operand, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator>(const Rational& u, T v);
+
+/**
+ * Greater than comparison of a rational number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The rational number.
+ * @return    Returns true if the first operand is greater than the second
+ *            operand, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator>(T v, const Rational& u);
+
+/**
+ * Less than or equal comparison of a rational number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param u   The rational number.
+ * @param v   The integer.
+ * @return    Returns true if the first operand is less than or equal to the
+ *            second operand, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator<=(const Rational& u, T v);
+
+/**
+ * Less than or equal comparison of a rational number and a built-in integer.
+ *
+ * @tparam T  A built-in integer type of at most 64 bits.
+ * @param v   The integer.
+ * @param u   The rational number.
+ * @return    Returns true if the first operand is less than or equal to the
+ *            second operand, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<typename T>
+impl::IfNative<T, bool> operator<=(T v, const Rational& u);
+
+/**
+ * Writes a rational number in base 10 to an output stream.
+ *
+ * The format of the number ist numerator "/" denominator.
+ *
+ * @param out  An output stream.
+ * @param u    A rational number.
+ * @return     Returns the output stream.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+std::ostream& operator<<(std::ostream& out, const Rational& u);
+
+/*******************************************************************************
+ * Binary serialization
+ *
+ * Numbers are serialized into a compact, versioned binary format:
+ *
+ *   - a tag byte holding the format version in the upper four bits and the
+ *     kind of number in the lower four bits (0: non-negative integer,
+ *     1: negative integer, 2: non-negative rational, 3: negative rational),
+ *   - the magnitude, or for rationals the magnitude of the numerator followed
+ *     by the denominator, each as the number of bytes encoded as unsigned
+ *     LEB128 varint followed by the bytes in little endian order without
+ *     leading zero bytes.
+ *
+ * Integers serialized as bn::Unsigned and bn::Signed use the same encoding, so
+ * non-negative integers can be read as either type and integers can be read as
+ * bn::Rational. Decoding a magnitude is a bounds check plus a copy of the
+ * bytes into the digit array.
+ ******************************************************************************/
+
+/**
+ * Returns the number of bytes bn::serialize writes for a number.
+ *
+ * @param u  The number.
+ * @return   Returns the size of the serialized number in bytes.
+ *
+ * @par  Runtime complexity
+ *       O(1)
+ */
+std::size_t serializedSize(const Unsigned& u);
+
+/**
+ * Returns the number of bytes bn::serialize writes for an integer.
+ *
+ * @param s  The integer.
+ * @return   Returns the size of the serialized integer in bytes.
+ *
+ * @par  Runtime complexity
+ *       O(1)
+ */
+std::size_t serializedSize(const Signed& s);
+
+/**
+ * Returns the number of bytes bn::serialize writes for a rational number.
+ *
+ * @param r  The rational number.
+ * @return   Returns the size of the serialized rational number in bytes.
+ *
+ * @par  Runtime complexity
+ *       O(1)
+ */
+std::size_t serializedSize(const Rational& r);
+
+/**
+ * Serializes a number into a buffer.
+ *
+ * @param buf  The buffer.
+ * @param len  The size of the buffer in bytes.
+ * @param u    The number.
+ * @return     Returns the number of bytes written.
+ *
+ * @exception std::length_error  Thrown if the buffer is smaller than
+ *                               bn::serializedSize(u).
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+std::size_t serialize(void* buf, std::size_t len, const Unsigned& u);
+
+/**
+ * Serializes an integer into a buffer.
+ *
+ * @param buf  The buffer.
+ * @param len  The size of the buffer in bytes.
+ * @param s    The integer.
+ * @return     Returns the number of bytes written.
+ *
+ * @exception std::length_error  Thrown if the buffer is smaller than
+ *                               bn::serializedSize(s).
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+std::size_t serialize(void* buf, std::size_t len, const Signed& s);
+
+/**
+ * Serializes a rational number into a buffer.
+ *
+ * @param buf  The buffer.
+ * @param len  The size of the buffer in bytes.
+ * @param r    The rational number.
+ * @return     Returns the number of bytes written.
+ *
+ * @exception std::length_error  Thrown if the buffer is smaller than
+ *                               bn::serializedSize(r).
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+std::size_t serialize(void* buf, std::size_t len, const Rational& r);
+
+/**
+ * Writes a serialized number to an output stream.
+ *
+ * Write errors are reported through the state of the stream.
+ *
+ * @param out  An output stream.
+ * @param u    The number.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+void serialize(std::ostream& out, const Unsigned& u);
+
+/**
+ * Writes a serialized integer to an output stream.
+ *
+ * Write errors are reported through the state of the stream.
+ *
+ * @param out  An output stream.
+ * @param s    The integer.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+void serialize(std::ostream& out, const Signed& s);
+
+/**
+ * Writes a serialized rational number to an output stream.
+ *
+ * Write errors are reported through the state of the stream.
+ *
+ * @param out  An output stream.
+ * @param r    The rational number.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+void serialize(std::ostream& out, const Rational& r);
+
+/**
+ * Deserializes a number from a buffer.
+ *
+ * @param buf  The buffer.
+ * @param len  The size of the buffer in bytes.
+ * @param u    Receives the number. Left unchanged on failure.
+ * @return     Returns the number of bytes consumed.
+ *
+ * @exception std::invalid_argument  Thrown if the buffer is truncated, has an
+ *                                   unsupported version or does not hold a
+ *                                   non-negative integer.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+std::size_t deserialize(const void* buf, std::size_t len, Unsigned& u);
+
+/**
+ * Deserializes an integer from a buffer.
+ *
+ * @param buf  The buffer.
+ * @param len  The size of the buffer in bytes.
+ * @param s    Receives the integer. Left unchanged on failure.
+ * @return     Returns the number of bytes consumed.
+ *
+ * @exception std::invalid_argument  Thrown if the buffer is truncated, has an
+ *                                   unsupported version or does not hold an
+ *                                   integer.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+std::size_t deserialize(const void* buf, std::size_t len, Signed& s);
+
+/**
+ * Deserializes a rational number from a buffer.
+ *
+ * Serialized integers are accepted as well. A fraction has to be reduced as
+ * written by bn::serialize.
+ *
+ * @param buf  The buffer.
+ * @param len  The size of the buffer in bytes.
+ * @param r    Receives the rational number. Left unchanged on failure.
+ * @return     Returns the number of bytes consumed.
+ *
+ * @exception std::invalid_argument  Thrown if the buffer is truncated, has an
+ *                                   unsupported version or holds a fraction
+ *                                   that is not reduced or has a denominator
+ *                                   of 0.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+std::size_t deserialize(const void* buf, std::size_t len, Rational& r);
+
+/**
+ * Reads a serialized number from an input stream.
+ *
+ * @param in  An input stream.
+ * @param u   Receives the number. Left unchanged on failure.
+ *
+ * @exception std::invalid_argument  Thrown if the stream ends prematurely, has
+ *                                   an unsupported version or does not hold a
+ *                                   non-negative integer.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+void deserialize(std::istream& in, Unsigned& u);
+
+/**
+ * Reads a serialized integer from an input stream.
+ *
+ * @param in  An input stream.
+ * @param s   Receives the integer. Left unchanged on failure.
+ *
+ * @exception std::invalid_argument  Thrown if the stream ends prematurely, has
+ *                                   an unsupported version or does not hold an
+ *                                   integer.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+void deserialize(std::istream& in, Signed& s);
+
+/**
+ * Reads a serialized rational number from an input stream.
+ *
+ * Serialized integers are accepted as well. A fraction has to be reduced as
+ * written by bn::serialize.
+ *
+ * @param in  An input stream.
+ * @param r   Receives the rational number. Left unchanged on failure.
+ *
+ * @exception std::invalid_argument  Thrown if the stream ends prematurely, has
+ *                                   an unsupported version or holds a fraction
+ *                                   that is not reduced or has a denominator
+ *                                   of 0.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+void deserialize(std::istream& in, Rational& r);
+
+/*******************************************************************************
+ * Result of the binary splitting evaluation of a hypergeometric series.
+ *
+ * See @ref bn::binarySplit.
+ ******************************************************************************/
+struct PQT
+{
+    /// The product p(n1)*...*p(n2-1).
+    Signed p;
+    /// The product q(n1)*...*q(n2-1).
+    Signed q;
+    /// The numerator of the partial sum. The partial sum is t/q.
+    Signed t;
+};
+
+/**
+ * Evaluates a hypergeometric series using binary splitting.
+ *
+ * Computes the partial sum
+ *
+ *   S = sum_{n=n1}^{n2-1} a(n) * (p(n1)*...*p(n)) / (q(n1)*...*q(n))
+ *
+ * by recursively halving the range [n1, n2) and combining the halves using
+ *
+ *   P = Pl*Pr, Q = Ql*Qr, T = Tl*Qr + Pl*Tr.
+ *
+ * The partial sum is returned as the fraction T/Q. As most of the work is done
+ * when multiplying the few large numbers in the upper levels of the recursion,
+ * this is much faster than summing up the series term by term. With more
+ * than one thread (see setThreadCount()), the halves of large ranges are
+ * evaluated concurrently, so a, p and q may be called concurrently as well.
+ *
+ * @tparam A   Callable type with signature Signed(std::size_t).
+ * @tparam P   Callable type with signature Signed(std::size_t).
+ * @tparam Q   Callable type with signature Signed(std::size_t).
+ * @param n1   The index of the first term.
+ * @param n2   The index after the last term.
+ * @param a    Returns the additional factor of the nth term.
+ * @param p    Returns the numerator of the ratio of the nth and (n-1)th term.
+ * @param q    Returns the denominator of the ratio of the nth and (n-1)th
+ *             term. Must not return 0.
+ * @return     Returns the products P and Q and the numerator T of the partial
+ *             sum.
+ *
+ * @par  Runtime complexity
+ *       O(n^2), where n is the number of digits of the result.
+ */
+template<typename A, typename P, typename Q>
+PQT binarySplit(
+    std::size_t n1, std::size_t n2, const A& a, const P& p, const Q& q);
+
+/**
+ * Computes the decimal digits of pi using the Chudnovsky series.
+ *
+ * @param digits  The number of decimal digits after the decimal point.
+ * @return        Returns pi*10^digits rounded down.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+Unsigned pi(std::size_t digits);
+
+/**
+ * Computes the decimal digits of Euler's number e using the series
+ * sum 1/n!.
+ *
+ * @param digits  The number of decimal digits after the decimal point.
+ * @return        Returns e*10^digits rounded down.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+Unsigned e(std::size_t digits);
+
+/**
+ * Computes the decimal digits of the natural logarithm of 2 using the series
+ * 3/4 * sum (-1)^n*(n!)^2 / (2^n*(2n+1)!).
+ *
+ * @param digits  The number of decimal digits after the decimal point.
+ * @return        Returns log(2)*10^digits rounded down.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+Unsigned log2(std::size_t digits);
+
+/*******************************************************************************
+ * Lazily computes the terms of the continued fraction expansion of a rational
+ * number.
+ *
+ * The terms are computed in batches using Lehmer's method: the quotients are
+ * determined from the leading bits of the remainders, which replaces most of
+ * the divisions of full-size numbers by multiplications with single-precision
+ * integers.
+ ******************************************************************************/
+class ContinuedFraction
+{
+public:
+    /**
+     * Constructor.
+     *
+     * @param x  The rational number to expand.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    explicit ContinuedFraction(const Rational& x);
+
+public:
+    /**
+     * Checks whether there are more terms.
+     *
+     * @return  Returns true if there are more terms, false otherwise.
+     *
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    bool hasNext() const;
+
+    /**
+     * Returns the next term of the expansion.
+     *
+     * The first term is the rounded down integral part of the number and might
+     * be negative or 0. All other terms are positive.
+     *
+     * @return  Returns the next term.
+     *
+     * @exception std::logic_error  Thrown if there are no more terms.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    Signed next();
+
+private:
+    static constexpr unsigned lehmerBits = 32;
+    static constexpr std::size_t maxBuffered = 64;
+
+    void refill();
+    void lehmerStep();
+    static Unsigned combine(
+        const Unsigned& x, std::int64_t f, const Unsigned& y, std::int64_t g);
+
+private:
+    Signed first;
+    bool hasFirst;
+    Unsigned u;
+    Unsigned v;
+    std::uint64_t buffer[maxBuffered];
+    std::size_t bufferPos;
+    std::size_t bufferSize;
+};
+
+/**
+ * Returns the lazily evaluated continued fraction expansion of a rational
+ * number.
+ *
+ * @param x  A rational number.
+ * @return   Returns the continued fraction expansion.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+ContinuedFraction continuedFraction(const Rational& x);
+
+/**
+ * Finds the best rational approximation of a rational number whose
+ * denominator does not exceed a given bound.
+ *
+ * The result is the closest fraction to x with a denominator less than or
+ * equal to maxDen. It is either a convergent or a semiconvergent of the
+ * continued fraction expansion of x. If two fractions are equally close, the
+ * one with the smaller denominator is returned.
+ *
+ * @param x       A rational number.
+ * @param maxDen  The maximal denominator.
+ * @return        Returns the best approximation.
+ *
+ * @exception std::invalid_argument  Thrown if maxDen is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+Rational bestApproximation(const Rational& x, const Unsigned& maxDen);
+
+/*******************************************************************************
+ * A natural number with a fixed number of bits.
+ *
+ * The digits are stored inline, so the number never allocates memory. As the
+ * number of digits is known at compile time, the loops of all operations have
+ * constant trip counts and can be unrolled by the compiler.
+ *
+ * Like the built-in unsigned integer types, all arithmetic is performed modulo
+ * 2^Bits.
+ *
+ * @tparam Bits  The number of bits. Must be a positive multiple of the number
+ *               of bits in bn::impl::digit_t.
+ ******************************************************************************/
+template<std::size_t Bits>
+class FixedUnsigned final
+{
+    static_assert(
+        (Bits > 0) && (Bits % impl::bitsPerDigit == 0),
+        "Bits must be a positive multiple of bitsPerDigit");
+
+public:
+    /// The number of bn::impl::digit_t elements in a number.
+    static constexpr std::size_t numDigits = Bits / impl::bitsPerDigit;
+
+public:
+    /**
+     * Default constructor.
+     *
+     * The number is initialized to 0.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    constexpr FixedUnsigned() noexcept;
+
+    /**
+     * Constructs a number from a signed 32-bit integer.
+     *
+     * @param i  The integer to construct the number from.
+     *
+     * @exception std::invalid_argument  Thrown if i is negative.
+     * @exception std::overflow_error    Thrown if i does not fit into Bits
+     *                                   bits.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedUnsigned(std::int32_t i);
+
+    /**
+     * Constructs a number from an unsigned 32-bit integer.
+     *
+     * @param i  The integer to construct the number from.
+     *
+     * @exception std::overflow_error  Thrown if i does not fit into Bits bits.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedUnsigned(std::uint32_t i);
+
+    /**
+     * Constructs a number from a signed 64-bit integer.
+     *
+     * @param i  The integer to construct the number from.
+     *
+     * @exception std::invalid_argument  Thrown if i is negative.
+     * @exception std::overflow_error    Thrown if i does not fit into Bits
+     *                                   bits.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedUnsigned(std::int64_t i);
+
+    /**
+     * Constructs a number from an unsigned 64-bit integer.
+     *
+     * @param i  The integer to construct the number from.
+     *
+     * @exception std::overflow_error  Thrown if i does not fit into Bits bits.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedUnsigned(std::uint64_t i);
+
+    /**
+     * Constructs a number from a natural number of arbitrary precision.
+     *
+     * @param u  The natural number to construct the number from.
+     *
+     * @exception std::overflow_error  Thrown if u does not fit into Bits bits.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    explicit FixedUnsigned(const Unsigned& u);
+
+    /**
+     * Constructs a number from a _bn literal.
+     *
+     * Fails to compile if the literal does not fit into Bits bits.
+     *
+     * @param l  The literal to construct the number from.
+     *
+     * @par  Runtime complexity
+     *       O(n), evaluated at compile time in constant expressions
+     */
+    template<impl::digit_t... D>
+    constexpr FixedUnsigned(impl::UnsignedLiteral<D...> l) noexcept;
+
+public:
+    /**
+     * Pre-increment operator.
+     *
+     * @return  Returns a reference to this number.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedUnsigned& operator++();
+
+    /**
+     * Post-increment operator.
+     *
+     * @return  Returns the value of the number before increasing.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedUnsigned operator++(int);
+
+    /**
+     * Pre-decrement operator.
+     *
+     * @return  Returns a reference to this number.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedUnsigned& operator--();
+
+    /**
+     * Post-decrement operator.
+     *
+     * @return  Returns the value of the number before decreasing.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedUnsigned operator--(int);
+
+    /**
+     * Bitwise OR operator.
+     *
+     * @param v  Number to OR this number with.
+     * @return   Returns a reference to this number.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedUnsigned& operator|=(const FixedUnsigned& v);
+
+    /**
+     * Bitwise AND operator.
+     *
+     * @param v  Number to AND this number with.
+     * @return   Returns a reference to this number.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedUnsigned& operator&=(const FixedUnsigned& v);
+
+    /**
+     * Bitwise XOR operator.
+     *
+     * @param v  Number to XOR this number with.
+     * @return   Returns a reference to this number.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedUnsigned& operator^=(const FixedUnsigned& v);
+
+    /**
+     * Bitwise left shift.
+     *
+     * Bits shifted beyond the highest bit are discarded.
+     *
+     * @param s  The number of bits to shift to the left.
+     * @return   Returns a reference to this number.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedUnsigned& operator<<=(std::size_t s);
+
+    /**
+     * Bitwise right shift.
+     *
+     * @param s  The number of bits to shift to the right.
+     * @return   Returns a reference to this number.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedUnsigned& operator>>=(std::size_t s);
+
+    /**
+     * Adds the passed number to this number modulo 2^Bits.
+     *
+     * @param v  The number to add.
+     * @return   Returns a reference to this number.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedUnsigned& operator+=(const FixedUnsigned& v);
+
+    /**
+     * Subtracts the passed number from this number modulo 2^Bits.
+     *
+     * @param v  The number to subtract.
+     * @return   Returns a reference to this number.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedUnsigned& operator-=(const FixedUnsigned& v);
+
+    /**
+     * Multiplies this number with the passed number modulo 2^Bits.
+     *
+     * @param v  The number to multiply with.
+     * @return   Returns a reference to this number.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    FixedUnsigned& operator*=(const FixedUnsigned& v);
+
+    /**
+     * Divides this number by the passed number.
+     *
+     * @param v  The number to divide by.
+     * @return   Returns a reference to this number.
+     *
+     * @exception std::invalid_argument  Thrown if v is 0.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    FixedUnsigned& operator/=(const FixedUnsigned& v);
+
+    /**
+     * Computes the remainder when dividing this number by the passed number.
+     *
+     * @param v  The number to divide by.
+     * @return   Returns a reference to this number.
+     *
+     * @exception std::invalid_argument  Thrown if v is 0.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    FixedUnsigned& operator%=(const FixedUnsigned& v);
+
+    /**
+     * Checks whether this number is 0.
+     *
+     * @return  Returns true if this number is 0, false otherwise.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    constexpr bool empty() const;
+
+    /**
+     * Returns the number of bits without leading zero bits.
+     *
+     * @return  Returns the position of the highest set bit plus one.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    std::size_t bits() const;
+
+    /**
+     * Converts this number to a natural number of arbitrary precision.
+     *
+     * @return  Returns this number as natural number.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    explicit operator Unsigned() const;
+
+    /**
+     * Converts this number to an unsigned 64-bit integer.
+     *
+     * @return  This number as an unsigned 64-bit integer.
+     *
+     * @exception std::overflow_error  Thrown if this number does not fit in an
+     *                                 unsigned 64-bit integer.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    explicit operator std::uint64_t() const;
+
+    /**
+     * Returns the string representation of this number in base 10.
+     *
+     * @return  Returns the string representation of this number in base 10.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    std::string str() const;
+
+public:
+    struct QR;
+
+private:
+    template<typename T>
+    void initFromIntegral(T val);
+    std::size_t significantDigits() const;
+    static void divide(
+        const FixedUnsigned& u,
+        const FixedUnsigned& v,
+        FixedUnsigned* q,
+        FixedUnsigned* r);
+
+    constexpr bool zeroBelow(std::size_t n) const;
+    constexpr bool equalBelow(const FixedUnsigned& v, std::size_t n) const;
+    constexpr bool lessBelow(const FixedUnsigned& v, std::size_t n) const;
+
+private:
+    template<std::size_t B>
+    friend constexpr bool
+        operator==(const FixedUnsigned<B>& u, const FixedUnsigned<B>& v);
+    template<std::size_t B>
+    friend constexpr bool
+        operator<(const FixedUnsigned<B>& u, const FixedUnsigned<B>& v);
+    template<std::size_t B>
+    friend typename FixedUnsigned<B>::QR
+        div(const FixedUnsigned<B>& u, const FixedUnsigned<B>& v);
+    template<std::size_t B>
+    friend FixedUnsigned<2 * B>
+        mulWide(const FixedUnsigned<B>& u, const FixedUnsigned<B>& v);
+
+    template<std::size_t B>
+    friend class FixedUnsigned;
+    template<std::size_t B>
+    friend class FixedSigned;
+    template<std::size_t B>
+    friend class UnsignedBatch;
+
+private:
+    impl::digit_t digit[numDigits];
+};
+
+/*******************************************************************************
+ * Result of a division of fixed-size natural numbers.
+ ******************************************************************************/
+template<std::size_t Bits>
+struct FixedUnsigned<Bits>::QR
+{
+    /// The quotient.
+    FixedUnsigned<Bits> quot;
+    /// The remainder.
+    FixedUnsigned<Bits> rem;
+};
+
+/**
+ * Equal comparison.
+ *
+ * @param u  First number.
+ * @param v  Second number.
+ * @return   Returns true if the numbers are equal, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+constexpr bool
+    operator==(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v);
+
+/**
+ * Inequal comparison.
+ *
+ * @param u  First number.
+ * @param v  Second number.
+ * @return   Returns true if the numbers are not equal, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+constexpr bool
+    operator!=(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v);
+
+/**
+ * Less than comparison.
+ *
+ * @param u  First number.
+ * @param v  Second number.
+ * @return   Returns true if the first number is less than the second number,
+ *           false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+constexpr bool
+    operator<(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v);
+
+/**
+ * Greater than or equal comparison.
+ *
+ * @param u  First number.
+ * @param v  Second number.
+ * @return   Returns true if the first number is greater than or equal to the
+ *           second number, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+constexpr bool
+    operator>=(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v);
+
+/**
+ * Greater than comparison.
+ *
+ * @param u  First number.
+ * @param v  Second number.
+ * @return   Returns true if the first number is greater than the second number,
+ *           false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+constexpr bool
+    operator>(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v);
+
+/**
+ * Less than or equal comparison.
+ *
+ * @param u  First number.
+ * @param v  Second number.
+ * @return   Returns true if the first number is less than or equal to the
+ *           second number, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+constexpr bool
+    operator<=(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v);
+
+/**
+ * Bitwise OR operator.
+ *
+ * @param u  First number.
+ * @param v  Second number.
+ * @return   Returns the result of a bitwise OR of both numbers.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+FixedUnsigned<Bits>
+    operator|(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v);
+
+/**
+ * Bitwise AND operator.
+ *
+ * @param u  First number.
+ * @param v  Second number.
+ * @return   Returns the result of a bitwise AND of both numbers.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+FixedUnsigned<Bits>
+    operator&(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v);
+
+/**
+ * Bitwise XOR operator.
+ *
+ * @param u  First number.
+ * @param v  Second number.
+ * @return   Returns the result of a bitwise XOR of both numbers.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+FixedUnsigned<Bits>
+    operator^(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v);
+
+/**
+ * Bitwise left shift operator.
+ *
+ * @param u  The number to shift.
+ * @param s  The number of bits to shift to the left.
+ * @return   Returns the shifted number.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+FixedUnsigned<Bits> operator<<(const FixedUnsigned<Bits>& u, std::size_t s);
+
+/**
+ * Bitwise right shift operator.
+ *
+ * @param u  The number to shift.
+ * @param s  The number of bits to shift to the right.
+ * @return   Returns the shifted number.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+FixedUnsigned<Bits> operator>>(const FixedUnsigned<Bits>& u, std::size_t s);
+
+/**
+ * Adds two numbers modulo 2^Bits.
+ *
+ * @param u  First summand.
+ * @param v  Second summand.
+ * @return   Returns the sum.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+FixedUnsigned<Bits>
+    operator+(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v);
+
+/**
+ * Subtracts a number from a number modulo 2^Bits.
+ *
+ * @param u  Minuend.
+ * @param v  Subtrahend.
+ * @return   Returns the difference.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+FixedUnsigned<Bits>
+    operator-(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v);
+
+/**
+ * Multiplies two numbers modulo 2^Bits.
+ *
+ * @param u  First factor.
+ * @param v  Second factor.
+ * @return   Returns the product.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+template<std::size_t Bits>
+FixedUnsigned<Bits>
+    operator*(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v);
+
+/**
+ * Divides a number by another.
+ *
+ * @param u  Divident.
+ * @param v  Divisor.
+ * @return   Returns the quotient.
+ *
+ * @exception std::invalid_argument  Thrown if the divisor is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+template<std::size_t Bits>
+FixedUnsigned<Bits>
+    operator/(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v);
+
+/**
+ * Computes the remainder of a division.
+ *
+ * @param u  Divident.
+ * @param v  Divisor.
+ * @return   Returns the remainder.
+ *
+ * @exception std::invalid_argument  Thrown if the divisor is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+template<std::size_t Bits>
+FixedUnsigned<Bits>
+    operator%(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v);
+
+/**
+ * Divides a number by another.
+ *
+ * @param u  Divident.
+ * @param v  Divisor.
+ * @return   Returns the quotient and remainder.
+ *
+ * @exception std::invalid_argument  Thrown if the divisor is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+template<std::size_t Bits>
+typename FixedUnsigned<Bits>::QR
+    div(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v);
+
+/**
+ * Multiplies two numbers without truncating the product.
+ *
+ * @param u  First factor.
+ * @param v  Second factor.
+ * @return   Returns the full product with twice the number of bits.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+template<std::size_t Bits>
+FixedUnsigned<2 * Bits>
+    mulWide(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v);
+
+/**
+ * Writes a number in base 10 to an output stream.
+ *
+ * @param out  An output stream.
+ * @param u    The number.
+ * @return     Returns the output stream.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+template<std::size_t Bits>
+std::ostream& operator<<(std::ostream& out, const FixedUnsigned<Bits>& u);
+
+/*******************************************************************************
+ * An integer with a fixed number of bits in two's complement representation.
+ *
+ * The integer never allocates memory. Like the unsigned built-in integer
+ * types, addition, subtraction and multiplication wrap around, so the results
+ * are congruent to the exact results modulo 2^Bits. Division truncates towards
+ * 0 and the remainder has the same sign as the divident.
+ *
+ * @tparam Bits  The number of bits including the sign bit. Must be a positive
+ *               multiple of the number of bits in bn::impl::digit_t.
+ ******************************************************************************/
+template<std::size_t Bits>
+class FixedSigned final
+{
+public:
+    /**
+     * Default constructor.
+     *
+     * The integer is initialized to 0.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedSigned() noexcept;
+
+    /**
+     * Constructs an integer from a signed 32-bit integer.
+     *
+     * @param i  The integer to construct the integer from.
+     *
+     * @exception std::overflow_error  Thrown if i does not fit into Bits bits.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedSigned(std::int32_t i);
+
+    /**
+     * Constructs an integer from an unsigned 32-bit integer.
+     *
+     * @param i  The integer to construct the integer from.
+     *
+     * @exception std::overflow_error  Thrown if i does not fit into Bits bits.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedSigned(std::uint32_t i);
+
+    /**
+     * Constructs an integer from a signed 64-bit integer.
+     *
+     * @param i  The integer to construct the integer from.
+     *
+     * @exception std::overflow_error  Thrown if i does not fit into Bits bits.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedSigned(std::int64_t i);
+
+    /**
+     * Constructs an integer from an unsigned 64-bit integer.
+     *
+     * @param i  The integer to construct the integer from.
+     *
+     * @exception std::overflow_error  Thrown if i does not fit into Bits bits.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedSigned(std::uint64_t i);
+
+    /**
+     * Constructs an integer from an integer of arbitrary precision.
+     *
+     * @param s  The integer to construct the integer from.
+     *
+     * @exception std::overflow_error  Thrown if s does not fit into Bits bits.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    explicit FixedSigned(const Signed& s);
+
+public:
+    /**
+     * Returns the sign of this integer.
+     *
+     * @return  Returns -1 if the integer is negative, 1 if the integer is
+     *          positive and 0 if the integer is 0.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    int sgn() const;
+
+    /**
+     * Returns the absolute value of this integer.
+     *
+     * @return  Returns the absolute value of this integer.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedUnsigned<Bits> abs() const;
+
+    /**
+     * Pre-increment operator.
+     *
+     * @return  Returns a reference to this integer.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedSigned& operator++();
+
+    /**
+     * Post-increment operator.
+     *
+     * @return  Returns the value of the integer before increasing.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedSigned operator++(int);
+
+    /**
+     * Pre-decrement operator.
+     *
+     * @return  Returns a reference to this integer.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedSigned& operator--();
+
+    /**
+     * Post-decrement operator.
+     *
+     * @return  Returns the value of the integer before decreasing.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedSigned operator--(int);
+
+    /**
+     * Adds the passed integer to this integer.
+     *
+     * @param v  The integer to add.
+     * @return   Returns a reference to this integer.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedSigned& operator+=(const FixedSigned& v);
+
+    /**
+     * Subtracts the passed integer from this integer.
+     *
+     * @param v  The integer to subtract.
+     * @return   Returns a reference to this integer.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    FixedSigned& operator-=(const FixedSigned& v);
+
+    /**
+     * Multiplies this integer with the passed integer.
+     *
+     * @param v  The integer to multiply with.
+     * @return   Returns a reference to this integer.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    FixedSigned& operator*=(const FixedSigned& v);
+
+    /**
+     * Divides this integer by the passed integer.
+     *
+     * @param v  The integer to divide by.
+     * @return   Returns a reference to this integer.
+     *
+     * @exception std::invalid_argument  Thrown if v is 0.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    FixedSigned& operator/=(const FixedSigned& v);
+
+    /**
+     * Computes the remainder when dividing this integer by the passed integer.
+     *
+     * @param v  The integer to divide by.
+     * @return   Returns a reference to this integer.
+     *
+     * @exception std::invalid_argument  Thrown if v is 0.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    FixedSigned& operator%=(const FixedSigned& v);
+
+    /**
+     * Converts this integer to an integer of arbitrary precision.
+     *
+     * @return  Returns this integer as integer of arbitrary precision.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    explicit operator Signed() const;
+
+    /**
+     * Returns the string representation of this integer in base 10.
+     *
+     * @return  Returns the string representation of this integer in base 10.
+     *
+     * @par  Runtime complexity
+     *       O(n^2)
+     */
+    std::string str() const;
+
+private:
+    bool negative() const;
+    void negate();
+    void assignMagnitude(const FixedUnsigned<Bits>& m, bool neg);
+
+private:
+    template<std::size_t B>
+    friend bool operator==(const FixedSigned<B>& u, const FixedSigned<B>& v);
+    template<std::size_t B>
+    friend bool operator<(const FixedSigned<B>& u, const FixedSigned<B>& v);
+
+private:
+    FixedUnsigned<Bits> val;
+};
+
+/**
+ * Equal comparison.
+ *
+ * @param u  First integer.
+ * @param v  Second integer.
+ * @return   Returns true if the integers are equal, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+bool operator==(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v);
+
+/**
+ * Inequal comparison.
+ *
+ * @param u  First integer.
+ * @param v  Second integer.
+ * @return   Returns true if the integers are not equal, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+bool operator!=(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v);
+
+/**
+ * Less than comparison.
+ *
+ * @param u  First integer.
+ * @param v  Second integer.
+ * @return   Returns true if the first integer is less than the second integer,
+ *           false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+bool operator<(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v);
+
+/**
+ * Greater than or equal comparison.
+ *
+ * @param u  First integer.
+ * @param v  Second integer.
+ * @return   Returns true if the first integer is greater than or equal to the
+ *           second integer, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+bool operator>=(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v);
+
+/**
+ * Greater than comparison.
+ *
+ * @param u  First integer.
+ * @param v  Second integer.
+ * @return   Returns true if the first integer is greater than the second
+ *           integer, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+bool operator>(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v);
+
+/**
+ * Less than or equal comparison.
+ *
+ * @param u  First integer.
+ * @param v  Second integer.
+ * @return   Returns true if the first integer is less than or equal to the
+ *           second integer, false otherwise.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+bool operator<=(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v);
+
+/**
+ * Negates an integer.
+ *
+ * @param u  The integer to negate.
+ * @return   The negated integer.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+FixedSigned<Bits> operator-(const FixedSigned<Bits>& u);
+
+/**
+ * Adds two integers.
+ *
+ * @param u  First summand.
+ * @param v  Second summand.
+ * @return   Returns the sum.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+FixedSigned<Bits>
+    operator+(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v);
+
+/**
+ * Subtracts an integer from an integer.
+ *
+ * @param u  Minuend.
+ * @param v  Subtrahend.
+ * @return   Returns the difference.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+FixedSigned<Bits>
+    operator-(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v);
+
+/**
+ * Multiplies two integers with each other.
+ *
+ * @param u  First factor.
+ * @param v  Second factor.
+ * @return   Returns the product.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+template<std::size_t Bits>
+FixedSigned<Bits>
+    operator*(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v);
+
+/**
+ * Divides an integer by another.
+ *
+ * @param u  Divident.
+ * @param v  Divisor.
+ * @return   Returns the quotient.
+ *
+ * @exception std::invalid_argument  Thrown if the divisor is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+template<std::size_t Bits>
+FixedSigned<Bits>
+    operator/(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v);
+
+/**
+ * Computes the remainder of a division.
+ *
+ * @param u  Divident.
+ * @param v  Divisor.
+ * @return   Returns the remainder.
+ *
+ * @exception std::invalid_argument  Thrown if the divisor is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+template<std::size_t Bits>
+FixedSigned<Bits>
+    operator%(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v);
+
+/**
+ * Writes an integer in base 10 to an output stream.
+ *
+ * @param out  An output stream.
+ * @param s    An integer.
+ * @return     Returns the output stream.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+template<std::size_t Bits>
+std::ostream& operator<<(std::ostream& out, const FixedSigned<Bits>& s);
+
+/*******************************************************************************
+ * A batch of fixed-size natural numbers in structure-of-arrays layout.
+ *
+ * The numbers in a batch are called lanes. The batch stores the first digit of
+ * all lanes contiguously, followed by the second digit of all lanes and so on.
+ * bn::batchAdd and bn::batchMul process one digit position of all lanes in an
+ * inner loop without dependencies between lanes, which compilers can
+ * vectorize.
+ *
+ * Like bn::FixedUnsigned, arithmetic wraps around modulo 2^Bits.
+ *
+ * @tparam Bits  The number of bits of each number.
+ ******************************************************************************/
+template<std::size_t Bits>
+class UnsignedBatch final
+{
+public:
+    /// The number of bn::impl::digit_t elements in a number.
+    static constexpr std::size_t numDigits = FixedUnsigned<Bits>::numDigits;
+
+public:
+    /**
+     * Constructs a batch.
+     *
+     * All lanes are initialized to 0.
+     *
+     * @param lanes  The number of lanes.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    explicit UnsignedBatch(std::size_t lanes = 0);
+
+    /**
+     * Constructs a batch from numbers.
+     *
+     * @param values  The numbers, one per lane.
+     * @return        Returns the batch.
+     *
+     * @exception std::overflow_error  Thrown if a number does not fit into Bits
+     *                                 bits.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    static UnsignedBatch fromUnsigned(const std::vector<Unsigned>& values);
+
+public:
+    /**
+     * Returns the number of lanes.
+     *
+     * @return  Returns the number of lanes.
+     *
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * Returns the number in a lane.
+     *
+     * @param lane  The lane, which must be less than size().
+     * @return      Returns the number.
+     *
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    FixedUnsigned<Bits> get(std::size_t lane) const;
+
+    /**
+     * Sets the number in a lane.
+     *
+     * @param lane  The lane, which must be less than size().
+     * @param u     The number.
+     *
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    void set(std::size_t lane, const FixedUnsigned<Bits>& u);
+
+    /**
+     * Converts all lanes to numbers.
+     *
+     * @return  Returns the numbers, one per lane.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    std::vector<Unsigned> toUnsigned() const;
+
+    /**
+     * Returns a digit position of all lanes.
+     *
+     * @param k  The digit position, which must be less than numDigits.
+     * @return   Returns a pointer to size() digits, the k-th digit of each
+     *           lane.
+     *
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    impl::digit_t* row(std::size_t k) noexcept;
+
+    /**
+     * Returns a digit position of all lanes.
+     *
+     * @param k  The digit position, which must be less than numDigits.
+     * @return   Returns a pointer to size() digits, the k-th digit of each
+     *           lane.
+     *
+     * @par  Runtime complexity
+     *       O(1)
+     */
+    const impl::digit_t* row(std::size_t k) const noexcept;
+
+private:
+    std::size_t lanes;
+    std::vector<impl::digit_t> digit;
+};
+
+/**
+ * Adds two batches lane by lane.
+ *
+ * The result may alias an argument.
+ *
+ * @param u  The first summands.
+ * @param v  The second summands.
+ * @param w  Receives the sums modulo 2^Bits. It is resized to the number of
+ *           lanes of u.
+ *
+ * @exception std::invalid_argument  Thrown if u and v differ in size.
+ *
+ * @par  Runtime complexity
+ *       O(n)
+ */
+template<std::size_t Bits>
+void batchAdd(
+    const UnsignedBatch<Bits>& u,
+    const UnsignedBatch<Bits>& v,
+    UnsignedBatch<Bits>& w);
+
+/**
+ * Multiplies two batches lane by lane.
+ *
+ * Only the digits of the products below 2^Bits are computed. The result may
+ * alias an argument.
+ *
+ * @param u  The multiplicands.
+ * @param v  The multipliers.
+ * @param w  Receives the products modulo 2^Bits. It is resized to the number
+ *           of lanes of u.
+ *
+ * @exception std::invalid_argument  Thrown if u and v differ in size.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+template<std::size_t Bits>
+void batchMul(
+    const UnsignedBatch<Bits>& u,
+    const UnsignedBatch<Bits>& v,
+    UnsignedBatch<Bits>& w);
+
+/**
+ * Reduces all lanes of a batch modulo a common modulus.
+ *
+ * The remainders are computed lane by lane with the division of
+ * bn::FixedUnsigned. The result may alias the argument.
+ *
+ * @param u  The dividends.
+ * @param m  The modulus.
+ * @param w  Receives the remainders. It is resized to the number of lanes of
+ *           u.
+ *
+ * @exception std::invalid_argument  Thrown if the modulus is 0.
+ *
+ * @par  Runtime complexity
+ *       O(n^2)
+ */
+template<std::size_t Bits>
+void batchMod(
+    const UnsignedBatch<Bits>& u,
+    const FixedUnsigned<Bits>& m,
+    UnsignedBatch<Bits>& w);
+//------------------------------------------------------------------------------
+namespace impl {
+//------------------------------------------------------------------------------
+// The number of lanes that bn::batchAdd and bn::batchMul process at once. Their
+// carries are kept on the stack.
+constexpr std::size_t batchLanes = 64;
+//------------------------------------------------------------------------------
+/*******************************************************************************
+ * The value of a _bn literal.
+ *
+ * The digits are computed at compile time and stored in a static array, so
+ * converting the literal never parses a string at runtime. bn::FixedUnsigned
+ * can be constructed from a literal in constant expressions.
+ *
+ * @tparam D  The digits of the number with the least significant digit first.
+ ******************************************************************************/
+template<digit_t... D>
+class UnsignedLiteral final
+{
+public:
+    /// The number of digits of the number.
+    static constexpr std::size_t numDigits = sizeof...(D);
+
+public:
+    /**
+     * Converts the literal to a natural number.
+     *
+     * @return  Returns the literal as natural number.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    operator Unsigned() const;
+
+    /**
+     * Converts the literal to an integer.
+     *
+     * @return  Returns the literal as integer.
+     *
+     * @par  Runtime complexity
+     *       O(n)
+     */
+    operator Signed() const;
+
+private:
+    static constexpr digit_t digit[numDigits + 1] = {D..., 0};
+};
+//------------------------------------------------------------------------------
+template<typename List>
+struct LiteralOf;
+
+template<digit_t... D>
+struct LiteralOf<DigitList<D...>>
+{
+    using type = UnsignedLiteral<D...>;
+};
+//------------------------------------------------------------------------------
+}  // namespace impl
+//------------------------------------------------------------------------------
+inline namespace literals {
+//------------------------------------------------------------------------------
+/**
+ * Creates a natural number from a decimal integer literal at compile time.
+ *
+ * The literal converts to bn::Unsigned, bn::Signed and, in constant
+ * expressions, to bn::FixedUnsigned:
+ *
+ *     Unsigned p = 170141183460469231731687303715884105727_bn;
+ *     constexpr FixedUnsigned<64> q = 18446744073709551557_bn;
+ *
+ * Only decimal literals without leading zeros are supported, so 0777_bn does
+ * not compile rather than silently ignoring the octal prefix.
+ *
+ * @par  Runtime complexity
+ *       O(1)
+ */
+template<char... C>
+constexpr typename impl::LiteralOf<
+    typename impl::ParseDecimal<impl::DigitList<>, C...>::type>::type
+    operator"" _bn();
+//------------------------------------------------------------------------------
+}  // namespace literals
+
+//------------------------------------------------------------------------------
+namespace impl {
+//------------------------------------------------------------------------------
+// Instrumentation
+//------------------------------------------------------------------------------
+// Returns the bucket of the operand size histograms for n digits.
+inline std::size_t sizeBucket(std::size_t n)
+{
+    const std::size_t b = 8 * sizeof(std::size_t) - countLeadingZeroes(n);
+    return std::min(b, numSizeBuckets - 1);
+}
+//------------------------------------------------------------------------------
+#ifdef BN_INSTRUMENT
+// The process-wide counters behind statistics(). They are only incremented,
+// so relaxed atomics suffice.
+struct Counters
+{
+    struct Op
+    {
+        std::atomic<std::uint64_t> calls;
+        std::atomic<std::uint64_t> nanoseconds;
+        std::atomic<std::uint64_t> sizes[numSizeBuckets];
+    };
+
+    static Counters& instance();
+    static void add(std::atomic<std::uint64_t>& c, std::uint64_t n) noexcept;
+
+    Op operations[numOperations];
+    std::atomic<std::uint64_t> allocations;
+    std::atomic<std::uint64_t> allocatedBytes;
+    std::atomic<std::uint64_t> reallocations;
+    std::atomic<std::uint64_t> deallocations;
+};
+//------------------------------------------------------------------------------
+inline Counters& Counters::instance()
+{
+    // Zero-initialized as an object with static storage duration.
+    static Counters counters;
+    return counters;
+}
+//------------------------------------------------------------------------------
+inline void
+    Counters::add(std::atomic<std::uint64_t>& c, std::uint64_t n) noexcept
+{
+    c.fetch_add(n, std::memory_order_relaxed);
+}
+#endif
+//------------------------------------------------------------------------------
+// Passes operations that exceed the thresholds of setTraceHook() to the hook.
+class Tracer final
+{
+public:
+    using Hook = std::function<void(const TraceEvent&)>;
+
+    static Tracer& instance();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    bool enabled() const noexcept;
+    void
+        set(Hook hook, std::size_t minDigits, std::chrono::nanoseconds minTime);
+    void report(const TraceEvent& event);
+
+private:
+    Tracer() noexcept;
+
+    static bool& insideHook() noexcept;
+
+private:
+    std::atomic<bool> active;
+    std::atomic<std::size_t> minDigits;
+    std::atomic<std::int64_t> minNanoseconds;
+    // Accessed through std::atomic_load and std::atomic_store.
+    std::shared_ptr<const Hook> hook;
+};
+//------------------------------------------------------------------------------
+inline Tracer& Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+//------------------------------------------------------------------------------
+inline Tracer::Tracer() noexcept
+    : active(false), minDigits(0), minNanoseconds(0)
+{
+}
+//------------------------------------------------------------------------------
+inline bool Tracer::enabled() const noexcept
+{
+    return active.load(std::memory_order_relaxed);
+}
+//------------------------------------------------------------------------------
+inline void
+    Tracer::set(Hook h, std::size_t digits, std::chrono::nanoseconds minTime)
+{
+    std::shared_ptr<const Hook> p;
+    if (h) {
+        p = std::make_shared<const Hook>(std::move(h));
+    }
+    // A threshold of 0 never matches unless both are 0.
+    const bool all = (digits == 0) && (minTime.count() == 0);
+    minDigits.store(
+        ((digits != 0) || all) ? digits
+                               : std::numeric_limits<std::size_t>::max());
+    minNanoseconds.store(
+        ((minTime.count() != 0) || all)
+            ? static_cast<std::int64_t>(minTime.count())
+            : std::numeric_limits<std::int64_t>::max());
+    std::atomic_store(&hook, p);
+    active.store(p != nullptr);
+}
+//------------------------------------------------------------------------------
+inline void Tracer::report(const TraceEvent& event)
+{
+    const std::size_t digits = std::max(
+        std::max(event.digits[0], event.digits[1]), event.digits[2]);
+    if ((digits < minDigits.load())
+        && (event.elapsed.count() < minNanoseconds.load())) {
+        return;
+    }
+    // Operations of the hook itself are not reported.
+    if (insideHook()) {
+        return;
+    }
+    const std::shared_ptr<const Hook> h = std::atomic_load(&hook);
+    if (h) {
+        insideHook() = true;
+        (*h)(event);
+        insideHook() = false;
+    }
+}
+//------------------------------------------------------------------------------
+inline bool& Tracer::insideHook() noexcept
+{
+    static thread_local bool inside = false;
+    return inside;
+}
+//------------------------------------------------------------------------------
+// Measures an operation until the end of the scope. It is counted if the
+// library is compiled with BN_INSTRUMENT and reported to the trace hook if
+// one is set. Otherwise, only the sizes of the operands are stored.
+class OperationScope final
+{
+public:
+    OperationScope(
+        Operation op,
+        std::size_t digits0,
+        std::size_t digits1 = 0,
+        std::size_t digits2 = 0) noexcept;
+    OperationScope(const OperationScope&) = delete;
+    OperationScope& operator=(const OperationScope&) = delete;
+    ~OperationScope();
+
+private:
+    Operation op;
+    std::size_t digits[3];
+    bool timed;
+    std::chrono::steady_clock::time_point start;
+};
+//------------------------------------------------------------------------------
+inline OperationScope::OperationScope(
+    Operation o,
+    std::size_t digits0,
+    std::size_t digits1,
+    std::size_t digits2) noexcept
+    : op(o),
+      digits{digits0, digits1, digits2},
+      timed(Tracer::instance().enabled())
+{
+#ifdef BN_INSTRUMENT
+    Counters::Op& c = Counters::instance().operations[static_cast<int>(op)];
+    Counters::add(c.calls, 1);
+    Counters::add(
+        c.sizes[sizeBucket(std::max(std::max(digits0, digits1), digits2))], 1);
+    timed = true;
+#endif
+    if (timed) {
+        start = std::chrono::steady_clock::now();
+    }
+}
+//------------------------------------------------------------------------------
+inline OperationScope::~OperationScope()
+{
+    if (!timed) {
+        return;
+    }
+    const std::chrono::nanoseconds elapsed =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start);
+#ifdef BN_INSTRUMENT
+    Counters::add(
+        Counters::instance().operations[static_cast<int>(op)].nanoseconds,
+        static_cast<std::uint64_t>(elapsed.count()));
+#endif
+    Tracer& tracer = Tracer::instance();
+    if (tracer.enabled()) {
+        const TraceEvent event{
+            op, operationName(op), {digits[0], digits[1], digits[2]}, elapsed};
+        tracer.report(event);
+    }
+}
+//------------------------------------------------------------------------------
+}  // namespace impl
+//------------------------------------------------------------------------------
+inline Statistics statistics()
+{
+    Statistics s{};
+#ifdef BN_INSTRUMENT
+    const impl::Counters& c = impl::Counters::instance();
+    for (std::size_t i = 0; i < numOperations; ++i) {
+        s.operations[i].calls = c.operations[i].calls.load();
+        s.operations[i].nanoseconds = c.operations[i].nanoseconds.load();
+        for (std::size_t k = 0; k < numSizeBuckets; ++k) {
+            s.operations[i].sizes[k] = c.operations[i].sizes[k].load();
+        }
+    }
+    s.allocations = c.allocations.load();
+    s.allocatedBytes = c.allocatedBytes.load();
+    s.reallocations = c.reallocations.load();
+    s.deallocations = c.deallocations.load();
+#endif
+    return s;
+}
+//------------------------------------------------------------------------------
+inline void resetStatistics()
+{
+#ifdef BN_INSTRUMENT
+    impl::Counters& c = impl::Counters::instance();
+    for (impl::Counters::Op& op : c.operations) {
+        op.calls.store(0);
+        op.nanoseconds.store(0);
+        for (std::atomic<std::uint64_t>& b : op.sizes) {
+            b.store(0);
+        }
+    }
+    c.allocations.store(0);
+    c.allocatedBytes.store(0);
+    c.reallocations.store(0);
+    c.deallocations.store(0);
+#endif
+}
+//------------------------------------------------------------------------------
+inline const char* operationName(Operation op)
+{
+    static const char* const names[numOperations] = {
+        "add",
+        "subtract",
+        "multiply",
+        "divide",
+        "powmod",
+        "sqrt",
+        "gcd",
+        "format",
+        "parse"};
+    return names[static_cast<int>(op)];
+}
+//------------------------------------------------------------------------------
+inline void setTraceHook(
+    std::function<void(const TraceEvent&)> hook,
+    std::size_t minDigits,
+    std::chrono::nanoseconds minTime)
+{
+    impl::Tracer::instance().set(std::move(hook), minDigits, minTime);
+}
+//------------------------------------------------------------------------------
+namespace impl {
+//------------------------------------------------------------------------------
+inline Store::Store() noexcept : mem(smem), cap(smemsize), sz(0)
+{
+}
+//------------------------------------------------------------------------------
+inline Store::Store(const Store& other)
+{
+    if (other.sz <= smemsize) {
+        memcpy(smem, other.mem, other.sz * sizeof(impl::digit_t));
+        mem = smem;
+        cap = smemsize;
+        sz = other.sz;
+    } else {
+        mem = alloc_digits(other.sz);
+        memcpy(mem, other.mem, other.sz * sizeof(impl::digit_t));
+        cap = other.sz;
+        sz = other.sz;
+    }
+}
+//------------------------------------------------------------------------------
+inline Store::Store(Store&& other) noexcept
+{
+    if (other.cap == smemsize) {
+        memcpy(smem, other.smem, other.sz * sizeof(impl::digit_t));
+        mem = smem;
+        cap = other.cap;
+        sz = other.sz;
+    } else {
+        mem = other.mem;
+        cap = other.cap;
+        sz = other.sz;
+        other.mem = other.smem;
+        other.cap = smemsize;
+        other.sz = 0;
+    }
+}
+//------------------------------------------------------------------------------
+inline Store::~Store()
+{
+    if (cap != smemsize) {
+        deallocate(mem);
+    }
+}
+//------------------------------------------------------------------------------
+inline Store& Store::operator=(const Store& other)
+{
+    if (other.sz <= smemsize) {
+        if (cap >= (2 * smemsize)) {
+            deallocate(mem);
+            mem = smem;
+            cap = smemsize;
+        }
+    } else if (other.sz <= cap) {
+        if (cap >= (2 * other.sz)) {
+            impl::digit_t* temp = alloc_digits(other.sz);
+            deallocate(mem);
+            mem = temp;
+            cap = other.sz;
+        }
+    } else {
+        impl::digit_t* temp = alloc_digits(other.sz);
+        if (cap != smemsize) {
+            deallocate(mem);
+        }
+        mem = temp;
+        cap = other.sz;
+    }
+    memcpy(mem, other.mem, other.sz * sizeof(impl::digit_t));
+    sz = other.sz;
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Store& Store::operator=(Store&& other) noexcept
+{
+    if (other.cap == smemsize) {
+        memcpy(smem, other.smem, other.sz * sizeof(impl::digit_t));
+        if (cap == smemsize) {
+            sz = other.sz;
+        } else {
+            other.mem = mem;
+            mem = smem;
+            other.cap = cap;
+            cap = smemsize;
+            std::swap(sz, other.sz);
+        }
+    } else {
+        if (cap == smemsize) {
+            memcpy(other.smem, smem, sz * sizeof(impl::digit_t));
+            mem = other.mem;
+            other.mem = other.smem;
+            cap = other.cap;
+            other.cap = smemsize;
+            std::swap(sz, other.sz);
+        } else {
+            std::swap(mem, other.mem);
+            std::swap(cap, other.cap);
+            std::swap(sz, other.sz);
+        }
+    }
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline std::size_t Store::size() const noexcept
+{
+    return sz;
+}
+//------------------------------------------------------------------------------
+inline const impl::digit_t& Store::operator[](std::size_t i) const noexcept
+{
+    assert(i < sz);
+    return mem[i];
+}
+//------------------------------------------------------------------------------
+inline impl::digit_t& Store::operator[](std::size_t i) noexcept
+{
+    assert(i < sz);
+    return mem[i];
+}
+//------------------------------------------------------------------------------
+inline void Store::resize(std::size_t newsize)
+{
+    if (newsize <= smemsize) {
+        if (cap >= (2 * smemsize)) {
+            memcpy(smem, mem, newsize * sizeof(impl::digit_t));
+            deallocate(mem);
+            mem = smem;
+            cap = smemsize;
+        }
+        sz = newsize;
+    } else if (newsize <= cap) {
+        if (cap >= (2 * newsize)) {
+            impl::digit_t* temp = alloc_digits(newsize);
+#ifdef BN_INSTRUMENT
+            Counters::add(Counters::instance().reallocations, 1);
+#endif
+            memcpy(temp, mem, newsize * sizeof(impl::digit_t));
+            deallocate(mem);
+            mem = temp;
+            cap = newsize;
+        }
+        sz = newsize;
+    } else {
+        impl::digit_t* temp = alloc_digits(newsize);
+#ifdef BN_INSTRUMENT
+        if (cap != smemsize) {
+            Counters::add(Counters::instance().reallocations, 1);
+        }
+#endif
+        memcpy(temp, mem, sz * sizeof(impl::digit_t));
+        if (cap != smemsize) {
+            deallocate(mem);
+        }
+        mem = temp;
+        cap = newsize;
+        sz = newsize;
+    }
+}
+//------------------------------------------------------------------------------
+inline void Store::setSize(std::size_t newsize)
+{
+    if (newsize > cap) {
+        impl::digit_t* temp = alloc_digits(newsize);
+#ifdef BN_INSTRUMENT
+        if (cap != smemsize) {
+            Counters::add(Counters::instance().reallocations, 1);
+        }
+#endif
+        memcpy(temp, mem, sz * sizeof(impl::digit_t));
+        if (cap != smemsize) {
+            deallocate(mem);
+        }
+        mem = temp;
+        cap = newsize;
+    }
+    sz = newsize;
+}
+//------------------------------------------------------------------------------
+inline void Store::deallocate(void* ptr)
+{
+#ifdef BN_INSTRUMENT
+    Counters::add(Counters::instance().deallocations, 1);
+#endif
+    std::free(ptr);
+}
+//------------------------------------------------------------------------------
+inline impl::digit_t* Store::alloc_digits(std::size_t count)
+{
+    constexpr std::size_t maxDigits =
+        static_cast<std::size_t>(std::numeric_limits<ptrdiff_t>::max())
+        / impl::bitsPerDigit;
+    if (count > maxDigits) {
+        throw std::bad_alloc();
+    }
+    const size_t numBytes = count * sizeof(impl::digit_t);
+    void* mem = std::malloc(numBytes);
+    if (mem == nullptr) {
+        throw std::bad_alloc();
+    }
+#ifdef BN_INSTRUMENT
+    Counters::add(Counters::instance().allocations, 1);
+    Counters::add(Counters::instance().allocatedBytes, numBytes);
+#endif
+    return static_cast<impl::digit_t*>(mem);
+}
+//------------------------------------------------------------------------------
+// Radix conversion
+//------------------------------------------------------------------------------
+// Numbers with more than BN_RADIX_FORMAT_THRESHOLD digits are converted to
+// strings in bases that are not powers of two by splitting them recursively by
+// powers of the base. Smaller numbers are repeatedly divided by a single digit.
+//
+// Strings longer than BN_RADIX_PARSE_THRESHOLD digits are split recursively
+// when parsed. With the schoolbook multiplication, the split is slower than
+// repeated multiplication by a single digit, so the default is very high.
+#ifndef BN_RADIX_FORMAT_THRESHOLD
+#define BN_RADIX_FORMAT_THRESHOLD 64
+#endif
+#ifndef BN_RADIX_PARSE_THRESHOLD
+#define BN_RADIX_PARSE_THRESHOLD (1 << 20)
+#endif
+BN_TUNABLE std::size_t radixFormatThreshold = BN_RADIX_FORMAT_THRESHOLD;
+BN_TUNABLE std::size_t radixParseThreshold = BN_RADIX_PARSE_THRESHOLD;
+// Numbers with up to this many characters are written to streams through a
+// buffer on the stack.
+constexpr std::size_t streamBufferSize = 128;
+// Numbers with up to this many digits are divided by a single digit in a copy
+// on the stack when converted to strings.
+constexpr std::size_t formatStackDigits = 64;
+//------------------------------------------------------------------------------
+struct Radix
+{
+    explicit Radix(unsigned b);
+
+    unsigned base;
+    // log2(base) if base is a power of two, 0 otherwise.
+    unsigned log2Base;
+    // The largest power of base that fits into a digit and its exponent.
+    digit_t chunkBase;
+    unsigned chunkChars;
+};
+//------------------------------------------------------------------------------
+inline Radix::Radix(unsigned b)
+    : base(b), log2Base(0), chunkBase(static_cast<digit_t>(b)), chunkChars(1)
+{
+    if ((b & (b - 1)) == 0) {
+        log2Base = static_cast<unsigned>(countTrailingZeroes<unsigned>(b));
+    }
+    while (chunkBase <= std::numeric_limits<digit_t>::max() / b) {
+        chunkBase = static_cast<digit_t>(chunkBase * b);
+        ++chunkChars;
+    }
+}
+//------------------------------------------------------------------------------
+inline bool isValidBase(unsigned base)
+{
+    return (base >= 2) && (base <= 36);
+}
+//------------------------------------------------------------------------------
+// Returns the value of a digit character or 36 if c is no digit.
+inline unsigned charToDigit(char c)
+{
+    if ((c >= '0') && (c <= '9')) {
+        return static_cast<unsigned>(c - '0');
+    }
+    if ((c >= 'a') && (c <= 'z')) {
+        return static_cast<unsigned>(c - 'a' + 10);
+    }
+    if ((c >= 'A') && (c <= 'Z')) {
+        return static_cast<unsigned>(c - 'A' + 10);
+    }
+    return 36;
+}
+//------------------------------------------------------------------------------
+inline char digitToChar(unsigned d, bool uppercase)
+{
+    if (d < 10) {
+        return static_cast<char>('0' + d);
+    }
+    return static_cast<char>((uppercase ? 'A' : 'a') + (d - 10));
+}
+//------------------------------------------------------------------------------
+// Returns the prefix for std::showbase and the base selected on a stream.
+inline std::string streamPrefix(const std::ios_base& s, unsigned& base)
+{
+    const std::ios_base::fmtflags flags = s.flags();
+    const bool showbase = (flags & std::ios_base::showbase) != 0;
+    switch (flags & std::ios_base::basefield) {
+    case std::ios_base::hex:
+        base = 16;
+        if (showbase) {
+            return (flags & std::ios_base::uppercase) ? "0X" : "0x";
+        }
+        return std::string();
+    case std::ios_base::oct:
+        base = 8;
+        return showbase ? "0" : std::string();
+    default:
+        base = 10;
+        return std::string();
+    }
+}
+//------------------------------------------------------------------------------
+inline bool isLittleEndianHost() noexcept
+{
+    const std::uint16_t one = 1;
+    unsigned char first;
+    std::memcpy(&first, &one, 1);
+    return first == 1;
+}
+//------------------------------------------------------------------------------
+inline void checkByteLayout(std::size_t len, std::size_t wordSize)
+{
+    if (wordSize == 0) {
+        throw std::invalid_argument("wordSize is 0");
+    }
+    if (len % wordSize != 0) {
+        throw std::invalid_argument("len is not a multiple of wordSize");
+    }
+}
+//------------------------------------------------------------------------------
+// Returns the position of the k-th least significant byte in a representation
+// of len bytes.
+inline std::size_t byteOffset(
+    std::size_t k,
+    std::size_t len,
+    Endianness order,
+    std::size_t wordSize)
+{
+    switch (order) {
+    case Endianness::little:
+        return k;
+    case Endianness::big:
+        return len - 1 - k;
+    default:
+        if (isLittleEndianHost()) {
+            return k;
+        }
+        return k - k % wordSize + (wordSize - 1 - k % wordSize);
+    }
+}
+//------------------------------------------------------------------------------
+#ifndef BN_PARALLEL_MUL_THRESHOLD
+#define BN_PARALLEL_MUL_THRESHOLD (1 << 22)
+#endif
+// Products needing at least this many digit multiplications are split across
+// the threads of the pool.
+BN_TUNABLE std::size_t parallelMulThreshold = BN_PARALLEL_MUL_THRESHOLD;
+#ifndef BN_PARALLEL_RADIX_THRESHOLD
+#define BN_PARALLEL_RADIX_THRESHOLD 4096
+#endif
+// The divide-and-conquer radix conversion converts both halves of numbers with
+// at least this many digits concurrently.
+BN_TUNABLE std::size_t parallelRadixThreshold = BN_PARALLEL_RADIX_THRESHOLD;
+#ifndef BN_PARALLEL_SPLIT_THRESHOLD
+#define BN_PARALLEL_SPLIT_THRESHOLD 256
+#endif
+// Binary splitting evaluates both halves of ranges with at least this many
+// terms concurrently.
+BN_TUNABLE std::size_t parallelSplitThreshold = BN_PARALLEL_SPLIT_THRESHOLD;
+//------------------------------------------------------------------------------
+#ifdef BN_THREADS
+// Waits on a condition variable until pred holds. Since GCC 12, the untimed
+// condition_variable::wait binds to a symbol of libstdc++ 3.4.30, so binaries
+// using it fail to load with older C++ runtimes. Timed waits are inline, and
+// the timeout is long enough that idle threads do not wake up periodically.
+template<typename Pred>
+void waitUntil(
+    std::condition_variable& cv,
+    std::unique_lock<std::mutex>& lock,
+    Pred pred)
+{
+    while (!pred()) {
+        cv.wait_for(lock, std::chrono::hours(1));
+    }
+}
+#endif
+//------------------------------------------------------------------------------
+// A work-stealing scheduler for fork/join parallelism. Every worker owns a
+// deque of tasks: it pushes the tasks it forks to the back and pops them from
+// the back again, while idle workers steal from the front, so the large
+// subproblems near the root of a recursion are handed out first. Threads that
+// are not workers submit their tasks through a shared queue. A thread waiting
+// for its tasks executes pending tasks instead of blocking, so nested forks
+// never deadlock, and sleeps while there is nothing to execute.
+class ThreadPool final
+{
+public:
+    static ThreadPool& instance();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    // Returns the number of threads including the calling thread.
+    std::size_t size() const noexcept;
+    // Must not be called while tasks are running.
+    void resize(std::size_t n);
+
+    // Calls f(i) for i from 0 to count - 1 and waits for all calls to finish.
+    // The calls for i > 0 are forked while the calling thread runs f(0). All
+    // calls run inline on the calling thread if the pool has one thread or if
+    // the calling thread is a worker whose deque already holds enough tasks to
+    // keep the other threads busy. The first exception thrown by a call is
+    // rethrown.
+    void run(std::size_t count, const std::function<void(std::size_t)>& f);
+
+private:
+    ThreadPool() noexcept;
+
+#ifdef BN_THREADS
+    struct Join
+    {
+        std::atomic<std::size_t> pending;
+        std::mutex mutex;
+        std::exception_ptr error;
+    };
+
+    struct Task
+    {
+        const std::function<void(std::size_t)>* f;
+        std::size_t index;
+        Join* join;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // Returns the index of the queue of the calling thread, which is 0 for
+    // threads that are not workers.
+    static std::size_t& queueIndex() noexcept;
+    bool pop(std::size_t q, Task& task);
+    void call(
+        const std::function<void(std::size_t)>& f, std::size_t i, Join& join);
+    void work(std::size_t q);
+    void stop();
+
+private:
+    std::vector<std::thread> workers;
+    // queues[0] is shared by all threads that are not workers and queues[q]
+    // is owned by worker q.
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::atomic<std::size_t> queued;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping;
+#endif
+    std::atomic<std::size_t> threads;
+};
+//------------------------------------------------------------------------------
+inline ThreadPool& ThreadPool::instance()
+{
+    static ThreadPool pool;
+    return pool;
+}
+//------------------------------------------------------------------------------
+#ifdef BN_THREADS
+inline ThreadPool::ThreadPool() noexcept
+    : queued(0), stopping(false), threads(1)
+{
+}
+//------------------------------------------------------------------------------
+inline ThreadPool::~ThreadPool()
+{
+    stop();
+}
+//------------------------------------------------------------------------------
+inline std::size_t ThreadPool::size() const noexcept
+{
+    return threads.load(std::memory_order_relaxed);
+}
+//------------------------------------------------------------------------------
+inline void ThreadPool::resize(std::size_t n)
+{
+    if (n == 0) {
+        n = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+    stop();
+    stopping = false;
+    queues.clear();
+    for (std::size_t q = 0; q < n; ++q) {
+        queues.push_back(std::unique_ptr<Queue>(new Queue));
+    }
+    for (std::size_t q = 1; q < n; ++q) {
+        workers.emplace_back(&ThreadPool::work, this, q);
+    }
+    threads.store(n, std::memory_order_relaxed);
+}
+//------------------------------------------------------------------------------
+inline void ThreadPool::run(
+    std::size_t count,
+    const std::function<void(std::size_t)>& f)
+{
+    const std::size_t q = queueIndex();
+    bool serial = (count < 2) || workers.empty();
+    if (!serial && (q != 0)) {
+        std::lock_guard<std::mutex> lock(queues[q]->mutex);
+        serial = queues[q]->tasks.size() >= threads.load();
+    }
+    if (serial) {
+        for (std::size_t i = 0; i < count; ++i) {
+            f(i);
+        }
+        return;
+    }
+    Join join;
+    join.pending.store(count - 1);
+    {
+        // Pushed in reverse, so the owner continues with f(1) while thieves
+        // take the last tasks.
+        std::lock_guard<std::mutex> lock(queues[q]->mutex);
+        for (std::size_t i = count - 1; i > 0; --i) {
+            queues[q]->tasks.push_back(Task{&f, i, &join});
+        }
+    }
+    queued.fetch_add(count - 1);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+    }
+    wake.notify_all();
+    try {
+        f(0);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(join.mutex);
+        join.error = std::current_exception();
+    }
+    while (join.pending.load(std::memory_order_acquire) != 0) {
+        Task task;
+        if (pop(q, task)) {
+            call(*task.f, task.index, *task.join);
+            continue;
+        }
+        // The tasks of join run on other threads. Sleep until they finish or
+        // new tasks can be stolen.
+        std::unique_lock<std::mutex> lock(mutex);
+        waitUntil(wake, lock, [this, &join] {
+            return (join.pending.load(std::memory_order_acquire) == 0)
+                || (queued.load() != 0);
+        });
+    }
+    if (join.error) {
+        std::rethrow_exception(join.error);
+    }
+}
+//------------------------------------------------------------------------------
+inline std::size_t& ThreadPool::queueIndex() noexcept
+{
+    static thread_local std::size_t q = 0;
+    return q;
+}
+//------------------------------------------------------------------------------
+inline bool ThreadPool::pop(std::size_t q, Task& task)
+{
+    if (queued.load() == 0) {
+        return false;
+    }
+    if (q != 0) {
+        std::lock_guard<std::mutex> lock(queues[q]->mutex);
+        if (!queues[q]->tasks.empty()) {
+            task = queues[q]->tasks.back();
+            queues[q]->tasks.pop_back();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    for (std::size_t k = 0; k < queues.size(); ++k) {
+        // Start stealing at the next queue to spread the thieves.
+        const std::size_t victim = (q + 1 + k) % queues.size();
+        if (victim == q && q != 0) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(queues[victim]->mutex);
+        if (!queues[victim]->tasks.empty()) {
+            task = queues[victim]->tasks.front();
+            queues[victim]->tasks.pop_front();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+inline void ThreadPool::call(
+    const std::function<void(std::size_t)>& f, std::size_t i, Join& join)
+{
+    try {
+        f(i);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(join.mutex);
+        if (!join.error) {
+            join.error = std::current_exception();
+        }
+    }
+    // The joining thread may return as soon as pending reaches 0, so join must
+    // not be accessed afterwards. Notifying under the mutex guarantees that a
+    // joining thread that saw pending tasks is already waiting.
+    if (join.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+        }
+        wake.notify_all();
+    }
+}
+//------------------------------------------------------------------------------
+inline void ThreadPool::work(std::size_t q)
+{
+    queueIndex() = q;
+    while (true) {
+        Task task;
+        if (pop(q, task)) {
+            call(*task.f, task.index, *task.join);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        waitUntil(wake, lock, [this] {
+            return stopping || (queued.load() != 0);
+        });
+        if (stopping) {
+            return;
+        }
+    }
+}
+//------------------------------------------------------------------------------
+inline void ThreadPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : workers) {
+        t.join();
+    }
+    workers.clear();
+    threads.store(1, std::memory_order_relaxed);
+}
+#else
+//------------------------------------------------------------------------------
+inline ThreadPool::ThreadPool() noexcept : threads(1)
+{
+}
+//------------------------------------------------------------------------------
+inline ThreadPool::~ThreadPool()
+{
+}
+//------------------------------------------------------------------------------
+inline std::size_t ThreadPool::size() const noexcept
+{
+    return 1;
+}
+//------------------------------------------------------------------------------
+inline void ThreadPool::resize(std::size_t)
+{
+}
+//------------------------------------------------------------------------------
+inline void ThreadPool::run(
+    std::size_t count,
+    const std::function<void(std::size_t)>& f)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        f(i);
+    }
+}
+#endif
+//------------------------------------------------------------------------------
+}  // namespace impl
+//------------------------------------------------------------------------------
+inline void setThreadCount(std::size_t n)
+{
+    impl::ThreadPool::instance().resize(n);
+}
+//------------------------------------------------------------------------------
+inline std::size_t threadCount()
+{
+    return impl::ThreadPool::instance().size();
+}
+//------------------------------------------------------------------------------
+namespace impl {
+//------------------------------------------------------------------------------
+#ifndef BN_CACHE_LIMIT
+#define BN_CACHE_LIMIT (1 << 26)
+#endif
+// Default upper bound for the memory in bytes used by the process-wide caches.
+constexpr std::size_t cacheLimit = BN_CACHE_LIMIT;
+// The number of characters of chunkBase^(2^i) does not fit into a size_t for
+// larger i.
+constexpr std::size_t radixCacheLevels = 64;
+//------------------------------------------------------------------------------
+// Process-wide tables of the powers chunkBase^(2^i) of every base, used by the
+// divide-and-conquer radix conversion. A table only grows at its end and a new
+// level is published by incrementing the level count, so cached levels are
+// read without locking. New levels are computed by the callers without holding
+// the lock, so their multiplications may use the thread pool.
+class RadixCache final
+{
+public:
+    static RadixCache& instance();
+
+    RadixCache(const RadixCache&) = delete;
+    RadixCache& operator=(const RadixCache&) = delete;
+
+    // Returns level i of the table of radix or nullptr if it is not cached.
+    const Unsigned* find(const Radix& radix, std::size_t i) const noexcept;
+    // Stores p as level i of the table of radix if i is the next level and p
+    // fits into the memory limit. Returns the cached level i or nullptr if it
+    // is not cached, in which case p is left untouched.
+    const Unsigned*
+        insert(const Radix& radix, std::size_t i, std::unique_ptr<Unsigned>& p);
+
+    std::size_t memory() const noexcept;
+    std::size_t limit() const noexcept;
+    void setLimit(std::size_t bytes) noexcept;
+    // Must not be called while other threads use the cache.
+    void clear();
+
+private:
+    RadixCache() noexcept;
+
+    struct Table
+    {
+        std::atomic<std::size_t> count;
+        std::unique_ptr<Unsigned> levels[radixCacheLevels];
+    };
+
+private:
+    Table tables[37];
+    std::atomic<std::size_t> bytes;
+    std::atomic<std::size_t> maxBytes;
+    std::mutex mutex;
+};
+//------------------------------------------------------------------------------
+// The powers chunkBase^(2^i) used by one conversion. They are taken from the
+// RadixCache, and powers that do not fit into the cache are owned locally.
+class RadixPowers final
+{
+public:
+    explicit RadixPowers(const Radix& radix);
+
+    std::size_t size() const noexcept;
+    const Unsigned& operator[](std::size_t i) const noexcept;
+    const Unsigned& back() const noexcept;
+    // Appends the square of the last power.
+    void extend();
+
+private:
+    Radix radix;
+    std::size_t count;
+    const Unsigned* pows[radixCacheLevels];
+    std::vector<std::unique_ptr<Unsigned>> local;
+};
+//------------------------------------------------------------------------------
+inline RadixCache& RadixCache::instance()
+{
+    static RadixCache cache;
+    return cache;
+}
+//------------------------------------------------------------------------------
+inline RadixCache::RadixCache() noexcept : bytes(0), maxBytes(cacheLimit)
+{
+    for (Table& t : tables) {
+        t.count.store(0);
+    }
+}
+//------------------------------------------------------------------------------
+inline const Unsigned*
+    RadixCache::find(const Radix& radix, std::size_t i) const noexcept
+{
+    const Table& t = tables[radix.base];
+    if (i < t.count.load(std::memory_order_acquire)) {
+        return t.levels[i].get();
+    }
+    return nullptr;
+}
+//------------------------------------------------------------------------------
+inline const Unsigned* RadixCache::insert(
+    const Radix& radix,
+    std::size_t i,
+    std::unique_ptr<Unsigned>& p)
+{
+    Table& t = tables[radix.base];
+    std::lock_guard<std::mutex> lock(mutex);
+    const std::size_t count = t.count.load(std::memory_order_relaxed);
+    if (i < count) {
+        // Another thread was faster.
+        return t.levels[i].get();
+    }
+    const std::size_t b = sizeof(Unsigned) + p->digits() * sizeof(digit_t);
+    if ((i > count) || (i >= radixCacheLevels)
+        || (bytes.load() + b > maxBytes.load())) {
+        return nullptr;
+    }
+    t.levels[i] = std::move(p);
+    bytes.fetch_add(b);
+    t.count.store(i + 1, std::memory_order_release);
+    return t.levels[i].get();
+}
+//------------------------------------------------------------------------------
+inline std::size_t RadixCache::memory() const noexcept
+{
+    return bytes.load();
+}
+//------------------------------------------------------------------------------
+inline std::size_t RadixCache::limit() const noexcept
+{
+    return maxBytes.load();
+}
+//------------------------------------------------------------------------------
+inline void RadixCache::setLimit(std::size_t n) noexcept
+{
+    maxBytes.store(n);
+}
+//------------------------------------------------------------------------------
+inline void RadixCache::clear()
+{
+    for (Table& t : tables) {
+        const std::size_t count = t.count.load();
+        t.count.store(0);
+        for (std::size_t i = 0; i < count; ++i) {
+            t.levels[i].reset();
+        }
+    }
+    bytes.store(0);
+}
+//------------------------------------------------------------------------------
+inline RadixPowers::RadixPowers(const Radix& r) : radix(r), count(0)
+{
+    extend();
+}
+//------------------------------------------------------------------------------
+inline std::size_t RadixPowers::size() const noexcept
+{
+    return count;
+}
+//------------------------------------------------------------------------------
+inline const Unsigned& RadixPowers::operator[](std::size_t i) const noexcept
+{
+    return *pows[i];
+}
+//------------------------------------------------------------------------------
+inline const Unsigned& RadixPowers::back() const noexcept
+{
+    return *pows[count - 1];
+}
+//------------------------------------------------------------------------------
+inline void RadixPowers::extend()
+{
+    RadixCache& cache = RadixCache::instance();
+    const Unsigned* p = cache.find(radix, count);
+    if (p == nullptr) {
+        std::unique_ptr<Unsigned> sq(
+            new Unsigned((count == 0) ? Unsigned(radix.chunkBase)
+                                      : back() * back()));
+        p = cache.insert(radix, count, sq);
+        if (p == nullptr) {
+            local.push_back(std::move(sq));
+            p = local.back().get();
+        }
+    }
+    pows[count++] = p;
+}
+//------------------------------------------------------------------------------
+}  // namespace impl
+//------------------------------------------------------------------------------
+inline void prewarmCaches(std::size_t numChars, unsigned base)
+{
+    if (!impl::isValidBase(base)) {
+        throw std::invalid_argument("invalid base");
+    }
+    const impl::Radix radix(base);
+    if (radix.log2Base != 0) {
+        return;
+    }
+    // Same levels as computed when parsing a string of numChars characters.
+    impl::RadixPowers pows(radix);
+    while ((static_cast<std::size_t>(radix.chunkChars) << pows.size())
+           < numChars) {
+        pows.extend();
+    }
+}
+//------------------------------------------------------------------------------
+inline void setCacheLimit(std::size_t bytes)
+{
+    impl::RadixCache::instance().setLimit(bytes);
+}
+//------------------------------------------------------------------------------
+inline std::size_t cacheLimit()
+{
+    return impl::RadixCache::instance().limit();
+}
+//------------------------------------------------------------------------------
+inline std::size_t cacheMemory()
+{
+    return impl::RadixCache::instance().memory();
+}
+//------------------------------------------------------------------------------
+inline void clearCaches()
+{
+    impl::RadixCache::instance().clear();
+}
+//------------------------------------------------------------------------------
+inline Unsigned::Unsigned() noexcept
+{
+}
+//------------------------------------------------------------------------------
+inline Unsigned::Unsigned(const Unsigned& other) : digit(other.digit)
+{
+}
+//------------------------------------------------------------------------------
+inline Unsigned::Unsigned(Unsigned&& other) noexcept
+    : digit(std::move(other.digit))
+{
+}
+//------------------------------------------------------------------------------
+inline Unsigned::Unsigned(std::int32_t i)
+{
+    if (i < 0) {
+        throw std::invalid_argument("i is negative");
+    }
+    initFromIntegral(static_cast<std::uint32_t>(i));
+}
+//------------------------------------------------------------------------------
+inline Unsigned::Unsigned(std::uint32_t i)
+{
+    initFromIntegral(i);
+}
+//------------------------------------------------------------------------------
+inline Unsigned::Unsigned(std::int64_t i)
+{
+    if (i < 0) {
+        throw std::invalid_argument("i is negative");
+    }
+    initFromIntegral(static_cast<std::uint64_t>(i));
+}
+//------------------------------------------------------------------------------
+inline Unsigned::Unsigned(std::uint64_t i)
+{
+    initFromIntegral(i);
+}
+//------------------------------------------------------------------------------
+template<
+    typename T,
+    typename std::enable_if<EnableUserDefinedIntegral<T>::value, bool>::type>
+Unsigned::Unsigned(T i)
+{
+    initFromIntegral(i);
+}
+//------------------------------------------------------------------------------
+inline Unsigned::Unsigned(const char* dec)
+{
+    if (*dec == '\0') {
+        throw std::invalid_argument("dec is empty");
+    }
+    if (!parse(dec, dec + std::strlen(dec), 10, *this)) {
+        throw std::invalid_argument("invalid digit in string");
+    }
+}
+//------------------------------------------------------------------------------
+inline Unsigned::Unsigned(UnsignedView v)
+{
+    const std::size_t n = v.digits();
+    digit.resize(n);
+    if (n != 0) {
+        std::copy(v.data(), v.data() + n, &digit[0]);
+    }
+}
+//------------------------------------------------------------------------------
+inline Unsigned& Unsigned::operator=(const Unsigned& other)
+{
+    digit = other.digit;
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Unsigned& Unsigned::operator=(Unsigned&& other) noexcept
+{
+    digit = std::move(other.digit);
+    return *this;
+}
+//------------------------------------------------------------------------------
+template<typename Generator>
+Unsigned Unsigned::random(std::size_t numBits, Generator& gen)
+{
+    if (numBits == 0) {
+        return Unsigned();
+    }
+    return generateRandom<impl::bitsPerDigit>(numBits, gen);
+}
+//------------------------------------------------------------------------------
+inline Unsigned Unsigned::fromString(const std::string& s, unsigned base)
+{
+    if (!impl::isValidBase(base)) {
+        throw std::invalid_argument("invalid base");
+    }
+    if (s.empty()) {
+        throw std::invalid_argument("s is empty");
+    }
+    Unsigned u;
+    if (!parse(s.data(), s.data() + s.size(), base, u)) {
+        throw std::invalid_argument("invalid digit in string");
+    }
+    return u;
+}
+//------------------------------------------------------------------------------
+inline Unsigned Unsigned::fromBytes(
+    const void* data,
+    std::size_t len,
+    Endianness order,
+    std::size_t wordSize)
+{
+    impl::checkByteLayout(len, wordSize);
+    const unsigned char* src = static_cast<const unsigned char*>(data);
+    const std::size_t bpd = sizeof(impl::digit_t);
+    Unsigned u;
+    const std::size_t n = (len + bpd - 1) / bpd;
+    if (n == 0) {
+        return u;
+    }
+    u.digit.resize(n);
+    u.digit[n - 1] = 0;
+    // The bytes of the digit array are in little endian order.
+    const bool le = impl::isLittleEndianHost() || (bpd == 1);
+    const bool native = impl::isLittleEndianHost() || (wordSize == bpd);
+    if ((order == Endianness::native) && native) {
+        // Matches the digit array on little endian platforms or for digit
+        // sized words. Other native words are reordered by byteOffset.
+        std::memcpy(&u.digit[0], src, len);
+    } else if (le) {
+        unsigned char* dst = reinterpret_cast<unsigned char*>(&u.digit[0]);
+        if (order == Endianness::little) {
+            std::memcpy(dst, src, len);
+        } else {
+            for (std::size_t k = 0; k < len; ++k) {
+                dst[k] = src[impl::byteOffset(k, len, order, wordSize)];
+            }
+        }
+    } else {
+        std::memset(&u.digit[0], 0, n * bpd);
+        for (std::size_t k = 0; k < len; ++k) {
+            const impl::digit_t b =
+                src[impl::byteOffset(k, len, order, wordSize)];
+            const std::size_t shift = 8 * (k % bpd);
+            u.digit[k / bpd] |= static_cast<impl::digit_t>(b << shift);
+        }
+    }
+    u.removeLeadingZeroDigits();
+    return u;
+}
+//------------------------------------------------------------------------------
+inline Unsigned& Unsigned::operator++()
+{
+    addDigit(1);
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Unsigned Unsigned::operator++(int)
+{
+    Unsigned ret = *this;
+    ++(*this);
+    return ret;
+}
+//------------------------------------------------------------------------------
+inline Unsigned& Unsigned::operator--()
+{
+    subtractDigit(1);
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Unsigned Unsigned::operator--(int)
+{
+    Unsigned ret = *this;
+    --(*this);
+    return ret;
+}
+//------------------------------------------------------------------------------
+inline Unsigned& Unsigned::operator|=(const Unsigned& v)
+{
+    const std::size_t n = digit.size();
+    const std::size_t m = v.digit.size();
+    if (n < m) {
+        digit.resize(m);
+        for (std::size_t i = 0; i < n; ++i) {
+            digit[i] |= v.digit[i];
+        }
+        for (std::size_t i = n; i < m; ++i) {
+            digit[i] = v.digit[i];
+        }
+    } else {
+        for (std::size_t i = 0; i < m; ++i) {
+            digit[i] |= v.digit[i];
+        }
+    }
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Unsigned& Unsigned::operator&=(const Unsigned& v)
+{
+    const std::size_t n = std::min(digit.size(), v.digit.size());
+    digit.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        digit[i] &= v.digit[i];
+    }
+    removeLeadingZeroDigits();
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Unsigned& Unsigned::operator^=(const Unsigned& v)
+{
+    const std::size_t n = digit.size();
+    const std::size_t m = v.digit.size();
+    if (n < m) {
+        digit.resize(m);
+        for (std::size_t i = 0; i < n; ++i) {
+            digit[i] ^= v.digit[i];
+        }
+        for (std::size_t i = n; i < m; ++i) {
+            digit[i] = v.digit[i];
+        }
+    } else {
+        for (std::size_t i = 0; i < m; ++i) {
+            digit[i] ^= v.digit[i];
+        }
+    }
+    removeLeadingZeroDigits();
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Unsigned& Unsigned::operator<<=(std::size_t s)
+{
+    if (s == 0) {
+        return *this;
+    }
+    const std::size_t n = digit.size();
+    if (n == 0) {
+        return *this;
+    }
+    const std::size_t ds = s / impl::bitsPerDigit;
+    const std::size_t lbs = s % impl::bitsPerDigit;
+    if (lbs == 0) {
+        digit.resize(n + ds);
+        for (size_t i = 0; i < n; ++i) {
+            digit[i + ds] = digit[i];
+        }
+        for (size_t i = 0; i < ds; ++i) {
+            digit[i] = 0;
+        }
+        return *this;
+    }
+    const std::size_t rbs = impl::bitsPerDigit - lbs;
+    const std::size_t lz = countLeadingZeroes();
+    if (lbs > lz) {
+        digit.resize(n + ds + 1);
+        digit[n + ds] = digit[n - 1] >> rbs;
+    } else {
+        digit.resize(n + ds);
+    }
+    for (std::size_t i = 0; i < n - 1; ++i) {
+        digit[ds + n - i - 1] =
+            (digit[n - i - 1] << lbs) | (digit[n - i - 2] >> rbs);
+    }
+    digit[ds] = digit[0] << lbs;
+    for (std::size_t i = 0; i < ds; ++i) {
+        digit[i] = 0;
+    }
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Unsigned& Unsigned::operator>>=(std::size_t s)
+{
+    if (s == 0) {
+        return *this;
+    }
+    const std::size_t n = digit.size();
+    if (n == 0) {
+        return *this;
+    }
+    const std::size_t lz = countLeadingZeroes();
+    const std::size_t nb = n * impl::bitsPerDigit - lz;
+    if (s >= nb) {
+        digit.resize(0);
+        return *this;
+    }
+    const std::size_t ds = s / impl::bitsPerDigit;
+    const std::size_t rbs = s % impl::bitsPerDigit;
+    if (rbs == 0) {
+        const std::size_t m = n - ds;
+        for (std::size_t i = 0; i < m; ++i) {
+            digit[i] = digit[ds + i];
+        }
+        digit.resize(m);
+        return *this;
+    }
+    const std::size_t lbs = impl::bitsPerDigit - rbs;
+    const std::size_t m = (nb - s - 1) / impl::bitsPerDigit + 1;
+    for (std::size_t i = 0; i < n - ds - 1; ++i) {
+        digit[i] = (digit[i + ds] >> rbs) | (digit[i + ds + 1] << lbs);
+    }
+    if (lz < lbs) {
+        digit[n - ds - 1] = digit[n - 1] >> rbs;
+    }
+    digit.resize(m);
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Unsigned& Unsigned::operator+=(const Unsigned& v)
+{
+    add(*this, *this, v);
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Unsigned& Unsigned::operator-=(const Unsigned& v)
+{
+    sub(*this, *this, v);
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Unsigned& Unsigned::operator*=(const Unsigned& v)
+{
+    Unsigned w = *this * v;
+    *this = std::move(w);
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Unsigned& Unsigned::operator/=(const Unsigned& v)
+{
+    Unsigned w = *this / v;
+    *this = std::move(w);
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Unsigned& Unsigned::operator%=(const Unsigned& v)
+{
+    Unsigned w = *this % v;
+    *this = std::move(w);
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Unsigned Unsigned::div(const Unsigned& v)
+{
+    Unsigned::QR qr = ::bn::div(*this, v);
+    *this = std::move(qr.quot);
+    return qr.rem;
+}
+//------------------------------------------------------------------------------
+inline bool Unsigned::empty() const
+{
+    return digit.size() == 0;
+}
+//------------------------------------------------------------------------------
+inline std::size_t Unsigned::bits() const
+{
+    return impl::bitsPerDigit * digit.size() - countLeadingZeroes();
+}
+//------------------------------------------------------------------------------
+inline std::size_t Unsigned::ctz() const
+{
+    std::size_t ret = 0;
+    std::size_t i = 0;
+    while ((i < digit.size()) && (digit[i] == 0)) {
+        ret += impl::bitsPerDigit;
+        ++i;
+    }
+    if (i < digit.size()) {
+        ret += impl::countTrailingZeroes(digit[i]);
+    }
+    return ret;
+}
+//------------------------------------------------------------------------------
+inline Unsigned::operator std::uint64_t() const
+{
+    if (bits() > 64) {
+        throw std::overflow_error("this does not fit in a uint64_t");
+    }
+    const std::size_t n = digit.size();
+    std::uint64_t ret = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        ret |= static_cast<uint64_t>(digit[i]) << (i * impl::bitsPerDigit);
+    }
+    return ret;
+}
+//------------------------------------------------------------------------------
+inline std::string Unsigned::str() const
+{
+    return str(10);
+}
+//------------------------------------------------------------------------------
+inline std::string Unsigned::str(unsigned base, bool uppercase) const
+{
+    if (!impl::isValidBase(base)) {
+        throw std::invalid_argument("invalid base");
+    }
+    std::string s(maxChars(bits(), base), '0');
+    char* last = &s[0] + s.size();
+    char* first = format(last, base, uppercase);
+    s.erase(0, static_cast<std::size_t>(first - &s[0]));
+    return s;
+}
+//------------------------------------------------------------------------------
+inline void Unsigned::toBytes(
+    void* data,
+    std::size_t len,
+    Endianness order,
+    std::size_t wordSize) const
+{
+    impl::checkByteLayout(len, wordSize);
+    const std::size_t needed = (bits() + 7) / 8;
+    if (needed > len) {
+        throw std::overflow_error("number does not fit into buffer");
+    }
+    unsigned char* dst = static_cast<unsigned char*>(data);
+    const std::size_t bpd = sizeof(impl::digit_t);
+    // The bytes of the digit array are in little endian order.
+    const bool le = impl::isLittleEndianHost() || (bpd == 1);
+    const bool native = impl::isLittleEndianHost() || (wordSize == bpd);
+    if ((order == Endianness::native) && native) {
+        // Matches the digit array on little endian platforms or for digit
+        // sized words. Other native words are reordered by byteOffset.
+        const std::size_t n =
+            impl::isLittleEndianHost() ? needed : digit.size() * bpd;
+        if (n != 0) {
+            std::memcpy(dst, &digit[0], n);
+        }
+        if (len != n) {
+            std::memset(dst + n, 0, len - n);
+        }
+    } else if (le && (order == Endianness::little)) {
+        if (needed != 0) {
+            std::memcpy(dst, &digit[0], needed);
+        }
+        if (len != needed) {
+            std::memset(dst + needed, 0, len - needed);
+        }
+    } else {
+        for (std::size_t k = 0; k < len; ++k) {
+            unsigned char b = 0;
+            if (k < needed) {
+                const std::size_t shift = 8 * (k % bpd);
+                b = static_cast<unsigned char>(digit[k / bpd] >> shift);
+            }
+            dst[impl::byteOffset(k, len, order, wordSize)] = b;
+        }
+    }
+}
+//------------------------------------------------------------------------------
+inline std::vector<std::uint8_t>
+    Unsigned::toBytes(Endianness order, std::size_t wordSize) const
+{
+    if (wordSize == 0) {
+        throw std::invalid_argument("wordSize is 0");
+    }
+    const std::size_t words = ((bits() + 7) / 8 + wordSize - 1) / wordSize;
+    std::vector<std::uint8_t> bytes(words * wordSize);
+    if (!bytes.empty()) {
+        toBytes(bytes.data(), bytes.size(), order, wordSize);
+    }
+    return bytes;
+}
+//------------------------------------------------------------------------------
+inline std::size_t Unsigned::digits() const
+{
+    return digit.size();
+}
+//------------------------------------------------------------------------------
+template<int S, typename T>
+typename std::enable_if<S >= 8 * sizeof(T), T>::type Unsigned::safeRightShift(T)
+{
+    return 0;
+}
+//------------------------------------------------------------------------------
+template<int S, typename T>
+    typename std::enable_if
+    < S<8 * sizeof(T), T>::type Unsigned::safeRightShift(T val)
+{
+    return val >> S;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+void Unsigned::initFromIntegral(T val)
+{
+    const std::size_t n =
+        std::max<std::size_t>(sizeof(val) / sizeof(impl::digit_t), 1);
+    digit.resize(n);
+    std::size_t i = 0;
+    for (; val != 0; ++i, val = safeRightShift<impl::bitsPerDigit>(val)) {
+        digit[i] = static_cast<impl::digit_t>(val);
+    }
+    digit.resize(i);
+}
+//------------------------------------------------------------------------------
+template<std::size_t BPD, typename Generator>
+typename std::enable_if<(BPD < 8 * sizeof(unsigned)), Unsigned>::type
+    Unsigned::generateRandom(std::size_t numBits, Generator& gen)
+{
+    static_assert(
+        (8 * sizeof(unsigned)) % BPD == 0,
+        "bitsPerDigit must divide 8*sizeof(unsigned)");
+    Unsigned w;
+    const std::size_t n = (numBits - 1) / BPD + 1;
+    w.digit.resize(n);
+    unsigned r;
+    std::size_t rbits = 0;
+    std::uniform_int_distribution<unsigned> dis;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (rbits == 0) {
+            r = dis(gen);
+            rbits = 8 * sizeof(unsigned);
+        }
+        w.digit[i] = static_cast<impl::digit_t>(r);
+        r >>= BPD;
+        rbits -= BPD;
+    }
+    w.randomGenMaskHighest(numBits % BPD);
+    w.removeLeadingZeroDigits();
+    return w;
+}
+//------------------------------------------------------------------------------
+template<std::size_t BPD, typename Generator>
+typename std::enable_if<(BPD == 8 * sizeof(unsigned)), Unsigned>::type
+    Unsigned::generateRandom(std::size_t numBits, Generator& gen)
+{
+    Unsigned w;
+    const std::size_t n = (numBits - 1) / BPD + 1;
+    w.digit.resize(n);
+    std::uniform_int_distribution<unsigned> dis;
+    for (std::size_t i = 0; i < n; ++i) {
+        w.digit[i] = dis(gen);
+    }
+    w.randomGenMaskHighest(numBits % BPD);
+    w.removeLeadingZeroDigits();
+    return w;
+}
+//------------------------------------------------------------------------------
+template<std::size_t BPD, typename Generator>
+typename std::enable_if<(BPD > 8 * sizeof(unsigned)), Unsigned>::type
+    Unsigned::generateRandom(std::size_t numBits, Generator& gen)
+{
+    static_assert(
+        BPD % (8 * sizeof(unsigned)) == 0,
+        "8*sizeof(unsigned) must divide bitsPerDigit");
+    Unsigned w;
+    const std::size_t n = (numBits - 1) / BPD + 1;
+    w.digit.resize(n);
+    std::uniform_int_distribution<unsigned> dis;
+    for (std::size_t i = 0; i < n; ++i) {
+        w.digit[i] = dis(gen);
+        for (std::size_t j = 1; j < BPD / (8 * sizeof(unsigned)); ++j) {
+            w.digit[i] = (w.digit[i] << (8 * sizeof(unsigned))) | dis(gen);
+        }
+    }
+    w.randomGenMaskHighest(numBits % BPD);
+    w.removeLeadingZeroDigits();
+    return w;
+}
+//------------------------------------------------------------------------------
+inline void Unsigned::randomGenMaskHighest(std::size_t mb)
+{
+    if (mb == 0) {
+        return;
+    }
+    impl::digit_t mask = 1;
+    for (std::size_t i = 1; i < mb; ++i) {
+        mask = (mask << 1) | 1;
+    }
+    const std::size_t n = digit.size();
+    digit[n - 1] &= mask;
+    removeLeadingZeroDigits();
+}
+//------------------------------------------------------------------------------
+inline std::size_t Unsigned::countLeadingZeroes() const
+{
+    const std::size_t n = digit.size();
+    if (n == 0) {
+        return 0;
+    }
+    return ::bn::impl::countLeadingZeroes(digit[n - 1]);
+}
+//------------------------------------------------------------------------------
+inline std::size_t Unsigned::maxChars(std::size_t numBits, unsigned base)
+{
+    if (numBits == 0) {
+        return 1;
+    }
+    const impl::Radix radix(base);
+    if (radix.log2Base != 0) {
+        return (numBits - 1) / radix.log2Base + 1;
+    }
+    // The number of bits of a character is at least floor(log2(base)).
+    const std::size_t minBitsPerChar = 8 * sizeof(unsigned) - 1
+                                     - impl::countLeadingZeroes(radix.base);
+    return numBits / minBitsPerChar + 1;
+}
+//------------------------------------------------------------------------------
+inline char* Unsigned::format(char* last, unsigned base, bool uppercase) const
+{
+    const impl::OperationScope scope(Operation::format, digit.size());
+    const impl::Radix radix(base);
+    if (digit.size() == 0) {
+        *--last = '0';
+        return last;
+    }
+    if (radix.log2Base != 0) {
+        return formatPow2(last, radix.log2Base, uppercase);
+    }
+    impl::RadixPowers pows(radix);
+    std::size_t levels = 1;
+    if (digit.size() > impl::radixFormatThreshold) {
+        // pows[i] is chunkBase^(2^i), used as long as pows[i] <= *this.
+        const std::size_t nb = bits();
+        while (2 * pows[levels - 1].bits() - 2 < nb) {
+            if (pows.size() == levels) {
+                pows.extend();
+            }
+            if (*this < pows[levels]) {
+                break;
+            }
+            ++levels;
+        }
+    }
+    return formatRecursive(*this, levels, pows, last, radix, uppercase, false);
+}
+//------------------------------------------------------------------------------
+inline char*
+    Unsigned::formatPow2(char* last, unsigned log2Base, bool uppercase) const
+{
+    const std::size_t n = (bits() - 1) / log2Base + 1;
+    const impl::digit_t mask =
+        static_cast<impl::digit_t>((1u << log2Base) - 1);
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t b = i * log2Base;
+        const std::size_t d = b / impl::bitsPerDigit;
+        const std::size_t off = b % impl::bitsPerDigit;
+        impl::digit_t val = digit[d] >> off;
+        if ((off + log2Base > impl::bitsPerDigit) && (d + 1 < digit.size())) {
+            val |= digit[d + 1] << (impl::bitsPerDigit - off);
+        }
+        *--last = impl::digitToChar(val & mask, uppercase);
+    }
+    return last;
+}
+//------------------------------------------------------------------------------
+inline char* Unsigned::formatRecursive(
+    const Unsigned& u,
+    std::size_t level,
+    const impl::RadixPowers& pows,
+    char* last,
+    const impl::Radix& radix,
+    bool uppercase,
+    bool pad)
+{
+    // u is less than chunkBase^(2^level). If pad is set, the number is padded
+    // with zeros to chunkChars*2^level characters.
+    if (!pad) {
+        while ((level > 0) && (u < pows[level - 1])) {
+            --level;
+        }
+    }
+    if ((level == 0) || (u.digit.size() <= impl::radixFormatThreshold)) {
+        std::size_t n = u.digit.size();
+        impl::digit_t stack[impl::formatStackDigits];
+        std::vector<impl::digit_t> heap;
+        impl::digit_t* temp = stack;
+        if (n > impl::formatStackDigits) {
+            heap.resize(n);
+            temp = heap.data();
+        }
+        if (n != 0) {
+            std::copy(&u.digit[0], &u.digit[0] + n, temp);
+        }
+        char* first = last;
+        while (n != 0) {
+            impl::digit_t rem = 0;
+            for (std::size_t i = n; i != 0; --i) {
+                temp[i - 1] =
+                    impl::divideRemainder(temp[i - 1], radix.chunkBase, rem);
+            }
+            if (temp[n - 1] == 0) {
+                --n;
+            }
+            for (unsigned i = 0;
+                 (i < radix.chunkChars) && ((n != 0) || (rem != 0));
+                 ++i) {
+                *--first = impl::digitToChar(rem % radix.base, uppercase);
+                rem /= radix.base;
+            }
+        }
+        if (pad) {
+            const std::size_t width =
+                static_cast<std::size_t>(radix.chunkChars) << level;
+            char* stop = last - width;
+            while (first != stop) {
+                *--first = '0';
+            }
+        }
+        return first;
+    }
+    Unsigned::QR qr = ::bn::div(u, pows[level - 1]);
+    // The remainder is padded to a fixed width, so both halves can be written
+    // independently.
+    char* mid =
+        last - (static_cast<std::size_t>(radix.chunkChars) << (level - 1));
+    char* first = nullptr;
+    auto half = [&](std::size_t i) {
+        if (i == 0) {
+            formatRecursive(
+                qr.rem, level - 1, pows, last, radix, uppercase, true);
+        } else {
+            first = formatRecursive(
+                qr.quot, level - 1, pows, mid, radix, uppercase, pad);
+        }
+    };
+    if (u.digit.size() >= impl::parallelRadixThreshold) {
+        impl::ThreadPool::instance().run(2, half);
+    } else {
+        half(0);
+        half(1);
+    }
+    return first;
+}
+//------------------------------------------------------------------------------
+inline bool Unsigned::parse(
+    const char* first,
+    const char* last,
+    unsigned base,
+    Unsigned& u)
+{
+    // The size of the result, rounding the bits per character up.
+    const std::size_t bitsPerChar =
+        8 * sizeof(unsigned) - impl::countLeadingZeroes(base - 1);
+    const impl::OperationScope scope(
+        Operation::parse,
+        (static_cast<std::size_t>(last - first) * bitsPerChar
+         + impl::bitsPerDigit - 1)
+            / impl::bitsPerDigit);
+    const impl::Radix radix(base);
+    if (radix.log2Base != 0) {
+        return parsePow2(first, last, radix.log2Base, u);
+    }
+    impl::RadixPowers pows(radix);
+    // pows[i] is chunkBase^(2^i), used as long as it has less characters than
+    // the string.
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n > impl::radixParseThreshold * radix.chunkChars) {
+        const std::size_t chunkChars = radix.chunkChars;
+        while ((chunkChars << pows.size()) < n) {
+            pows.extend();
+        }
+    }
+    return parseRecursive(first, last, pows, radix, u);
+}
+//------------------------------------------------------------------------------
+inline bool Unsigned::parsePow2(
+    const char* first,
+    const char* last,
+    unsigned log2Base,
+    Unsigned& u)
+{
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    const std::size_t numDigits =
+        (n * log2Base + impl::bitsPerDigit - 1) / impl::bitsPerDigit;
+    u.digit.resize(numDigits);
+    for (std::size_t i = 0; i < numDigits; ++i) {
+        u.digit[i] = 0;
+    }
+    std::size_t b = 0;
+    for (const char* curr = last; curr != first; b += log2Base) {
+        const impl::digit_t val = impl::charToDigit(*--curr);
+        if (val >= (1u << log2Base)) {
+            return false;
+        }
+        const std::size_t d = b / impl::bitsPerDigit;
+        const std::size_t off = b % impl::bitsPerDigit;
+        u.digit[d] |= static_cast<impl::digit_t>(val << off);
+        if (off + log2Base > impl::bitsPerDigit) {
+            u.digit[d + 1] |= val >> (impl::bitsPerDigit - off);
+        }
+    }
+    u.removeLeadingZeroDigits();
+    return true;
+}
+//------------------------------------------------------------------------------
+inline bool Unsigned::parseRecursive(
+    const char* first,
+    const char* last,
+    const impl::RadixPowers& pows,
+    const impl::Radix& radix,
+    Unsigned& u)
+{
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    const std::size_t chunkChars = radix.chunkChars;
+    std::size_t level = pows.size();
+    while ((level > 0) && ((chunkChars << (level - 1)) >= n)) {
+        --level;
+    }
+    if ((level == 0) || (n <= impl::radixParseThreshold * chunkChars)) {
+        u = Unsigned();
+        while (first != last) {
+            const std::size_t count = std::min<std::size_t>(
+                radix.chunkChars, static_cast<std::size_t>(last - first));
+            impl::digit_t mul = 1;
+            impl::digit_t add = 0;
+            for (std::size_t i = 0; i < count; ++i, ++first) {
+                const unsigned val = impl::charToDigit(*first);
+                if (val >= radix.base) {
+                    return false;
+                }
+                mul = static_cast<impl::digit_t>(mul * radix.base);
+                add = static_cast<impl::digit_t>(add * radix.base + val);
+            }
+            u.multiplyByDigit(mul);
+            u.addDigit(add);
+        }
+        return true;
+    }
+    // Split off the lowest chunkChars*2^(level-1) characters.
+    const char* mid = last - (chunkChars << (level - 1));
+    Unsigned low;
+    bool ok[2];
+    auto half = [&](std::size_t i) {
+        ok[i] = (i == 0) ? parseRecursive(first, mid, pows, radix, u)
+                         : parseRecursive(mid, last, pows, radix, low);
+    };
+    if (n >= impl::parallelRadixThreshold * chunkChars) {
+        impl::ThreadPool::instance().run(2, half);
+    } else {
+        half(0);
+        if (!ok[0]) {
+            return false;
+        }
+        half(1);
+    }
+    if (!ok[0] || !ok[1]) {
+        return false;
+    }
+    u *= pows[level - 1];
+    u += low;
+    return true;
+}
+//------------------------------------------------------------------------------
+inline void Unsigned::addDigit(impl::digit_t d)
+{
+    const std::size_t n = digit.size();
+    if (n == 0) {
+        if (d != 0) {
+            digit.resize(1);
+            digit[0] = d;
+        }
+        return;
+    }
+    bool carry = false;
+    digit[0] = impl::addCarry(digit[0], d, carry);
+    for (std::size_t i = 1; (i < n) && carry; ++i) {
+        digit[i] = impl::addCarry(digit[i], 0, carry);
+    }
+    if (carry) {
+        digit.resize(n + 1);
+        digit[n] = 1;
+    }
+}
+//------------------------------------------------------------------------------
+inline void Unsigned::subtractDigit(impl::digit_t d)
+{
+    const std::size_t n = digit.size();
+    if ((n == 0) || ((n == 1) && (d > digit[0]))) {
+        throw std::logic_error("result would be negative");
+    }
+    bool borrow = false;
+    digit[0] = impl::subBorrow(digit[0], d, borrow);
+    for (std::size_t i = 1; (i < n) && borrow; ++i) {
+        digit[i] = impl::subBorrow(digit[i], 0, borrow);
+    }
+    removeLeadingZeroDigits();
+}
+//------------------------------------------------------------------------------
+inline void Unsigned::multiplyByDigit(impl::digit_t d)
+{
+    const std::size_t n = digit.size();
+    impl::digit_t carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        digit[i] = impl::multiplyAdd(digit[i], d, carry);
+    }
+    if (carry != 0) {
+        digit.resize(n + 1);
+        digit[n] = carry;
+    }
+}
+//------------------------------------------------------------------------------
+inline impl::digit_t Unsigned::divideByDigitReturnRem(impl::digit_t d)
+{
+    assert(d != 0);
+    if (d == 1) {
+        return 0;
+    }
+    const std::size_t n = digit.size();
+    impl::digit_t remainder = 0;
+    for (std::size_t i = n; i != 0; --i) {
+        digit[i - 1] = impl::divideRemainder(digit[i - 1], d, remainder);
+    }
+    if (digit[n - 1] == 0) {
+        digit.setSize(n - 1);
+    }
+    return remainder;
+}
+//------------------------------------------------------------------------------
+inline impl::digit_t Unsigned::remainderByDigit(impl::digit_t d) const
+{
+    assert(d != 0);
+    impl::digit_t remainder = 0;
+    for (std::size_t i = digit.size(); i != 0; --i) {
+        impl::divideRemainder(digit[i - 1], d, remainder);
+    }
+    return remainder;
+}
+//------------------------------------------------------------------------------
+inline bool Unsigned::isDivisibleByOddDigit(impl::digit_t d) const
+{
+    assert(d & 1);
+    // After step i, q*d = u mod base^(i+1) + c*base^(i+1) for the (unstored)
+    // quotient digits q. Since c < d and d is coprime to the base, d divides u
+    // exactly if c ends up 0.
+    const impl::digit_t inv = impl::inverseDigit(d);
+    impl::digit_t c = 0;
+    for (std::size_t i = 0; i < digit.size(); ++i) {
+        bool borrow = false;
+        const impl::digit_t s = impl::subBorrow(digit[i], c, borrow);
+        impl::digit_t hi = 0;
+        const impl::digit_t q = impl::multiplyAdd(s, inv, hi);
+        hi = 0;
+        impl::multiplyAdd(q, d, hi);
+        c = hi + borrow;
+    }
+    return c == 0;
+}
+//------------------------------------------------------------------------------
+inline bool Unsigned::isDivisibleByOdd(const Unsigned& v) const
+{
+    assert(v.digit[0] & 1);
+    const std::size_t n = v.digits();
+    const std::size_t len = digits();
+    if (len < n) {
+        return empty();
+    }
+
+    // Clears w from the lowest digit upwards. If v divides w, the quotient has
+    // at most len - n + 1 digits and nothing remains, otherwise the rest is
+    // negative or not 0.
+    Unsigned w = *this;
+    const impl::digit_t inv = impl::inverseDigit(v.digit[0]);
+    for (std::size_t i = 0; i + n <= len; ++i) {
+        impl::digit_t carry = 0;
+        const impl::digit_t qd = impl::multiplyAdd(w.digit[i], inv, carry);
+        carry = 0;
+        bool borrow = false;
+        for (std::size_t j = 0; j < n; ++j) {
+            const impl::digit_t p = impl::multiplyAdd(qd, v.digit[j], carry);
+            w.digit[i + j] = impl::subBorrow(w.digit[i + j], p, borrow);
+        }
+        for (std::size_t j = i + n; (j < len) && (carry || borrow); ++j) {
+            w.digit[j] = impl::subBorrow(w.digit[j], carry, borrow);
+            carry = 0;
+        }
+        if (carry || borrow) {
+            return false;
+        }
+    }
+    for (std::size_t i = len - n + 1; i < len; ++i) {
+        if (w.digit[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+inline impl::digit_t Unsigned::findDivQuotient(
+    impl::digit_t un,
+    impl::digit_t un1,
+    impl::digit_t un2,
+    impl::digit_t vn1,
+    impl::digit_t vn2)
+{
+    assert(vn1 & (static_cast<impl::digit_t>(1) << (impl::bitsPerDigit - 1)));
+
+    if (un < vn1) {
+        impl::digit_t r = un;
+        impl::digit_t q = impl::divideRemainder(un1, vn1, r);
+
+        impl::digit_t carry = 0;
+        impl::digit_t p1 = impl::multiplyAdd(q, vn2, carry);
+        if ((carry < r) || ((carry == r) && (p1 <= un2))) {
+            return q;
+        }
+
+        bool acarry = false;
+        r = impl::addCarry(r, vn1, acarry);
+        if (acarry) {
+            return q - 1;
+        }
+
+        bool borrow = false;
+        p1 = impl::subBorrow(p1, vn2, borrow);
+        carry -= borrow;
+        if ((carry < r) || ((carry == r) && (p1 <= un2))) {
+            return q - 1;
+        }
+        return q - 2;
+    }
+
+    bool borrow = false;
+    un1 = impl::subBorrow(un1, vn1, borrow);
+    un -= borrow;
+    if (un < vn1) {
+        impl::digit_t r = un;
+        impl::digit_t q = impl::divideRemainder(un1, vn1, r);
+
+        bool acarry = false;
+        r = impl::addCarry(r, vn1, acarry);
+        if (acarry) {
+            return q;
+        }
+
+        impl::digit_t carry = 0;
+        impl::digit_t p1 = impl::multiplyAdd(q, vn2, carry);
+        if ((carry < r) || ((carry == r) && (p1 <= un2))) {
+            return q;
+        }
+        return q - 1;
+    }
+
+    un1 -= vn1;
+    impl::digit_t r = un - 1;
+    impl::digit_t q = impl::divideRemainder(un1, vn1, r);
+    return q;
+}
+//------------------------------------------------------------------------------
+inline impl::digit_t Unsigned::findDivQuotient(
+    const Unsigned& u,
+    std::size_t ls,
+    impl::digit_t vn1,
+    impl::digit_t vn2,
+    std::size_t i)
+{
+    assert(u.digit.size() >= 3);
+    assert(i < u.digit.size());
+    if (ls == 0) {
+        return findDivQuotient(
+            u.digit[i], u.digit[i - 1], u.digit[i - 2], vn1, vn2);
+    }
+    const std::size_t rs = impl::bitsPerDigit - ls;
+    impl::digit_t un = (u.digit[i] << ls) | (u.digit[i - 1] >> rs);
+    impl::digit_t un1 = (u.digit[i - 1] << ls) | (u.digit[i - 2] >> rs);
+    impl::digit_t un2 = (u.digit[i - 2] << ls);
+    if ((i - 2) > 0) {
+        un2 |= u.digit[i - 3] >> rs;
+    }
+    return findDivQuotient(un, un1, un2, vn1, vn2);
+}
+//------------------------------------------------------------------------------
+inline void Unsigned::assign(UnsignedView u)
+{
+    const std::size_t n = u.digits();
+    const bool same = (digit.size() > 0) && (&digit[0] == u.data());
+    digit.setSize(n);
+    if (!same && (n > 0)) {
+        std::copy(u.data(), u.data() + n, &digit[0]);
+    }
+}
+//------------------------------------------------------------------------------
+inline void Unsigned::removeLeadingZeroDigits(bool keepCapacity)
+{
+    std::size_t n = digit.size();
+    while ((n > 0) && (digit[n - 1] == 0)) {
+        --n;
+    }
+    if (keepCapacity) {
+        digit.setSize(n);
+    } else {
+        digit.resize(n);
+    }
+}
+//------------------------------------------------------------------------------
+inline void
+    Unsigned::divide(UnsignedView u, UnsignedView v, Unsigned& q, Unsigned& r)
+{
+    const std::size_t n = v.digits();
+    if (n == 0) {
+        throw std::invalid_argument("division by 0");
+    }
+    // u is read completely before q is written, so it may refer to q or r.
+    if (n > u.digits()) {
+        r.assign(u);
+        q.digit.setSize(0);
+        return;
+    }
+    if (n == 1) {
+        q.assign(u);
+        const impl::digit_t rem = q.divideByDigitReturnRem(v[0]);
+        r.digit.setSize(1);
+        r.digit[0] = rem;
+        r.removeLeadingZeroDigits(true);
+        return;
+    }
+    const std::size_t m = u.digits() - n;
+
+    // D1
+    const std::size_t ls = impl::countLeadingZeroes(v[n - 1]);
+    impl::digit_t vn1;
+    impl::digit_t vn2;
+    if (ls == 0) {
+        vn1 = v[n - 1];
+        vn2 = v[n - 2];
+    } else {
+        const std::size_t rs = impl::bitsPerDigit - ls;
+        vn1 = (v[n - 1] << ls) | (v[n - 2] >> rs);
+        vn2 = (v[n - 2] << ls);
+        if (n > 2) {
+            vn2 |= v[n - 3] >> rs;
+        }
+    }
+    // The normalized dividend is computed in place of the remainder.
+    Unsigned& nu = r;
+    const std::size_t un = u.digits();
+    nu.assign(u);
+    nu.digit.setSize(un + 1);
+    nu.digit[un] = 0;
+    q.digit.setSize(m + 1);
+
+    // D2
+    std::size_t j = m;
+    while (true) {
+        // D3
+        impl::digit_t qd = Unsigned::findDivQuotient(nu, ls, vn1, vn2, j + n);
+        // D4
+        impl::digit_t carry = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            impl::digit_t md = impl::multiplyAdd(qd, v[i], carry);
+            bool borrow = false;
+            nu.digit[i + j] = impl::subBorrow(nu.digit[j + i], md, borrow);
+            carry += borrow;
+        }
+        bool borrow = false;
+        nu.digit[j + n] = impl::subBorrow(nu.digit[j + n], carry, borrow);
+        // D5
+        q.digit[j] = qd;
+        if (borrow) {
+            // D6
+            --q.digit[j];
+            bool acarry = false;
+            for (std::size_t i = 0; i < n; ++i) {
+                nu.digit[j + i] = impl::addCarry(nu.digit[j + i], v[i], acarry);
+            }
+            nu.digit[j + n] += acarry;
+        }
+        // D7
+        if (j == 0) {
+            break;
+        }
+        --j;
+    }
+    // D8
+    nu.removeLeadingZeroDigits(true);
+    q.removeLeadingZeroDigits(true);
+}
+//------------------------------------------------------------------------------
+inline void Unsigned::multiply(UnsignedView u, UnsignedView v, Unsigned& w)
+{
+    const std::size_t n = u.digits();
+    const std::size_t m = v.digits();
+    const std::size_t nm = n + m;
+    w.digit.setSize(nm);
+    for (std::size_t i = 0; i < nm; ++i) {
+        w.digit[i] = 0;
+    }
+    for (std::size_t i = 0; i < m; ++i) {
+        impl::digit_t carry = 0;
+        for (std::size_t j = 0; j < n; ++j) {
+            w.digit[i + j] =
+                impl::multiplyAdd2(u[j], v[i], w.digit[i + j], carry);
+        }
+        w.digit[i + n] += carry;
+    }
+    w.removeLeadingZeroDigits(true);
+}
+//------------------------------------------------------------------------------
+inline void Unsigned::multiplyLow(
+    UnsignedView u,
+    UnsignedView v,
+    std::size_t n,
+    Unsigned& w)
+{
+    const std::size_t un = std::min(u.digits(), n);
+    const std::size_t vn = std::min(v.digits(), n);
+    const std::size_t len = std::min(un + vn, n);
+    w.digit.setSize(len);
+    for (std::size_t i = 0; i < len; ++i) {
+        w.digit[i] = 0;
+    }
+    // Row i only needs the digits of u that end up below digit len.
+    for (std::size_t i = 0; i < vn; ++i) {
+        const std::size_t end = std::min(un, len - i);
+        impl::digit_t carry = 0;
+        for (std::size_t j = 0; j < end; ++j) {
+            w.digit[i + j] =
+                impl::multiplyAdd2(u[j], v[i], w.digit[i + j], carry);
+        }
+        if (i + end < len) {
+            w.digit[i + end] += carry;
+        }
+    }
+    w.removeLeadingZeroDigits(true);
+}
+//------------------------------------------------------------------------------
+inline void Unsigned::multiplyHigh(
+    UnsignedView u,
+    UnsignedView v,
+    std::size_t n,
+    Unsigned& w)
+{
+    const std::size_t un = u.digits();
+    const std::size_t vn = v.digits();
+    if ((un == 0) || (vn == 0) || (un + vn <= n)) {
+        w.digit.setSize(0);
+        return;
+    }
+
+    // Column n - 1 is summed as well, so that its carry into column n is
+    // exact, and dropped afterwards.
+    const std::size_t first = (n == 0) ? 0 : n - 1;
+    const std::size_t len = un + vn - first;
+    w.digit.setSize(len);
+    for (std::size_t i = 0; i < len; ++i) {
+        w.digit[i] = 0;
+    }
+    for (std::size_t i = 0; i < vn; ++i) {
+        const std::size_t begin = (first > i) ? first - i : 0;
+        if (begin >= un) {
+            continue;
+        }
+        impl::digit_t carry = 0;
+        for (std::size_t j = begin; j < un; ++j) {
+            w.digit[i + j - first] =
+                impl::multiplyAdd2(u[j], v[i], w.digit[i + j - first], carry);
+        }
+        w.digit[i + un - first] += carry;
+    }
+    if (n != 0) {
+        for (std::size_t i = 1; i < len; ++i) {
+            w.digit[i - 1] = w.digit[i];
+        }
+        w.digit[len - 1] = 0;
+    }
+    w.removeLeadingZeroDigits(true);
+}
+//------------------------------------------------------------------------------
+inline void
+    Unsigned::multiplyMiddle(UnsignedView u, UnsignedView v, Unsigned& w)
+{
+    assert(u.digits() >= v.digits());
+    const std::size_t vn = v.digits();
+    if (vn == 0) {
+        w.digit.setSize(0);
+        return;
+    }
+
+    // Row j adds v[j] times the n - m + 1 digits of u that fall into the
+    // middle columns. The sum of m rows needs room for the carries of m.
+    const std::size_t cols = u.digits() - vn + 1;
+    std::size_t len = cols + 1;
+    for (std::size_t k = vn; k != 0; k = (k >> (impl::bitsPerDigit - 1)) >> 1) {
+        ++len;
+    }
+    w.digit.setSize(len);
+    for (std::size_t i = 0; i < len; ++i) {
+        w.digit[i] = 0;
+    }
+    for (std::size_t j = 0; j < vn; ++j) {
+        const std::size_t offset = vn - 1 - j;
+        impl::digit_t carry = 0;
+        for (std::size_t i = 0; i < cols; ++i) {
+            w.digit[i] =
+                impl::multiplyAdd2(u[offset + i], v[j], w.digit[i], carry);
+        }
+        bool overflow = false;
+        w.digit[cols] = impl::addCarry(w.digit[cols], carry, overflow);
+        for (std::size_t i = cols + 1; overflow; ++i) {
+            w.digit[i] = impl::addCarry(w.digit[i], 0, overflow);
+        }
+    }
+    w.removeLeadingZeroDigits(true);
+}
+//------------------------------------------------------------------------------
+inline void Unsigned::multiplyAny(UnsignedView u, UnsignedView v, Unsigned& w)
+{
+    if ((u.digits() * v.digits() >= impl::parallelMulThreshold)
+        && (impl::ThreadPool::instance().size() > 1)) {
+        multiplyParallel(u, v, w);
+    } else {
+        multiply(u, v, w);
+    }
+}
+//------------------------------------------------------------------------------
+inline void
+    Unsigned::multiplyParallel(UnsignedView u, UnsignedView v, Unsigned& w)
+{
+    if (u.digits() < v.digits()) {
+        std::swap(u, v);
+    }
+    // Split the longer operand into one chunk per thread, multiply the chunks
+    // concurrently and add the partial products at their offsets.
+    const std::size_t n = u.digits();
+    const std::size_t m = v.digits();
+    const std::size_t threads = impl::ThreadPool::instance().size();
+    const std::size_t len = (n + threads - 1) / threads;
+    const std::size_t chunks = (n + len - 1) / len;
+    std::vector<Unsigned> partial(chunks);
+    impl::ThreadPool::instance().run(chunks, [&](std::size_t i) {
+        const std::size_t first = i * len;
+        const std::size_t count = std::min(len, n - first);
+        multiply(UnsignedView(u.data() + first, count), v, partial[i]);
+    });
+    w.digit.setSize(n + m);
+    for (std::size_t i = 0; i < n + m; ++i) {
+        w.digit[i] = 0;
+    }
+    for (std::size_t c = 0; c < chunks; ++c) {
+        const std::size_t offset = c * len;
+        const Unsigned& p = partial[c];
+        bool carry = false;
+        std::size_t i = 0;
+        for (; i < p.digit.size(); ++i) {
+            w.digit[offset + i] =
+                impl::addCarry(w.digit[offset + i], p.digit[i], carry);
+        }
+        for (i += offset; carry; ++i) {
+            w.digit[i] = impl::addCarry(w.digit[i], 0, carry);
+        }
+    }
+    w.removeLeadingZeroDigits(true);
+}
+//------------------------------------------------------------------------------
+inline bool operator==(const Unsigned& u, const Unsigned& v)
+{
+    return UnsignedView(u) == UnsignedView(v);
+}
+//------------------------------------------------------------------------------
+inline bool operator!=(const Unsigned& u, const Unsigned& v)
+{
+    return !(u == v);
+}
+//------------------------------------------------------------------------------
+inline bool operator<(const Unsigned& u, const Unsigned& v)
+{
+    return UnsignedView(u) < UnsignedView(v);
+}
+//------------------------------------------------------------------------------
+inline bool operator>=(const Unsigned& u, const Unsigned& v)
+{
+    return !(u < v);
+}
+//------------------------------------------------------------------------------
+inline bool operator>(const Unsigned& u, const Unsigned& v)
+{
+    return v < u;
+}
+//------------------------------------------------------------------------------
+inline bool operator<=(const Unsigned& u, const Unsigned& v)
+{
+    return !(v < u);
+}
+//------------------------------------------------------------------------------
+inline Unsigned operator|(const Unsigned& pu, const Unsigned& pv)
+{
+    const Unsigned& u = pu.digit.size() >= pv.digit.size() ? pu : pv;
+    const Unsigned& v = pu.digit.size() >= pv.digit.size() ? pv : pu;
+    const std::size_t n = u.digit.size();
+    const std::size_t m = v.digit.size();
+    Unsigned w;
+    w.digit.resize(n);
+    for (std::size_t i = 0; i < m; ++i) {
+        w.digit[i] = u.digit[i] | v.digit[i];
+    }
+    for (std::size_t i = m; i < n; ++i) {
+        w.digit[i] = u.digit[i];
+    }
+    return w;
+}
+//------------------------------------------------------------------------------
+inline Unsigned operator&(const Unsigned& u, const Unsigned& v)
+{
+    Unsigned w;
+    const std::size_t n = std::min(u.digit.size(), v.digit.size());
+    w.digit.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        w.digit[i] = u.digit[i] & v.digit[i];
+    }
+    w.removeLeadingZeroDigits();
+    return w;
+}
+//------------------------------------------------------------------------------
+inline Unsigned operator^(const Unsigned& pu, const Unsigned& pv)
+{
+    const Unsigned& u = pu.digit.size() >= pv.digit.size() ? pu : pv;
+    const Unsigned& v = pu.digit.size() >= pv.digit.size() ? pv : pu;
+    const std::size_t n = u.digit.size();
+    const std::size_t m = v.digit.size();
+    Unsigned w;
+    w.digit.resize(n);
+    for (std::size_t i = 0; i < m; ++i) {
+        w.digit[i] = u.digit[i] ^ v.digit[i];
+    }
+    for (std::size_t i = m; i < n; ++i) {
+        w.digit[i] = u.digit[i];
+    }
+    w.removeLeadingZeroDigits();
+    return w;
+}
+//------------------------------------------------------------------------------
+inline Unsigned operator<<(const Unsigned& u, std::size_t s)
+{
+    if (s == 0) {
+        return u;
+    }
+    const std::size_t n = u.digit.size();
+    if (n == 0) {
+        return u;
+    }
+    const std::size_t ds = s / impl::bitsPerDigit;
+    const std::size_t lbs = s % impl::bitsPerDigit;
+    Unsigned w;
+    if (lbs == 0) {
+        w.digit.resize(n + ds);
+        for (size_t i = 0; i < n; ++i) {
+            w.digit[i + ds] = u.digit[i];
+        }
+        for (size_t i = 0; i < ds; ++i) {
+            w.digit[i] = 0;
+        }
+        return w;
+    }
+    const std::size_t rbs = impl::bitsPerDigit - lbs;
+    const std::size_t lz = u.countLeadingZeroes();
+    if (lbs > lz) {
+        w.digit.resize(n + ds + 1);
+        w.digit[n + ds] = u.digit[n - 1] >> rbs;
+    } else {
+        w.digit.resize(n + ds);
+    }
+    for (std::size_t i = 0; i < n - 1; ++i) {
+        w.digit[ds + n - i - 1] =
+            (u.digit[n - i - 1] << lbs) | (u.digit[n - i - 2] >> rbs);
+    }
+    w.digit[ds] = u.digit[0] << lbs;
+    for (std::size_t i = 0; i < ds; ++i) {
+        w.digit[i] = 0;
+    }
+    return w;
+}
+//------------------------------------------------------------------------------
+inline Unsigned operator>>(const Unsigned& u, std::size_t s)
+{
+    if (s == 0) {
+        return u;
+    }
+    const std::size_t n = u.digit.size();
+    if (n == 0) {
+        return u;
+    }
+    Unsigned w;
+    const std::size_t lz = u.countLeadingZeroes();
+    const std::size_t nb = n * impl::bitsPerDigit - lz;
+    if (s >= nb) {
+        return w;
+    }
+    const std::size_t ds = s / impl::bitsPerDigit;
+    const std::size_t rbs = s % impl::bitsPerDigit;
+    if (rbs == 0) {
+        const std::size_t m = n - ds;
+        w.digit.resize(m);
+        for (std::size_t i = 0; i < m; ++i) {
+            w.digit[i] = u.digit[ds + i];
+        }
+        return w;
+    }
+    const std::size_t lbs = impl::bitsPerDigit - rbs;
+    const std::size_t m = (nb - s - 1) / impl::bitsPerDigit + 1;
+    w.digit.resize(m);
+    for (std::size_t i = 0; i < n - ds - 1; ++i) {
+        w.digit[i] = (u.digit[i + ds] >> rbs) | (u.digit[i + ds + 1] << lbs);
+    }
+    if (lz < lbs) {
+        w.digit[n - ds - 1] = u.digit[n - 1] >> rbs;
+    }
+    return w;
+}
+//------------------------------------------------------------------------------
+inline Unsigned operator+(const Unsigned& u, const Unsigned& v)
+{
+    return UnsignedView(u) + UnsignedView(v);
+}
+//------------------------------------------------------------------------------
+inline Unsigned operator-(const Unsigned& u, const Unsigned& v)
+{
+    return UnsignedView(u) - UnsignedView(v);
+}
+//------------------------------------------------------------------------------
+inline Unsigned operator*(const Unsigned& u, const Unsigned& v)
+{
+    return UnsignedView(u) * UnsignedView(v);
+}
+//------------------------------------------------------------------------------
+inline Unsigned operator/(const Unsigned& u, const Unsigned& v)
+{
+    return div(u, v).quot;
+}
+//------------------------------------------------------------------------------
+inline Unsigned operator%(const Unsigned& u, const Unsigned& v)
+{
+    return div(u, v).rem;
+}
+//------------------------------------------------------------------------------
+inline Unsigned::QR div(const Unsigned& u, const Unsigned& v)
+{
+    return div(UnsignedView(u), UnsignedView(v));
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Unsigned&> Unsigned::operator+=(T v)
+{
+    const std::uint64_t m = impl::nonNegative(v);
+    if (!impl::fitsInDigit(m)) {
+        return *this += Unsigned(m);
+    }
+    const impl::OperationScope scope(Operation::add, digit.size(), 1);
+    addDigit(static_cast<impl::digit_t>(m));
+    return *this;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Unsigned&> Unsigned::operator-=(T v)
+{
+    const std::uint64_t m = impl::nonNegative(v);
+    if (!impl::fitsInDigit(m)) {
+        return *this -= Unsigned(m);
+    }
+    const impl::OperationScope scope(Operation::subtract, digit.size(), 1);
+    if (m == 0) {
+        return *this;
+    }
+    const std::size_t n = digit.size();
+    if ((n == 0) || ((n == 1) && (m > digit[0]))) {
+        throw std::invalid_argument("minuend is larger than subtrahend");
+    }
+    subtractDigit(static_cast<impl::digit_t>(m));
+    return *this;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Unsigned&> Unsigned::operator*=(T v)
+{
+    const std::uint64_t m = impl::nonNegative(v);
+    if (!impl::fitsInDigit(m)) {
+        return *this *= Unsigned(m);
+    }
+    const impl::OperationScope scope(Operation::multiply, digit.size(), 1);
+    if (m == 0) {
+        digit.resize(0);
+    } else {
+        multiplyByDigit(static_cast<impl::digit_t>(m));
+    }
+    return *this;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Unsigned&> Unsigned::operator/=(T v)
+{
+    const std::uint64_t m = impl::nonNegative(v);
+    if (m == 0) {
+        throw std::invalid_argument("division by 0");
+    }
+    if (!impl::fitsInDigit(m)) {
+        return *this /= Unsigned(m);
+    }
+    const impl::OperationScope scope(Operation::divide, digit.size(), 1);
+    if (digit.size() != 0) {
+        divideByDigitReturnRem(static_cast<impl::digit_t>(m));
+    }
+    return *this;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Unsigned&> Unsigned::operator%=(T v)
+{
+    *this = *this % v;
+    return *this;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Unsigned> operator+(const Unsigned& u, T v)
+{
+    Unsigned w(u);
+    w += v;
+    return w;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Unsigned> operator+(T v, const Unsigned& u)
+{
+    return u + v;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Unsigned> operator-(const Unsigned& u, T v)
+{
+    Unsigned w(u);
+    w -= v;
+    return w;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Unsigned> operator-(T v, const Unsigned& u)
+{
+    return Unsigned(impl::nonNegative(v)) - u;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Unsigned> operator*(const Unsigned& u, T v)
+{
+    Unsigned w(u);
+    w *= v;
+    return w;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Unsigned> operator*(T v, const Unsigned& u)
+{
+    return u * v;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Unsigned> operator/(const Unsigned& u, T v)
+{
+    Unsigned w(u);
+    w /= v;
+    return w;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Unsigned> operator/(T v, const Unsigned& u)
+{
+    return Unsigned(impl::nonNegative(v)) / u;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Unsigned> operator%(const Unsigned& u, T v)
+{
+    const std::uint64_t m = impl::nonNegative(v);
+    if (m == 0) {
+        throw std::invalid_argument("division by 0");
+    }
+    if (!impl::fitsInDigit(m)) {
+        return u % Unsigned(m);
+    }
+    const impl::OperationScope scope(Operation::divide, u.digit.size(), 1);
+    return Unsigned(u.remainderByDigit(static_cast<impl::digit_t>(m)));
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Unsigned> operator%(T v, const Unsigned& u)
+{
+    return Unsigned(impl::nonNegative(v)) % u;
+}
+//------------------------------------------------------------------------------
+namespace impl {
+//------------------------------------------------------------------------------
+// Compares a number with m and returns -1, 0 or 1.
+inline int compare(const Unsigned& u, std::uint64_t m)
+{
+    if (u.bits() > 64) {
+        return 1;
+    }
+    const std::uint64_t w = static_cast<std::uint64_t>(u);
+    return (w > m) - (w < m);
+}
+//------------------------------------------------------------------------------
+}  // namespace impl
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator==(const Unsigned& u, T v)
+{
+    return impl::compare(u, impl::nonNegative(v)) == 0;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator==(T v, const Unsigned& u)
+{
+    return u == v;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator!=(const Unsigned& u, T v)
+{
+    return !(u == v);
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator!=(T v, const Unsigned& u)
+{
+    return !(u == v);
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator<(const Unsigned& u, T v)
+{
+    return impl::compare(u, impl::nonNegative(v)) < 0;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator<(T v, const Unsigned& u)
+{
+    return impl::compare(u, impl::nonNegative(v)) > 0;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator>=(const Unsigned& u, T v)
+{
+    return !(u < v);
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator>=(T v, const Unsigned& u)
+{
+    return !(v < u);
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator>(const Unsigned& u, T v)
+{
+    return v < u;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator>(T v, const Unsigned& u)
+{
+    return u < v;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator<=(const Unsigned& u, T v)
+{
+    return !(v < u);
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator<=(T v, const Unsigned& u)
+{
+    return !(u < v);
+}
+//------------------------------------------------------------------------------
+inline Unsigned pow(const Unsigned& u, std::size_t exp)
+{
+    Unsigned r = 1;
+    Unsigned p = u;
+    while (true) {
+        if (exp & 1) {
+            r *= p;
+        }
+        exp >>= 1;
+        if (exp == 0) {
+            return r;
+        }
+        p *= p;
+    }
+}
+//------------------------------------------------------------------------------
+inline Unsigned powmod(const Unsigned& u, Unsigned exp, const Unsigned& mod)
+{
+    Unsigned r;
+    powmod(r, u, exp, mod);
+    return r;
+}
+//------------------------------------------------------------------------------
+inline Unsigned sqrt(const Unsigned& u)
+{
+    const impl::OperationScope scope(Operation::sqrt, u.digits());
+    if (u.empty()) {
+        return u;
+    }
+    std::size_t shift = (u.bits() - 1) & ~static_cast<std::size_t>(1);
+    Unsigned bit = 1;
+    bit <<= shift;
+
+    Unsigned r;
+    Unsigned n = u;
+    while (bit != 0) {
+        if (n >= r + bit) {
+            n -= r;
+            n -= bit;
+            r >>= 1;
+            r += bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return r;
+}
+//------------------------------------------------------------------------------
+inline Unsigned egcd(const Unsigned& u, const Unsigned& v)
+{
+    const impl::OperationScope scope(Operation::gcd, u.digits(), v.digits());
+    const bool vlte = (v <= u);
+    Unsigned a = vlte ? u : v;
+    Unsigned b = vlte ? v : u;
+    Unsigned zero;
+    while (!b.empty()) {
+        Unsigned c = a % b;
+        a = std::move(b);
+        b = std::move(c);
+    }
+    return a;
+}
+//------------------------------------------------------------------------------
+inline Unsigned bgcd(const Unsigned& u, const Unsigned& v)
+{
+    const impl::OperationScope scope(Operation::gcd, u.digits(), v.digits());
+    if (u.empty()) {
+        return v;
+    }
+    if (v.empty()) {
+        return u;
+    }
+
+    Unsigned wu = u;
+    Unsigned wv = v;
+    std::size_t utz = wu.ctz();
+    std::size_t vtz = wv.ctz();
+    std::size_t shift = std::min(utz, vtz);
+    wu >>= utz;
+    wv >>= shift;
+    do {
+        vtz = wv.ctz();
+        wv >>= vtz;
+        if (wu > wv) {
+            std::swap(wu, wv);
+        }
+        wv -= wu;
+    } while (wv != 0);
+    return wu << shift;
+}
+//------------------------------------------------------------------------------
+inline Unsigned gcd(const Unsigned& u, const Unsigned& v)
+{
+    return bgcd(u, v);
+}
+//------------------------------------------------------------------------------
+inline Unsigned divexact(const Unsigned& u, const Unsigned& d)
+{
+    const impl::OperationScope scope(Operation::divide, u.digits(), d.digits());
+    if (d.empty()) {
+        throw std::invalid_argument("division by 0");
+    }
+    if (u.digits() < d.digits()) {
+        return Unsigned();
+    }
+
+    // Removing the trailing zero bits of the divisor from both numbers makes
+    // the lowest divisor digit odd and thus invertible modulo the base.
+    const std::size_t tz = d.ctz();
+    Unsigned w = u >> tz;
+    const Unsigned v = d >> tz;
+    const std::size_t n = v.digits();
+    if (w.digits() < n) {
+        return Unsigned();
+    }
+
+    // Each step chooses the quotient digit that clears the lowest remaining
+    // digit of w and subtracts its multiple of v. Digits above the quotient
+    // length do not influence the quotient and are never updated.
+    const std::size_t m = w.digits() - n + 1;
+    const impl::digit_t inv = impl::inverseDigit(v.digit[0]);
+    Unsigned q;
+    q.digit.resize(m);
+    for (std::size_t i = 0; i < m; ++i) {
+        impl::digit_t carry = 0;
+        const impl::digit_t qd = impl::multiplyAdd(w.digit[i], inv, carry);
+        q.digit[i] = qd;
+        const std::size_t end = std::min(n, m - i);
+        carry = 0;
+        bool borrow = false;
+        for (std::size_t j = 0; j < end; ++j) {
+            const impl::digit_t p = impl::multiplyAdd(qd, v.digit[j], carry);
+            w.digit[i + j] = impl::subBorrow(w.digit[i + j], p, borrow);
+        }
+        for (std::size_t j = i + end; (j < m) && (carry || borrow); ++j) {
+            w.digit[j] = impl::subBorrow(w.digit[j], carry, borrow);
+            carry = 0;
+        }
+    }
+    q.removeLeadingZeroDigits();
+    return q;
+}
+//------------------------------------------------------------------------------
+inline void add(Unsigned& w, const Unsigned& u, const Unsigned& v)
+{
+    const impl::OperationScope scope(
+        Operation::add, u.digits(), v.digits());
+    const Unsigned& a = (u.digits() >= v.digits()) ? u : v;
+    const Unsigned& b = (u.digits() >= v.digits()) ? v : u;
+    const std::size_t n = a.digits();
+    const std::size_t m = b.digits();
+    // Growing w keeps its digits, so a and b stay valid if w is one of them.
+    w.digit.setSize(n + 1);
+    bool carry = false;
+    for (std::size_t i = 0; i < m; ++i) {
+        w.digit[i] = impl::addCarry(a.digit[i], b.digit[i], carry);
+    }
+    std::size_t i;
+    for (i = m; (i < n) && carry; ++i) {
+        w.digit[i] = impl::addCarry(a.digit[i], 0, carry);
+    }
+    if (&w != &a) {
+        for (; i < n; ++i) {
+            w.digit[i] = a.digit[i];
+        }
+    }
+    if (carry) {
+        w.digit[n] = 1;
+    } else {
+        w.digit.setSize(n);
+    }
+}
+//------------------------------------------------------------------------------
+inline void sub(Unsigned& w, const Unsigned& u, const Unsigned& v)
+{
+    const impl::OperationScope scope(
+        Operation::subtract, u.digits(), v.digits());
+    const std::size_t n = u.digits();
+    const std::size_t m = v.digits();
+    if (m > n) {
+        throw std::invalid_argument("minuend is larger than subtrahend");
+    }
+    w.digit.setSize(n);
+    bool borrow = false;
+    for (std::size_t i = 0; i < m; ++i) {
+        w.digit[i] = impl::subBorrow(u.digit[i], v.digit[i], borrow);
+    }
+    std::size_t i;
+    for (i = m; (i < n) && borrow; ++i) {
+        w.digit[i] = impl::subBorrow(u.digit[i], 0, borrow);
+    }
+    if (&w != &u) {
+        for (; i < n; ++i) {
+            w.digit[i] = u.digit[i];
+        }
+    }
+    if (borrow) {
+        throw std::invalid_argument("minuend is larger than subtrahend");
+    }
+    w.removeLeadingZeroDigits(true);
+}
+//------------------------------------------------------------------------------
+inline void mul(Unsigned& w, const Unsigned& u, const Unsigned& v)
+{
+    if ((&w == &u) || (&w == &v)) {
+        Unsigned t;
+        mul(t, u, v);
+        w = std::move(t);
+        return;
+    }
+    const impl::OperationScope scope(
+        Operation::multiply, u.digits(), v.digits());
+    Unsigned::multiplyAny(u, v, w);
+}
+//------------------------------------------------------------------------------
+inline void
+    divQR(Unsigned& q, Unsigned& r, const Unsigned& u, const Unsigned& v)
+{
+    if (&q == &r) {
+        throw std::invalid_argument(
+            "quotient and remainder must be different numbers");
+    }
+    if ((&v == &q) || (&v == &r)) {
+        const Unsigned t(v);
+        divQR(q, r, u, t);
+        return;
+    }
+    const impl::OperationScope scope(
+        Operation::divide, u.digits(), v.digits());
+    Unsigned::divide(u, v, q, r);
+}
+//------------------------------------------------------------------------------
+inline void powmod(
+    Unsigned& w,
+    const Unsigned& u,
+    const Unsigned& exp,
+    const Unsigned& mod)
+{
+    PowmodScratch scratch;
+    powmod(w, u, exp, mod, scratch);
+}
+//------------------------------------------------------------------------------
+inline void powmod(
+    Unsigned& w,
+    const Unsigned& u,
+    const Unsigned& exp,
+    const Unsigned& mod,
+    PowmodScratch& scratch)
+{
+    if ((&w == &exp) || (&w == &mod)) {
+        Unsigned t;
+        powmod(t, u, exp, mod, scratch);
+        w = std::move(t);
+        return;
+    }
+    const impl::OperationScope scope(
+        Operation::powmod, u.digits(), exp.digits(), mod.digits());
+    const std::size_t bits = exp.bits();
+    if (bits == 0) {
+        w.digit.setSize(1);
+        w.digit[0] = 1;
+        return;
+    }
+    Unsigned& p = scratch.power;
+    Unsigned& t = scratch.product;
+    Unsigned& q = scratch.quotient;
+    divQR(q, p, u, mod);
+    w.digit.setSize(1);
+    w.digit[0] = 1;
+    for (std::size_t i = 0; i < bits; ++i) {
+        const std::size_t d = i / impl::bitsPerDigit;
+        if ((exp.digit[d] >> (i % impl::bitsPerDigit)) & 1) {
+            mul(t, w, p);
+            divQR(q, w, t, mod);
+        }
+        if (i + 1 < bits) {
+            mul(t, p, p);
+            divQR(q, p, t, mod);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+inline std::size_t maxChars(const Unsigned& u, unsigned base)
+{
+    if (!impl::isValidBase(base)) {
+        return 0;
+    }
+    return Unsigned::maxChars(u.bits(), base);
+}
+//------------------------------------------------------------------------------
+inline ToCharsResult
+    to_chars(char* first, char* last, const Unsigned& u, unsigned base)
+{
+    if (!impl::isValidBase(base)) {
+        return ToCharsResult{last, std::errc::invalid_argument};
+    }
+    const std::size_t size = static_cast<std::size_t>(last - first);
+    const std::size_t bound = Unsigned::maxChars(u.bits(), base);
+    if (size >= bound) {
+        // Write right-aligned within the bound and move to the front.
+        char* end = first + bound;
+        char* begin = u.format(end, base, false);
+        const std::size_t n = static_cast<std::size_t>(end - begin);
+        std::memmove(first, begin, n);
+        return ToCharsResult{first + n, std::errc()};
+    }
+    // The bound is exact for powers of two. Otherwise, a character holds less
+    // than ceil(log2(base)) bits, which gives a lower bound.
+    const std::size_t bitsPerChar =
+        8 * sizeof(unsigned) - impl::countLeadingZeroes(base - 1);
+    if (((base & (base - 1)) == 0)
+        || (size < (u.bits() - 1) / bitsPerChar + 1)) {
+        return ToCharsResult{last, std::errc::value_too_large};
+    }
+    // Formats into a buffer of the bound to find the exact length, on the
+    // stack for small numbers.
+    char stack[impl::streamBufferSize];
+    std::string heap;
+    char* end = stack + impl::streamBufferSize;
+    if (bound > impl::streamBufferSize) {
+        heap.resize(bound);
+        end = &heap[0] + bound;
+    }
+    const char* begin = u.format(end, base, false);
+    const std::size_t n = static_cast<std::size_t>(end - begin);
+    if (n > size) {
+        return ToCharsResult{last, std::errc::value_too_large};
+    }
+    std::memcpy(first, begin, n);
+    return ToCharsResult{first + n, std::errc()};
+}
+//------------------------------------------------------------------------------
+inline FromCharsResult
+    from_chars(const char* first, const char* last, Unsigned& u, unsigned base)
+{
+    if (!impl::isValidBase(base)) {
+        return FromCharsResult{first, std::errc::invalid_argument};
+    }
+    const char* end = first;
+    while ((end != last) && (impl::charToDigit(*end) < base)) {
+        ++end;
+    }
+    if (end == first) {
+        return FromCharsResult{first, std::errc::invalid_argument};
+    }
+    Unsigned::parse(first, end, base, u);
+    return FromCharsResult{end, std::errc()};
+}
+//------------------------------------------------------------------------------
+namespace impl {
+//------------------------------------------------------------------------------
+inline std::ostream& writeToStream(
+    std::ostream& os,
+    const std::string& prefix,
+    const Unsigned& u,
+    unsigned base,
+    bool uppercase)
+{
+    if ((os.width() != 0) || (maxChars(u, base) > streamBufferSize)) {
+        return os << prefix + u.str(base, uppercase);
+    }
+    char buf[streamBufferSize];
+    const char* end = to_chars(buf, buf + streamBufferSize, u, base).ptr;
+    if (uppercase) {
+        for (char* c = buf; c != end; ++c) {
+            *c = static_cast<char>(std::toupper(*c));
+        }
+    }
+    os.write(prefix.data(), static_cast<std::streamsize>(prefix.size()));
+    return os.write(buf, end - buf);
+}
+//------------------------------------------------------------------------------
+}  // namespace impl
+//------------------------------------------------------------------------------
+inline std::ostream& operator<<(std::ostream& os, const Unsigned& u)
+{
+    unsigned base;
+    std::string prefix = impl::streamPrefix(os, base);
+    if (u.empty()) {
+        prefix.clear();
+    }
+    const bool uppercase = (os.flags() & std::ios_base::uppercase) != 0;
+    return impl::writeToStream(os, prefix, u, base, uppercase);
+}
+//------------------------------------------------------------------------------
+inline std::ostream& operator<<(std::ostream& out, const Unsigned::QR& qr)
+{
+    out << "(q=" << qr.quot << " r=" << qr.rem << ")";
+    return out;
+}
+//------------------------------------------------------------------------------
+inline bool operator==(const Unsigned::QR& qr1, const Unsigned::QR& qr2)
+{
+    return (qr1.quot == qr2.quot) && (qr1.rem == qr2.rem);
+}
+//------------------------------------------------------------------------------
+inline bool operator!=(const Unsigned::QR& qr1, const Unsigned::QR& qr2)
+{
+    return !(qr1 == qr2);
+}
+//------------------------------------------------------------------------------
+inline UnsignedView::UnsignedView() noexcept : ptr(nullptr), sz(0)
+{
+}
+//------------------------------------------------------------------------------
+inline UnsignedView::UnsignedView(
+    const impl::digit_t* data,
+    std::size_t size) noexcept
+    : ptr(data), sz(size)
+{
+    while ((sz > 0) && (ptr[sz - 1] == 0)) {
+        --sz;
+    }
+}
+//------------------------------------------------------------------------------
+inline UnsignedView::UnsignedView(const Unsigned& u) noexcept
+    : ptr(u.digit.size() ? &u.digit[0] : nullptr), sz(u.digit.size())
+{
+}
+//------------------------------------------------------------------------------
+inline const impl::digit_t* UnsignedView::data() const noexcept
+{
+    return ptr;
+}
+//------------------------------------------------------------------------------
+inline std::size_t UnsignedView::digits() const noexcept
+{
+    return sz;
+}
+//------------------------------------------------------------------------------
+inline impl::digit_t UnsignedView::operator[](std::size_t i) const noexcept
+{
+    assert(i < sz);
+    return ptr[i];
+}
+//------------------------------------------------------------------------------
+inline bool UnsignedView::empty() const noexcept
+{
+    return sz == 0;
+}
+//------------------------------------------------------------------------------
+inline std::size_t UnsignedView::bits() const noexcept
+{
+    if (sz == 0) {
+        return 0;
+    }
+    return impl::bitsPerDigit * sz - impl::countLeadingZeroes(ptr[sz - 1]);
+}
+//------------------------------------------------------------------------------
+inline std::string UnsignedView::str() const
+{
+    return Unsigned(*this).str();
+}
+//------------------------------------------------------------------------------
+inline std::string UnsignedView::str(unsigned base, bool uppercase) const
+{
+    return Unsigned(*this).str(base, uppercase);
+}
+//------------------------------------------------------------------------------
+inline bool operator==(UnsignedView u, UnsignedView v)
+{
+    if (u.digits() != v.digits()) {
+        return false;
+    }
+    const std::size_t n = u.digits();
+    for (std::size_t i = 0; i < n; ++i) {
+        if (u[i] != v[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+inline bool operator!=(UnsignedView u, UnsignedView v)
+{
+    return !(u == v);
+}
+//------------------------------------------------------------------------------
+inline bool operator<(UnsignedView u, UnsignedView v)
+{
+    if (u.digits() != v.digits()) {
+        return u.digits() < v.digits();
+    }
+    const std::size_t n = u.digits();
+    for (std::size_t i = n; i != 0; --i) {
+        if (u[i - 1] == v[i - 1]) {
+            continue;
+        }
+        return u[i - 1] < v[i - 1];
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+inline bool operator>=(UnsignedView u, UnsignedView v)
+{
+    return !(u < v);
+}
+//------------------------------------------------------------------------------
+inline bool operator>(UnsignedView u, UnsignedView v)
+{
+    return v < u;
+}
+//------------------------------------------------------------------------------
+inline bool operator<=(UnsignedView u, UnsignedView v)
+{
+    return !(v < u);
+}
+//------------------------------------------------------------------------------
+inline Unsigned operator+(UnsignedView pu, UnsignedView pv)
+{
+    const impl::OperationScope scope(
+        Operation::add, pu.digits(), pv.digits());
+    const UnsignedView u = pu.digits() >= pv.digits() ? pu : pv;
+    const UnsignedView v = pu.digits() >= pv.digits() ? pv : pu;
+    const std::size_t n = u.digits();
+    const std::size_t m = v.digits();
+    Unsigned w;
+    w.digit.resize(n + 1);
+    bool carry = false;
+    for (std::size_t i = 0; i < m; ++i) {
+        w.digit[i] = impl::addCarry(u[i], v[i], carry);
+    }
+    std::size_t i;
+    for (i = m; (i < n) && carry; ++i) {
+        w.digit[i] = impl::addCarry(u[i], 0, carry);
+    }
+    for (; i < n; ++i) {
+        w.digit[i] = u[i];
+    }
+    if (carry) {
+        w.digit[n] = 1;
+    } else {
+        w.digit.resize(n);
+    }
+    return w;
+}
+//------------------------------------------------------------------------------
+inline Unsigned operator-(UnsignedView u, UnsignedView v)
+{
+    const impl::OperationScope scope(
+        Operation::subtract, u.digits(), v.digits());
+    const std::size_t n = u.digits();
+    const std::size_t m = v.digits();
+    if (m > n) {
+        throw std::invalid_argument("minuend is larger than subtrahend");
+    }
+    Unsigned w;
+    w.digit.resize(n);
+    bool borrow = false;
+    for (std::size_t i = 0; i < m; ++i) {
+        w.digit[i] = impl::subBorrow(u[i], v[i], borrow);
+    }
+    std::size_t i;
+    for (i = m; (i < n) && borrow; ++i) {
+        w.digit[i] = impl::subBorrow(u[i], 0, borrow);
+    }
+    for (; i < n; ++i) {
+        w.digit[i] = u[i];
+    }
+    if (borrow != 0) {
+        throw std::invalid_argument("minuend is larger than subtrahend");
+    }
+    w.removeLeadingZeroDigits();
+    return w;
+}
+//------------------------------------------------------------------------------
+inline Unsigned operator*(UnsignedView u, UnsignedView v)
+{
+    const impl::OperationScope scope(
+        Operation::multiply, u.digits(), v.digits());
+    Unsigned w;
+    Unsigned::multiplyAny(u, v, w);
+    return w;
+}
+//------------------------------------------------------------------------------
+inline Unsigned operator/(UnsignedView u, UnsignedView v)
+{
+    return div(u, v).quot;
+}
+//------------------------------------------------------------------------------
+inline Unsigned operator%(UnsignedView u, UnsignedView v)
+{
+    return div(u, v).rem;
+}
+//------------------------------------------------------------------------------
+inline Unsigned::QR div(UnsignedView u, UnsignedView v)
+{
+    const impl::OperationScope scope(
+        Operation::divide, u.digits(), v.digits());
+    Unsigned::QR qr;
+    Unsigned::divide(u, v, qr.quot, qr.rem);
+    return qr;
+}
+//------------------------------------------------------------------------------
+inline std::ostream& operator<<(std::ostream& out, UnsignedView u)
+{
+    return out << Unsigned(u);
+}
+//------------------------------------------------------------------------------
+inline std::size_t maxChars(UnsignedView u, unsigned base)
+{
+    if (!impl::isValidBase(base)) {
+        return 0;
+    }
+    return Unsigned::maxChars(u.bits(), base);
+}
+//------------------------------------------------------------------------------
+inline ToCharsResult
+    to_chars(char* first, char* last, UnsignedView u, unsigned base)
+{
+    return to_chars(first, last, Unsigned(u), base);
+}
+//------------------------------------------------------------------------------
+namespace impl {
+//------------------------------------------------------------------------------
+// Column files start with a header of columnHeaderSize bytes: the magic bytes
+// "BNCL", the format version, sizeof(digit_t), 1 for little or 0 for big
+// endian, a zero byte, the number of elements and the total number of digits
+// as std::uint64_t and eight zero bytes. The header is followed by the
+// element count plus one offsets as std::uint64_t and, starting at the next
+// multiple of columnDigitAlign bytes, the digits.
+constexpr std::size_t columnHeaderSize = 32;
+constexpr std::size_t columnDigitAlign = 16;
+constexpr unsigned char columnVersion = 1;
+//------------------------------------------------------------------------------
+inline std::runtime_error invalidColumnFile()
+{
+    return std::runtime_error("invalid column file");
+}
+//------------------------------------------------------------------------------
+inline std::size_t columnDigitPos(std::size_t count)
+{
+    const std::size_t end = columnHeaderSize + (count + 1) * 8;
+    return (end + columnDigitAlign - 1) / columnDigitAlign * columnDigitAlign;
+}
+//------------------------------------------------------------------------------
+inline void writeColumnHeader(
+    unsigned char* h,
+    std::uint64_t count,
+    std::uint64_t numDigits)
+{
+    std::memset(h, 0, columnHeaderSize);
+    std::memcpy(h, "BNCL", 4);
+    h[4] = columnVersion;
+    h[5] = static_cast<unsigned char>(sizeof(digit_t));
+    h[6] = isLittleEndianHost() ? 1 : 0;
+    std::memcpy(h + 8, &count, 8);
+    std::memcpy(h + 16, &numDigits, 8);
+}
+//------------------------------------------------------------------------------
+// Validates a header against the size of the file and returns the position of
+// the digits.
+inline std::size_t readColumnHeader(
+    const unsigned char* h,
+    std::uint64_t fileSize,
+    std::size_t& count,
+    std::uint64_t& numDigits)
+{
+    if ((std::memcmp(h, "BNCL", 4) != 0) || (h[4] != columnVersion)) {
+        throw invalidColumnFile();
+    }
+    if ((h[5] != sizeof(digit_t)) || (h[6] != (isLittleEndianHost() ? 1 : 0))) {
+        throw std::runtime_error("column file has incompatible digit layout");
+    }
+    std::uint64_t c;
+    std::memcpy(&c, h + 8, 8);
+    std::memcpy(&numDigits, h + 16, 8);
+    const std::uint64_t maxCount = (fileSize - columnHeaderSize) / 8;
+    if ((c >= maxCount) || (numDigits > fileSize / sizeof(digit_t))) {
+        throw invalidColumnFile();
+    }
+    count = static_cast<std::size_t>(c);
+    const std::size_t digitPos = columnDigitPos(count);
+    if (digitPos + numDigits * sizeof(digit_t) != fileSize) {
+        throw invalidColumnFile();
+    }
+    return digitPos;
+}
+//------------------------------------------------------------------------------
+inline void checkColumnOffsets(
+    const std::uint64_t* offsets,
+    std::size_t count,
+    std::uint64_t numDigits)
+{
+    if ((offsets[0] != 0) || (offsets[count] != numDigits)) {
+        throw invalidColumnFile();
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        if (offsets[i + 1] < offsets[i]) {
+            throw invalidColumnFile();
+        }
+    }
+}
+//------------------------------------------------------------------------------
+}  // namespace impl
+//------------------------------------------------------------------------------
+inline UnsignedColumn::UnsignedColumn()
+    : offsets(nullptr),
+      digitData(nullptr),
+      count(0),
+      mapping(nullptr),
+      mappingSize(0)
+{
+}
+//------------------------------------------------------------------------------
+inline UnsignedColumn::UnsignedColumn(UnsignedColumn&& other) noexcept
+    : offsetStore(std::move(other.offsetStore)),
+      digitStore(std::move(other.digitStore)),
+      offsets(other.offsets),
+      digitData(other.digitData),
+      count(other.count),
+      mapping(other.mapping),
+      mappingSize(other.mappingSize)
+{
+    other.offsets = nullptr;
+    other.digitData = nullptr;
+    other.count = 0;
+    other.mapping = nullptr;
+    other.mappingSize = 0;
+}
+//------------------------------------------------------------------------------
+inline UnsignedColumn::~UnsignedColumn()
+{
+    unmap();
+}
+//------------------------------------------------------------------------------
+inline UnsignedColumn&
+    UnsignedColumn::operator=(UnsignedColumn&& other) noexcept
+{
+    if (this != &other) {
+        unmap();
+        offsetStore = std::move(other.offsetStore);
+        digitStore = std::move(other.digitStore);
+        offsets = other.offsets;
+        digitData = other.digitData;
+        count = other.count;
+        mapping = other.mapping;
+        mappingSize = other.mappingSize;
+        other.offsetStore.clear();
+        other.digitStore.clear();
+        other.offsets = nullptr;
+        other.digitData = nullptr;
+        other.count = 0;
+        other.mapping = nullptr;
+        other.mappingSize = 0;
+    }
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline UnsignedColumn UnsignedColumn::load(const std::string& path, bool map)
+{
+    UnsignedColumn c;
+    std::uint64_t numDigits;
+#ifdef BN_HAVE_MMAP
+    if (map) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("cannot open column file");
+        }
+        struct stat st;
+        if ((::fstat(fd, &st) != 0)
+            || (static_cast<std::uint64_t>(st.st_size)
+                < impl::columnHeaderSize)) {
+            ::close(fd);
+            throw impl::invalidColumnFile();
+        }
+        const std::size_t size = static_cast<std::size_t>(st.st_size);
+        void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            throw std::runtime_error("cannot map column file");
+        }
+        c.mapping = p;
+        c.mappingSize = size;
+        const unsigned char* base = static_cast<const unsigned char*>(p);
+        const std::size_t digitPos =
+            impl::readColumnHeader(base, size, c.count, numDigits);
+        c.offsets = reinterpret_cast<const std::uint64_t*>(
+            base + impl::columnHeaderSize);
+        impl::checkColumnOffsets(c.offsets, c.count, numDigits);
+        c.digitData = reinterpret_cast<const impl::digit_t*>(base + digitPos);
+        return c;
+    }
+#else
+    (void)map;
+#endif
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("cannot open column file");
+    }
+    in.seekg(0, std::ios::end);
+    const std::streamoff size = in.tellg();
+    in.seekg(0, std::ios::beg);
+    unsigned char header[impl::columnHeaderSize];
+    if ((size < static_cast<std::streamoff>(impl::columnHeaderSize))
+        || !in.read(reinterpret_cast<char*>(header), sizeof(header))) {
+        throw impl::invalidColumnFile();
+    }
+    std::size_t count;
+    const std::size_t digitPos = impl::readColumnHeader(
+        header, static_cast<std::uint64_t>(size), count, numDigits);
+    c.offsetStore.resize(count + 1);
+    in.read(
+        reinterpret_cast<char*>(c.offsetStore.data()),
+        static_cast<std::streamsize>((count + 1) * 8));
+    if (!in) {
+        throw std::runtime_error("cannot read column file");
+    }
+    impl::checkColumnOffsets(c.offsetStore.data(), count, numDigits);
+    c.digitStore.resize(static_cast<std::size_t>(numDigits));
+    in.seekg(static_cast<std::streamoff>(digitPos), std::ios::beg);
+    in.read(
+        reinterpret_cast<char*>(c.digitStore.data()),
+        static_cast<std::streamsize>(
+            c.digitStore.size() * sizeof(impl::digit_t)));
+    if (!in) {
+        throw std::runtime_error("cannot read column file");
+    }
+    c.count = count;
+    c.updatePointers();
+    return c;
+}
+//------------------------------------------------------------------------------
+inline std::size_t UnsignedColumn::size() const noexcept
+{
+    return count;
+}
+//------------------------------------------------------------------------------
+inline std::size_t UnsignedColumn::totalDigits() const noexcept
+{
+    return (count == 0) ? 0 : static_cast<std::size_t>(offsets[count]);
+}
+//------------------------------------------------------------------------------
+inline UnsignedView UnsignedColumn::operator[](std::size_t i) const noexcept
+{
+    assert(i < count);
+    const std::size_t first = static_cast<std::size_t>(offsets[i]);
+    const std::size_t last = static_cast<std::size_t>(offsets[i + 1]);
+    return UnsignedView(digitData + first, last - first);
+}
+//------------------------------------------------------------------------------
+inline bool UnsignedColumn::mapped() const noexcept
+{
+    return mapping != nullptr;
+}
+//------------------------------------------------------------------------------
+inline void UnsignedColumn::reserve(std::size_t count, std::size_t digits)
+{
+    checkWritable();
+    offsetStore.reserve(count + 1);
+    digitStore.reserve(digits);
+    updatePointers();
+}
+//------------------------------------------------------------------------------
+inline void UnsignedColumn::push_back(UnsignedView u)
+{
+    checkWritable();
+    if (offsetStore.empty()) {
+        offsetStore.push_back(0);
+    }
+    const std::size_t n = u.digits();
+    const std::size_t pos = digitStore.size();
+    const impl::digit_t* src = u.data();
+    // u may view an element of this column, which the resize invalidates.
+    const bool alias = (n != 0) && !digitStore.empty()
+                    && (src >= digitStore.data())
+                    && (src < digitStore.data() + pos);
+    const std::size_t srcPos =
+        alias ? static_cast<std::size_t>(src - digitStore.data()) : 0;
+    digitStore.resize(pos + n);
+    if (alias) {
+        src = digitStore.data() + srcPos;
+    }
+    std::copy(src, src + n, digitStore.begin() + pos);
+    offsetStore.push_back(pos + n);
+    ++count;
+    updatePointers();
+}
+//------------------------------------------------------------------------------
+inline void UnsignedColumn::save(const std::string& path) const
+{
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("cannot open column file");
+    }
+    unsigned char header[impl::columnHeaderSize];
+    impl::writeColumnHeader(header, count, totalDigits());
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    const std::uint64_t zero = 0;
+    if (count == 0) {
+        out.write(reinterpret_cast<const char*>(&zero), 8);
+    } else {
+        out.write(
+            reinterpret_cast<const char*>(offsets),
+            static_cast<std::streamsize>((count + 1) * 8));
+    }
+    const std::size_t end = impl::columnHeaderSize + (count + 1) * 8;
+    const std::size_t pad = impl::columnDigitPos(count) - end;
+    const char padding[impl::columnDigitAlign] = {};
+    out.write(padding, static_cast<std::streamsize>(pad));
+    if (totalDigits() != 0) {
+        out.write(
+            reinterpret_cast<const char*>(digitData),
+            static_cast<std::streamsize>(
+                totalDigits() * sizeof(impl::digit_t)));
+    }
+    out.flush();
+    if (!out) {
+        throw std::runtime_error("cannot write column file");
+    }
+}
+//------------------------------------------------------------------------------
+inline void UnsignedColumn::checkWritable() const
+{
+    if (mapping != nullptr) {
+        throw std::logic_error("column is mapped");
+    }
+}
+//------------------------------------------------------------------------------
+inline void UnsignedColumn::updatePointers() noexcept
+{
+    offsets = offsetStore.empty() ? nullptr : offsetStore.data();
+    digitData = digitStore.empty() ? nullptr : digitStore.data();
+}
+//------------------------------------------------------------------------------
+inline void UnsignedColumn::unmap() noexcept
+{
+#ifdef BN_HAVE_MMAP
+    if (mapping != nullptr) {
+        ::munmap(mapping, mappingSize);
+        mapping = nullptr;
+        mappingSize = 0;
+    }
+#endif
+}
+//------------------------------------------------------------------------------
+inline Signed::Signed() noexcept : sign(0)
+{
+}
+//------------------------------------------------------------------------------
+inline Signed::Signed(const Signed& other) : val(other.val), sign(other.sign)
+{
+}
+//------------------------------------------------------------------------------
+inline Signed::Signed(Signed&& other) noexcept
+    : val(std::move(other.val)), sign(other.sign)
+{
+}
+//------------------------------------------------------------------------------
+inline Signed::Signed(const Unsigned& other)
+    : val(other), sign(val.empty() ? 0 : 1)
+{
+}
+//------------------------------------------------------------------------------
+inline Signed::Signed(Unsigned&& other) noexcept
+    : val(std::move(other)), sign(val.empty() ? 0 : 1)
+{
+}
+//------------------------------------------------------------------------------
+inline Signed::Signed(std::int32_t i)
+    : val(
+        i < 0 ? ~static_cast<std::uint32_t>(i) + 1
+              : static_cast<std::uint32_t>(i))
+    , sign(
+          i > 0   ? 1
+          : i < 0 ? -1
+                  : 0)
+{
+}
+//------------------------------------------------------------------------------
+inline Signed::Signed(std::uint32_t i) : val(i), sign(i > 0 ? 1 : 0)
+{
+}
+//------------------------------------------------------------------------------
+inline Signed::Signed(std::int64_t i)
+    : val(
+        i < 0 ? ~static_cast<std::uint64_t>(i) + 1
+              : static_cast<std::uint64_t>(i))
+    , sign(
+          i > 0   ? 1
+          : i < 0 ? -1
+                  : 0)
+{
+}
+//------------------------------------------------------------------------------
+inline Signed::Signed(std::uint64_t i) : val(i), sign(i > 0 ? 1 : 0)
+{
+}
+//------------------------------------------------------------------------------
+inline Signed::Signed(const char* dec)
+    : val(dec[0] == '-' ? dec + 1 : dec)
+    , sign(
+          val.empty()     ? 0
+          : dec[0] == '-' ? -1
+                          : 1)
+{
+}
+//------------------------------------------------------------------------------
+inline Signed& Signed::operator=(const Signed& other)
+{
+    val = other.val;
+    sign = other.sign;
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Signed& Signed::operator=(Signed&& other) noexcept
+{
+    val = std::move(other.val);
+    sign = other.sign;
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Signed Signed::fromString(const std::string& s, unsigned base)
+{
+    const bool negative = !s.empty() && (s[0] == '-');
+    Signed r(Unsigned::fromString(negative ? s.substr(1) : s, base));
+    if (negative) {
+        r.sign = -r.sign;
+    }
+    return r;
+}
+//------------------------------------------------------------------------------
+inline std::string Signed::str() const
+{
+    return str(10);
+}
+//------------------------------------------------------------------------------
+inline std::string Signed::str(unsigned base, bool uppercase) const
+{
+    std::string vs = val.str(base, uppercase);
+    if (sign == -1) {
+        vs = "-" + vs;
+    }
+    return vs;
+}
+//------------------------------------------------------------------------------
+inline int Signed::sgn() const
+{
+    return sign;
+}
+//------------------------------------------------------------------------------
+inline const Unsigned& Signed::abs() const
+{
+    return val;
+}
+//------------------------------------------------------------------------------
+inline Signed& Signed::operator++()
+{
+    switch (sign) {
+    case -1:
+        --val;
+        if (val.empty()) {
+            sign = 0;
+        }
+        break;
+    case 0:
+        ++val;
+        sign = 1;
+        break;
+    case 1: ++val; break;
+    }
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Signed Signed::operator++(int)
+{
+    Signed ret = *this;
+    ++(*this);
+    return ret;
+}
+//------------------------------------------------------------------------------
+inline Signed& Signed::operator--()
+{
+    switch (sign) {
+    case -1: ++val; break;
+    case 0:
+        ++val;
+        sign = -1;
+        break;
+    case 1:
+        --val;
+        if (val.empty()) {
+            sign = 0;
+        }
+        break;
+    }
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Signed Signed::operator--(int)
+{
+    Signed ret = *this;
+    --(*this);
+    return ret;
+}
+//------------------------------------------------------------------------------
+inline Signed& Signed::operator+=(const Signed& v)
+{
+    if (sign == v.sign) {
+        val += v.val;
+    } else if (val > v.val) {
+        val -= v.val;
+    } else {
+        val = v.val - val;
+        sign = val.empty() ? 0 : v.sign;
+    }
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Signed& Signed::operator-=(const Signed& v)
+{
+    if (-sign == v.sign) {
+        val += v.val;
+    } else if (val > v.val) {
+        val -= v.val;
+    } else {
+        val = v.val - val;
+        sign = val.empty() ? 0 : -v.sign;
+    }
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Signed& Signed::operator*=(const Signed& v)
+{
+    val *= v.val;
+    sign *= v.sign;
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Signed& Signed::operator/=(const Signed& v)
+{
+    val /= v.val;
+    sign = val.empty() ? 0 : sign * v.sign;
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Signed& Signed::operator%=(const Signed& v)
+{
+    val %= v.val;
+    if (val.empty()) {
+        sign = 0;
+    }
+    return *this;
+}
+//------------------------------------------------------------------------------
+inline Signed Signed::div(const Signed& v)
+{
+    Signed rem(val.div(v.val));
+    rem.sign = rem.val.empty() ? 0 : sign;
+    sign = val.empty() ? 0 : sign * v.sign;
+    return rem;
+}
+//------------------------------------------------------------------------------
+inline bool operator==(const Signed& u, const Signed& v)
+{
+    return (u.sign == v.sign) && (u.val == v.val);
+}
+//------------------------------------------------------------------------------
+inline bool operator!=(const Signed& u, const Signed& v)
+{
+    return !(u == v);
+}
+//------------------------------------------------------------------------------
+inline bool operator<(const Signed& u, const Signed& v)
+{
+    if (u.sign != v.sign) {
+        return u.sign < v.sign;
+    }
+    return (u.sign < 0) ? (v.val < u.val) : (u.val < v.val);
+}
+//------------------------------------------------------------------------------
+inline bool operator>=(const Signed& u, const Signed& v)
+{
+    return !(u < v);
+}
+//------------------------------------------------------------------------------
+inline bool operator>(const Signed& u, const Signed& v)
+{
+    return (v < u);
+}
+//------------------------------------------------------------------------------
+inline bool operator<=(const Signed& u, const Signed& v)
+{
+    return !(u > v);
+}
+//------------------------------------------------------------------------------
+inline Signed operator-(const Signed& u)
+{
+    Signed w;
+    w.sign = -u.sign;
+    w.val = u.val;
+    return w;
+}
+//------------------------------------------------------------------------------
+inline Signed operator+(const Signed& u, const Signed& v)
+{
+    Signed w;
+    if (u.sign == v.sign) {
+        w.val = u.val + v.val;
+        w.sign = u.sign;
+    } else if (u.val > v.val) {
+        w.val = u.val - v.val;
+        w.sign = u.sign;
+    } else {
+        w.val = v.val - u.val;
+        w.sign = w.val.empty() ? 0 : v.sign;
+    }
+    return w;
+}
+//------------------------------------------------------------------------------
+inline Signed operator-(const Signed& u, const Signed& v)
+{
+    Signed w;
+    if (-u.sign == v.sign) {
+        w.val = u.val + v.val;
+        w.sign = u.sign;
+    } else if (u.val > v.val) {
+        w.val = u.val - v.val;
+        w.sign = u.sign;
+    } else {
+        w.val = v.val - u.val;
+        w.sign = w.val.empty() ? 0 : -v.sign;
+    }
+    return w;
+}
+//------------------------------------------------------------------------------
+inline Signed operator*(const Signed& u, const Signed& v)
+{
+    Signed w;
+    w.val = u.val * v.val;
+    w.sign = u.sign * v.sign;
+    return w;
+}
+//------------------------------------------------------------------------------
+inline Signed operator/(const Signed& u, const Signed& v)
+{
+    return div(u, v).quot;
+}
+//------------------------------------------------------------------------------
+inline Signed operator%(const Signed& u, const Signed& v)
+{
+    return div(u, v).rem;
+}
+//------------------------------------------------------------------------------
+inline bool isDivisible(const Unsigned& u, const Unsigned& d)
+{
+    const impl::OperationScope scope(Operation::divide, u.digits(), d.digits());
+    if (d.empty() || u.empty()) {
+        return u.empty();
+    }
+    // d = 2^tz*v with v odd, so d divides u exactly if 2^tz and v do.
+    const std::size_t tz = d.ctz();
+    if (!isDivisibleBy2Exp(u, tz)) {
+        return false;
+    }
+    const Unsigned v = d >> tz;
+    if (v.digits() == 1) {
+        return u.isDivisibleByOddDigit(v.digit[0]);
+    }
+    return u.isDivisibleByOdd(v);
+}
+//------------------------------------------------------------------------------
+inline bool isDivisibleBy2Exp(const Unsigned& u, std::size_t b)
+{
+    if (u.empty()) {
+        return true;
+    }
+    const std::size_t n = b / impl::bitsPerDigit;
+    if (u.digits() <= n) {
+        return false;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        if (u.digit[i] != 0) {
+            return false;
+        }
+    }
+    const std::size_t rest = b % impl::bitsPerDigit;
+    const impl::digit_t mask =
+        static_cast<impl::digit_t>((impl::digit_t(1) << rest) - 1);
+    return (u.digit[n] & mask) == 0;
+}
+//------------------------------------------------------------------------------
+inline bool isCongruent(const Unsigned& u, const Unsigned& c, const Unsigned& d)
+{
+    if (d.empty()) {
+        return u == c;
+    }
+    if (d.digits() == 1) {
+        return u.remainderByDigit(d.digit[0]) == c.remainderByDigit(d.digit[0]);
+    }
+    return (u < c) ? isDivisible(c - u, d) : isDivisible(u - c, d);
+}
+//------------------------------------------------------------------------------
+inline Unsigned mulLow(const Unsigned& u, const Unsigned& v, std::size_t n)
+{
+    const impl::OperationScope scope(
+        Operation::multiply, u.digits(), v.digits());
+    Unsigned w;
+    Unsigned::multiplyLow(u, v, n, w);
+    return w;
+}
+//------------------------------------------------------------------------------
+inline Unsigned mulHigh(const Unsigned& u, const Unsigned& v, std::size_t n)
+{
+    const impl::OperationScope scope(
+        Operation::multiply, u.digits(), v.digits());
+    Unsigned w;
+    Unsigned::multiplyHigh(u, v, n, w);
+    return w;
+}
+//------------------------------------------------------------------------------
+inline Unsigned mulMiddle(const Unsigned& u, const Unsigned& v)
+{
+    const impl::OperationScope scope(
+        Operation::multiply, u.digits(), v.digits());
+    if (u.digits() < v.digits()) {
+        throw std::invalid_argument("v has more digits than u");
+    }
+    Unsigned w;
+    Unsigned::multiplyMiddle(u, v, w);
+    return w;
+}
+//------------------------------------------------------------------------------
+inline Signed divexact(const Signed& u, const Signed& d)
+{
+    Signed q(divexact(u.val, d.val));
+    q.sign = q.val.empty() ? 0 : u.sign * d.sign;
+    return q;
+}
+//------------------------------------------------------------------------------
+inline bool isDivisible(const Signed& u, const Signed& d)
+{
+    return isDivisible(u.val, d.val);
+}
+//------------------------------------------------------------------------------
+inline bool isDivisibleBy2Exp(const Signed& u, std::size_t b)
+{
+    return isDivisibleBy2Exp(u.val, b);
+}
+//------------------------------------------------------------------------------
+inline bool isCongruent(const Signed& u, const Signed& c, const Signed& d)
+{
+    return isDivisible(u - c, d);
+}
+//------------------------------------------------------------------------------
+inline Signed::QR div(const Signed& u, const Signed& v)
+{
+    Unsigned::QR uqr = ::bn::div(u.val, v.val);
+    Signed::QR qr{std::move(uqr.quot), std::move(uqr.rem)};
+    qr.quot.sign = qr.quot.val.empty() ? 0 : u.sign * v.sign;
+    qr.rem.sign = qr.rem.val.empty() ? 0 : u.sign;
+    return qr;
+}
+//------------------------------------------------------------------------------
+inline void Signed::addNative(std::uint64_t m, int s)
+{
+    if (s == 0) {
+        return;
+    }
+    if ((sign == 0) || (sign == s)) {
+        val += m;
+        sign = static_cast<int8_t>(s);
+    } else if (val > m) {
+        val -= m;
+    } else {
+        val = m - val;
+        sign = val.empty() ? 0 : static_cast<int8_t>(s);
+    }
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Signed&> Signed::operator+=(T v)
+{
+    addNative(impl::magnitude(v), impl::signum(v));
+    return *this;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Signed&> Signed::operator-=(T v)
+{
+    addNative(impl::magnitude(v), -impl::signum(v));
+    return *this;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Signed&> Signed::operator*=(T v)
+{
+    val *= impl::magnitude(v);
+    sign = val.empty() ? 0 : static_cast<int8_t>(sign * impl::signum(v));
+    return *this;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Signed&> Signed::operator/=(T v)
+{
+    val /= impl::magnitude(v);
+    sign = val.empty() ? 0 : static_cast<int8_t>(sign * impl::signum(v));
+    return *this;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Signed&> Signed::operator%=(T v)
+{
+    val %= impl::magnitude(v);
+    if (val.empty()) {
+        sign = 0;
+    }
+    return *this;
+}
+//------------------------------------------------------------------------------
+namespace impl {
+//------------------------------------------------------------------------------
+template<typename T>
+Signed toSigned(T i)
+{
+    Signed s(Unsigned(magnitude(i)));
+    return (signum(i) < 0) ? -s : s;
+}
+//------------------------------------------------------------------------------
+// Compares an integer with the integer of sign s and absolute value m and
+// returns -1, 0 or 1.
+inline int compare(const Signed& u, std::uint64_t m, int s)
+{
+    if (u.sgn() != s) {
+        return (u.sgn() < s) ? -1 : 1;
+    }
+    const int c = compare(u.abs(), m);
+    return (s < 0) ? -c : c;
+}
+//------------------------------------------------------------------------------
+}  // namespace impl
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Signed> operator+(const Signed& u, T v)
+{
+    Signed w(u);
+    w += v;
+    return w;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Signed> operator+(T v, const Signed& u)
+{
+    return u + v;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Signed> operator-(const Signed& u, T v)
+{
+    Signed w(u);
+    w -= v;
+    return w;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Signed> operator-(T v, const Signed& u)
+{
+    Signed w(-u);
+    w += v;
+    return w;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Signed> operator*(const Signed& u, T v)
+{
+    Signed w(u);
+    w *= v;
+    return w;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Signed> operator*(T v, const Signed& u)
+{
+    return u * v;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Signed> operator/(const Signed& u, T v)
+{
+    Signed w(u);
+    w /= v;
+    return w;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Signed> operator/(T v, const Signed& u)
+{
+    return impl::toSigned(v) / u;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Signed> operator%(const Signed& u, T v)
+{
+    Signed w(u);
+    w %= v;
+    return w;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Signed> operator%(T v, const Signed& u)
+{
+    return impl::toSigned(v) % u;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator==(const Signed& u, T v)
+{
+    return impl::compare(u, impl::magnitude(v), impl::signum(v)) == 0;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator==(T v, const Signed& u)
+{
+    return u == v;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator!=(const Signed& u, T v)
+{
+    return !(u == v);
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator!=(T v, const Signed& u)
+{
+    return !(u == v);
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator<(const Signed& u, T v)
+{
+    return impl::compare(u, impl::magnitude(v), impl::signum(v)) < 0;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator<(T v, const Signed& u)
+{
+    return impl::compare(u, impl::magnitude(v), impl::signum(v)) > 0;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator>=(const Signed& u, T v)
+{
+    return !(u < v);
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator>=(T v, const Signed& u)
+{
+    return !(v < u);
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator>(const Signed& u, T v)
+{
+    return v < u;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator>(T v, const Signed& u)
+{
+    return u < v;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator<=(const Signed& u, T v)
+{
+    return !(v < u);
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator<=(T v, const Signed& u)
+{
+    return !(u < v);
+}
+//------------------------------------------------------------------------------
+inline std::ostream& operator<<(std::ostream& os, const Signed& s)
+{
+    unsigned base;
+    std::string prefix = impl::streamPrefix(os, base);
+    if (s.sign == 0) {
+        prefix.clear();
+    } else if (s.sign == -1) {
+        prefix = "-" + prefix;
+    }
+    const bool uppercase = (os.flags() & std::ios_base::uppercase) != 0;
+    return impl::writeToStream(os, prefix, s.val, base, uppercase);
+}
+//------------------------------------------------------------------------------
+inline std::size_t maxChars(const Signed& s, unsigned base)
+{
+    return maxChars(s.abs(), base) + (s.sgn() < 0 ? 1 : 0);
+}
+//------------------------------------------------------------------------------
+inline ToCharsResult
+    to_chars(char* first, char* last, const Signed& s, unsigned base)
+{
+    if (!impl::isValidBase(base)) {
+        return ToCharsResult{last, std::errc::invalid_argument};
+    }
+    if (s.sgn() < 0) {
+        if (first == last) {
+            return ToCharsResult{last, std::errc::value_too_large};
+        }
+        *first++ = '-';
+    }
+    return to_chars(first, last, s.abs(), base);
+}
+//------------------------------------------------------------------------------
+inline FromCharsResult
+    from_chars(const char* first, const char* last, Signed& s, unsigned base)
+{
+    const bool negative = (first != last) && (*first == '-');
+    Unsigned u;
+    FromCharsResult r = from_chars(first + negative, last, u, base);
+    if (r.ec != std::errc()) {
+        return FromCharsResult{first, r.ec};
+    }
+    s = negative ? -Signed(std::move(u)) : Signed(std::move(u));
+    return r;
+}
+//------------------------------------------------------------------------------
+inline Rational::Rational() noexcept : den(1)
+{
+}
+//------------------------------------------------------------------------------
+inline Rational::Rational(const Signed& num, const Unsigned& den)
+    : num(num), den(den)
+{
+    if (den.empty()) {
+        throw std::invalid_argument("den is 0");
+    }
+    reduce();
+}
+//------------------------------------------------------------------------------
+inline Rational::Rational(Signed&& num, Unsigned&& den)
+    : num(std::move(num)), den(std::move(den))
+{
+    if (this->den.empty()) {
+        throw std::invalid_argument("den is 0");
+    }
+    reduce();
+}
+//------------------------------------------------------------------------------
+inline Rational::Rational(double d) : den(1)
+{
+    if (!std::isfinite(d)) {
+        throw std::invalid_argument("d is not finite");
+    }
+    std::uint64_t u;
+    memcpy(&u, &d, 8);
+    std::uint64_t frac = u & 0xFFFFFFFFFFFFFull;
+    std::uint64_t bexp = (u >> 52) & 0x7FFull;
+    std::uint64_t sign = u >> 63;
+    if (bexp == 0) {
+        if (frac != 0) {
+            num.val = Unsigned(frac);
+            num.sign = (sign == 1) ? -1 : 1;
+            den <<= (1022 + 52);
+        }
+    } else {
+        frac |= 0x10000000000000ull;
+        num.val = Unsigned(frac);
+        num.sign = (sign == 1) ? -1 : 1;
+        if (bexp < (1023 + 52)) {
+            den <<= (1023 + 52 - bexp);
+        } else {
+            num.val <<= (bexp - 1023 - 52);
+        }
+    }
+    reduce();
+}
+//------------------------------------------------------------------------------
+inline Rational::Rational(const Unsigned& v) : num(v), den(1)
+{
+}
+//------------------------------------------------------------------------------
+inline Rational::Rational(Unsigned&& v) : num(std::move(v)), den(1)
+{
+}
+//------------------------------------------------------------------------------
+inline Rational::Rational(const Signed& v) : num(v), den(1)
+{
+}
+//------------------------------------------------------------------------------
+inline Rational::Rational(Signed&& v) : num(std::move(v)), den(1)
+{
+}
+//------------------------------------------------------------------------------
+inline const Signed& Rational::numerator() const
+{
+    return num;
+}
+//------------------------------------------------------------------------------
+inline const Unsigned& Rational::denominator() const
+{
+    return den;
+}
+//------------------------------------------------------------------------------
+inline Rational Rational::reciprocal() const
+{
+    if (num.abs().empty()) {
+        throw std::logic_error("numerator is 0");
+    }
+    Rational w;
+    w.num = den;
+    w.den = num.abs();
+    w.num.sign = num.sign;
+    return w;
+}
+//------------------------------------------------------------------------------
+inline Rational& Rational::operator+=(const Rational& v)
+{
+    num *= v.den;
+    num += v.num * den;
+    den *= v.den;
+    reduce();
     return *this;
 }
 //------------------------------------------------------------------------------
-inline std::size_t Store::size() const noexcept
+inline Rational& Rational::operator-=(const Rational& v)
 {
-    return sz;
+    num *= v.den;
+    num -= v.num * den;
+    den *= v.den;
+    reduce();
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline const impl::digit_t& Store::operator[](std::size_t i) const noexcept
+inline Rational& Rational::operator*=(const Rational& v)
 {
-    assert(i < sz);
-    return mem[i];
+    num *= v.num;
+    den *= v.den;
+    reduce();
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline impl::digit_t& Store::operator[](std::size_t i) noexcept
+inline Rational& Rational::operator/=(const Rational& v)
 {
-    assert(i < sz);
-    return mem[i];
+    if (v.num.abs().empty()) {
+        throw std::invalid_argument("division by 0");
+    }
+    num *= v.den;
+    den *= v.num.abs();
+    num.sign *= v.num.sign;
+    reduce();
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline void Store::resize(std::size_t newsize)
+inline Rational::operator double() const
 {
-    if (newsize <= smemsize) {
-        if (cap >= (2 * smemsize)) {
-            memcpy(smem, mem, newsize * sizeof(impl::digit_t));
-            deallocate(mem);
-            mem = smem;
-            cap = smemsize;
-        }
-        sz = newsize;
-    } else if (newsize <= cap) {
-        if (cap >= (2 * newsize)) {
-            impl::digit_t* temp = alloc_digits(newsize);
-            memcpy(temp, mem, newsize * sizeof(impl::digit_t));
-            deallocate(mem);
-            mem = temp;
-            cap = newsize;
+    if (num.abs().empty()) {
+        return 0.0;
+    }
+    std::ptrdiff_t d = static_cast<std::ptrdiff_t>(num.abs().bits())
+                     - static_cast<std::ptrdiff_t>(den.bits());
+    // We use the fact that 2^(d-1) < *this < 2^(d+1)
+    if (d <= -1075) {
+        // Underflow
+        return std::copysign(0.0, num.sign);
+    }
+    if (d >= 1025) {
+        // Overflow
+        return std::copysign(std::numeric_limits<double>::infinity(), num.sign);
+    }
+    // Shift the numerator so that the quotient of the shifted numerator and
+    // the denominator have at least 54 bits. According to the inequation above,
+    // the quotient will have either 54 or 55 bits.
+    std::ptrdiff_t nls = 54 - d;
+    Unsigned snum = (nls >= 0) ? num.abs() << static_cast<std::size_t>(nls)
+                               : num.abs() >> static_cast<std::size_t>(-nls);
+    std::uint64_t q = static_cast<std::uint64_t>(snum / den);
+    // If the quotient has 55 bits, discard one bit.
+    if (q & (1ull << 54)) {
+        q >>= 1;
+        --nls;
+    }
+    // Check if we have to round up
+    if (q & 3) {
+        ++q;
+        // If the quotient has 55 bits, discard one bit.
+        if (q & (1ull << 54)) {
+            q >>= 1;
+            --nls;
         }
-        sz = newsize;
+    }
+    // Discard the bit used to check if rounding up is necessary
+    q >>= 1;
+    --nls;
+    // Create the components
+    std::uint64_t sign = (num.sign == -1) ? 1 : 0;
+    std::uint64_t bexp;
+    std::uint64_t frac;
+    if (nls > 1074) {
+        bexp = 0;
+        std::size_t sr = nls - 1074;
+        frac = (sr > 63) ? 0 : q >> sr;
+    } else if (-nls > 971) {
+        // Overflow
+        bexp = 2047;
+        frac = 0;
     } else {
-        impl::digit_t* temp = alloc_digits(newsize);
-        memcpy(temp, mem, sz * sizeof(impl::digit_t));
-        if (cap != smemsize) {
-            deallocate(mem);
-        }
-        mem = temp;
-        cap = newsize;
-        sz = newsize;
+        bexp = 1075 - nls;
+        // Create the fraction by masking the leading bit of q
+        frac = q & 0xFFFFFFFFFFFFFull;
     }
+    std::uint64_t uret = (sign << 63) | (bexp << 52) | frac;
+    double ret;
+    memcpy(&ret, &uret, 8);
+    return ret;
 }
 //------------------------------------------------------------------------------
-inline void Store::deallocate(void* ptr)
+inline std::string Rational::str() const
 {
-    std::free(ptr);
+    std::ostringstream out;
+    out << *this;
+    return out.str();
 }
 //------------------------------------------------------------------------------
-inline impl::digit_t* Store::alloc_digits(std::size_t count)
+inline void Rational::reduce()
 {
-    constexpr std::size_t maxDigits =
-        static_cast<std::size_t>(std::numeric_limits<ptrdiff_t>::max())
-        / impl::bitsPerDigit;
-    if (count > maxDigits) {
-        throw std::bad_alloc();
-    }
-    const size_t numBytes = count * sizeof(impl::digit_t);
-    void* mem = std::malloc(numBytes);
-    if (mem == nullptr) {
-        throw std::bad_alloc();
+    const Unsigned d = gcd(num.abs(), den);
+    if (d != 1) {
+        num.val = divexact(num.val, d);
+        den = divexact(den, d);
     }
-    return static_cast<impl::digit_t*>(mem);
 }
 //------------------------------------------------------------------------------
-}  // namespace impl
+inline bool operator==(const Rational& u, const Rational& v)
+{
+    return (u.num == v.num) && (u.den == v.den);
+}
 //------------------------------------------------------------------------------
-inline Unsigned::Unsigned() noexcept
+inline bool operator!=(const Rational& u, const Rational& v)
 {
+    return !(u == v);
 }
 //------------------------------------------------------------------------------
-inline Unsigned::Unsigned(const Unsigned& other) : digit(other.digit)
+inline bool operator<(const Rational& u, const Rational& v)
 {
+    if (u.num.sgn() != v.num.sgn()) {
+        return u.num.sgn() < v.num.sgn();
+    }
+    if (u.num.sgn() == 0) {
+        return false;
+    }
+    const Rational& a = (u.num.sgn() == 1) ? u : v;
+    const Rational& b = (u.num.sgn() == 1) ? v : u;
+    const std::ptrdiff_t m = static_cast<std::ptrdiff_t>(a.num.abs().digits())
+                           - static_cast<std::ptrdiff_t>(a.den.digits());
+    const std::ptrdiff_t n = static_cast<std::ptrdiff_t>(b.num.abs().digits())
+                           - static_cast<std::ptrdiff_t>(b.den.digits());
+    if ((m + 1) <= (n - 1)) {
+        return true;
+    }
+    if ((n + 1) <= (m - 1)) {
+        return false;
+    }
+    const Unsigned ane = a.num.abs() * b.den;
+    const Unsigned bne = b.num.abs() * a.den;
+    return ane < bne;
 }
 //------------------------------------------------------------------------------
-inline Unsigned::Unsigned(Unsigned&& other) noexcept
-    : digit(std::move(other.digit))
+inline bool operator>=(const Rational& u, const Rational& v)
 {
+    return !(u < v);
 }
 //------------------------------------------------------------------------------
-inline Unsigned::Unsigned(std::int32_t i)
+inline bool operator>(const Rational& u, const Rational& v)
 {
-    if (i < 0) {
-        throw std::invalid_argument("i is negative");
-    }
-    initFromIntegral(static_cast<std::uint32_t>(i));
+    return v < u;
 }
 //------------------------------------------------------------------------------
-inline Unsigned::Unsigned(std::uint32_t i)
+inline bool operator<=(const Rational& u, const Rational& v)
 {
-    initFromIntegral(i);
+    return !(u > v);
 }
 //------------------------------------------------------------------------------
-inline Unsigned::Unsigned(std::int64_t i)
+inline Rational operator-(const Rational& u)
 {
-    if (i < 0) {
-        throw std::invalid_argument("i is negative");
-    }
-    initFromIntegral(static_cast<std::uint64_t>(i));
+    return Rational(-u.num, u.den);
 }
 //------------------------------------------------------------------------------
-inline Unsigned::Unsigned(std::uint64_t i)
+inline Rational operator+(const Rational& u, const Rational& v)
 {
-    initFromIntegral(i);
+    Rational w(u.num * v.den + v.num * u.den, u.den * v.den);
+    return w;
 }
 //------------------------------------------------------------------------------
-template<
-    typename T,
-    typename std::enable_if<EnableUserDefinedIntegral<T>::value, bool>::type>
-Unsigned::Unsigned(T i)
+inline Rational operator-(const Rational& u, const Rational& v)
 {
-    initFromIntegral(i);
+    Rational w(u.num * v.den - v.num * u.den, u.den * v.den);
+    return w;
 }
 //------------------------------------------------------------------------------
-inline Unsigned::Unsigned(const char* dec)
+inline Rational operator*(const Rational& u, const Rational& v)
 {
-    if (*dec == '\0') {
-        throw std::invalid_argument("dec is empty");
-    }
-
-    while (*dec) {
-        const char* end = dec;
-        std::size_t count = 0;
-        while (*end && (count < impl::maxDecDigitsPerDigit)) {
-            ++count;
-            ++end;
-        }
-        impl::digit_t mul;
-        if (count == impl::maxDecDigitsPerDigit) {
-            mul = impl::maxPow10PerDigit;
-        } else {
-            mul = 1;
-            for (std::size_t i = 0; i < count; ++i) {
-                mul *= 10;
-            }
-        }
-        multiplyByDigit(mul);
-        impl::digit_t add = 0;
-        for (const char* curr = dec; curr != end; ++curr) {
-            if ((*curr < '0') || (*curr > '9')) {
-                throw std::invalid_argument("invalid digit in string");
-            }
-            add = 10 * add + (*curr - '0');
-        }
-        addDigit(add);
-        dec = end;
+    Rational w(u.num * v.num, u.den * v.den);
+    return w;
+}
+//------------------------------------------------------------------------------
+inline Rational operator/(const Rational& u, const Rational& v)
+{
+    if (v.num.abs().empty()) {
+        throw std::invalid_argument("division by 0");
     }
+    Rational w(u.num.abs() * v.den, u.den * v.num.abs());
+    w.num.sign = u.num.sgn() * v.num.sgn();
+    return w;
 }
 //------------------------------------------------------------------------------
-inline Unsigned& Unsigned::operator=(const Unsigned& other)
+inline void Rational::addNative(std::uint64_t m, int s)
 {
-    digit = other.digit;
-    return *this;
+    // gcd(num + m*den, den) = gcd(num, den) = 1, so the sum stays reduced.
+    if (s > 0) {
+        num += Signed(den * m);
+    } else if (s < 0) {
+        num -= Signed(den * m);
+    }
 }
 //------------------------------------------------------------------------------
-inline Unsigned& Unsigned::operator=(Unsigned&& other) noexcept
+inline void Rational::multiplyNative(std::uint64_t m, int s)
 {
-    digit = std::move(other.digit);
-    return *this;
+    if (s == 0) {
+        num = Signed();
+        den = 1;
+        return;
+    }
+    const std::uint64_t g =
+        impl::gcd64(m, static_cast<std::uint64_t>(den % m));
+    num *= m / g;
+    den /= g;
+    num.sign = static_cast<int8_t>(num.sign * s);
 }
 //------------------------------------------------------------------------------
-template<typename Generator>
-Unsigned Unsigned::random(std::size_t numBits, Generator& gen)
+inline void Rational::divideNative(std::uint64_t m, int s)
 {
-    if (numBits == 0) {
-        return Unsigned();
+    if (s == 0) {
+        throw std::invalid_argument("division by 0");
     }
-    return generateRandom<impl::bitsPerDigit>(numBits, gen);
+    const std::uint64_t g =
+        impl::gcd64(m, static_cast<std::uint64_t>(num.abs() % m));
+    num /= g;
+    den *= m / g;
+    num.sign = static_cast<int8_t>(num.sign * s);
 }
 //------------------------------------------------------------------------------
-inline Unsigned& Unsigned::operator++()
+template<typename T>
+impl::IfNative<T, Rational&> Rational::operator+=(T v)
 {
-    addDigit(1);
+    addNative(impl::magnitude(v), impl::signum(v));
     return *this;
 }
 //------------------------------------------------------------------------------
-inline Unsigned Unsigned::operator++(int)
-{
-    Unsigned ret = *this;
-    ++(*this);
-    return ret;
+template<typename T>
+impl::IfNative<T, Rational&> Rational::operator-=(T v)
+{
+    addNative(impl::magnitude(v), -impl::signum(v));
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline Unsigned& Unsigned::operator--()
+template<typename T>
+impl::IfNative<T, Rational&> Rational::operator*=(T v)
 {
-    subtractDigit(1);
+    multiplyNative(impl::magnitude(v), impl::signum(v));
     return *this;
 }
 //------------------------------------------------------------------------------
-inline Unsigned Unsigned::operator--(int)
+template<typename T>
+impl::IfNative<T, Rational&> Rational::operator/=(T v)
 {
-    Unsigned ret = *this;
-    --(*this);
-    return ret;
+    divideNative(impl::magnitude(v), impl::signum(v));
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline Unsigned& Unsigned::operator|=(const Unsigned& v)
+namespace impl {
+//------------------------------------------------------------------------------
+// Compares a rational number with the integer of sign s and absolute value m
+// and returns -1, 0 or 1.
+inline int compare(const Rational& u, std::uint64_t m, int s)
 {
-    const std::size_t n = digit.size();
-    const std::size_t m = v.digit.size();
-    if (n < m) {
-        digit.resize(m);
-        for (std::size_t i = 0; i < n; ++i) {
-            digit[i] |= v.digit[i];
-        }
-        for (std::size_t i = n; i < m; ++i) {
-            digit[i] = v.digit[i];
-        }
+    const Signed& num = u.numerator();
+    if (num.sgn() != s) {
+        return (num.sgn() < s) ? -1 : 1;
+    }
+    int c;
+    if (u.denominator() == 1) {
+        c = compare(num.abs(), m);
     } else {
-        for (std::size_t i = 0; i < m; ++i) {
-            digit[i] |= v.digit[i];
-        }
+        const Unsigned w = u.denominator() * m;
+        c = (num.abs() > w) - (num.abs() < w);
     }
-    return *this;
+    return (s < 0) ? -c : c;
 }
 //------------------------------------------------------------------------------
-inline Unsigned& Unsigned::operator&=(const Unsigned& v)
+}  // namespace impl
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, Rational> operator+(const Rational& u, T v)
 {
-    const std::size_t n = std::min(digit.size(), v.digit.size());
-    digit.resize(n);
-    for (std::size_t i = 0; i < n; ++i) {
-        digit[i] &= v.digit[i];
-    }
-    removeLeadingZeroDigits();
-    return *this;
+    Rational w(u);
+    w += v;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline Unsigned& Unsigned::operator^=(const Unsigned& v)
+template<typename T>
+impl::IfNative<T, Rational> operator+(T v, const Rational& u)
 {
-    const std::size_t n = digit.size();
-    const std::size_t m = v.digit.size();
-    if (n < m) {
-        digit.resize(m);
-        for (std::size_t i = 0; i < n; ++i) {
-            digit[i] ^= v.digit[i];
-        }
-        for (std::size_t i = n; i < m; ++i) {
-            digit[i] = v.digit[i];
-        }
-    } else {
-        for (std::size_t i = 0; i < m; ++i) {
-            digit[i] ^= v.digit[i];
-        }
-    }
-    removeLeadingZeroDigits();
-    return *this;
+    return u + v;
 }
 //------------------------------------------------------------------------------
-inline Unsigned& Unsigned::operator<<=(std::size_t s)
+template<typename T>
+impl::IfNative<T, Rational> operator-(const Rational& u, T v)
 {
-    if (s == 0) {
-        return *this;
-    }
-    const std::size_t n = digit.size();
-    if (n == 0) {
-        return *this;
-    }
-    const std::size_t ds = s / impl::bitsPerDigit;
-    const std::size_t lbs = s % impl::bitsPerDigit;
-    if (lbs == 0) {
-        digit.resize(n + ds);
-        for (size_t i = 0; i < n; ++i) {
-            digit[i + ds] = digit[i];
-        }
-        for (size_t i = 0; i < ds; ++i) {
-            digit[i] = 0;
-        }
-        return *this;
-    }
-    const std::size_t rbs = impl::bitsPerDigit - lbs;
-    const std::size_t lz = countLeadingZeroes();
-    if (lbs > lz) {
-        digit.resize(n + ds + 1);
-        digit[n + ds] = digit[n - 1] >> rbs;
-    } else {
-        digit.resize(n + ds);
-    }
-    for (std::size_t i = 0; i < n - 1; ++i) {
-        digit[ds + n - i - 1] =
-            (digit[n - i - 1] << lbs) | (digit[n - i - 2] >> rbs);
-    }
-    digit[ds] = digit[0] << lbs;
-    for (std::size_t i = 0; i < ds; ++i) {
-        digit[i] = 0;
-    }
-    return *this;
+    Rational w(u);
+    w -= v;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline Unsigned& Unsigned::operator>>=(std::size_t s)
+template<typename T>
+impl::IfNative<T, Rational> operator-(T v, const Rational& u)
 {
-    if (s == 0) {
-        return *this;
-    }
-    const std::size_t n = digit.size();
-    if (n == 0) {
-        return *this;
-    }
-    const std::size_t lz = countLeadingZeroes();
-    const std::size_t nb = n * impl::bitsPerDigit - lz;
-    if (s >= nb) {
-        digit.resize(0);
-        return *this;
-    }
-    const std::size_t ds = s / impl::bitsPerDigit;
-    const std::size_t rbs = s % impl::bitsPerDigit;
-    if (rbs == 0) {
-        const std::size_t m = n - ds;
-        for (std::size_t i = 0; i < m; ++i) {
-            digit[i] = digit[ds + i];
-        }
-        digit.resize(m);
-        return *this;
-    }
-    const std::size_t lbs = impl::bitsPerDigit - rbs;
-    const std::size_t m = (nb - s - 1) / impl::bitsPerDigit + 1;
-    for (std::size_t i = 0; i < n - ds - 1; ++i) {
-        digit[i] = (digit[i + ds] >> rbs) | (digit[i + ds + 1] << lbs);
-    }
-    if (lz < lbs) {
-        digit[n - ds - 1] = digit[n - 1] >> rbs;
-    }
-    digit.resize(m);
-    return *this;
+    Rational w(-u);
+    w += v;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline Unsigned& Unsigned::operator+=(const Unsigned& v)
+template<typename T>
+impl::IfNative<T, Rational> operator*(const Rational& u, T v)
 {
-    const std::size_t n = digit.size();
-    const std::size_t m = v.digit.size();
-    if (m <= n) {
-        bool carry = false;
-        for (std::size_t i = 0; i < m; ++i) {
-            digit[i] = impl::addCarry(digit[i], v.digit[i], carry);
-        }
-        for (std::size_t i = m; (i < n) && carry; ++i) {
-            digit[i] = impl::addCarry(digit[i], 0, carry);
-        }
-        if (carry) {
-            digit.resize(n + 1);
-            digit[n] = 1;
-        }
-    } else {
-        digit.resize(m + 1);
-        bool carry = false;
-        for (std::size_t i = 0; i < n; ++i) {
-            digit[i] = impl::addCarry(digit[i], v.digit[i], carry);
-        }
-        for (std::size_t i = n; i < m; ++i) {
-            digit[i] = impl::addCarry(v.digit[i], 0, carry);
-        }
-        if (carry) {
-            digit[m] = 1;
-        } else {
-            digit.resize(m);
-        }
-    }
-    return *this;
+    Rational w(u);
+    w *= v;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline Unsigned& Unsigned::operator-=(const Unsigned& v)
+template<typename T>
+impl::IfNative<T, Rational> operator*(T v, const Rational& u)
 {
-    const std::size_t n = digit.size();
-    const std::size_t m = v.digit.size();
-    if (m > n) {
-        throw std::invalid_argument("minuend is larger than subtrahend");
-    }
-    bool borrow = 0;
-    for (std::size_t i = 0; i < m; ++i) {
-        digit[i] = impl::subBorrow(digit[i], v.digit[i], borrow);
-    }
-    std::size_t i;
-    for (i = m; (i < n) && borrow; ++i) {
-        digit[i] = impl::subBorrow(digit[i], 0, borrow);
-    }
-    if (borrow) {
-        throw std::invalid_argument("minuend is larger than subtrahend");
-    }
-    removeLeadingZeroDigits();
-    return *this;
+    return u * v;
 }
 //------------------------------------------------------------------------------
-inline Unsigned& Unsigned::operator*=(const Unsigned& v)
+template<typename T>
+impl::IfNative<T, Rational> operator/(const Rational& u, T v)
 {
-    Unsigned w = *this * v;
-    *this = std::move(w);
-    return *this;
+    Rational w(u);
+    w /= v;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline Unsigned& Unsigned::operator/=(const Unsigned& v)
+template<typename T>
+impl::IfNative<T, Rational> operator/(T v, const Rational& u)
 {
-    Unsigned w = *this / v;
-    *this = std::move(w);
-    return *this;
+    return Rational(impl::toSigned(v)) / u;
 }
 //------------------------------------------------------------------------------
-inline Unsigned& Unsigned::operator%=(const Unsigned& v)
+template<typename T>
+impl::IfNative<T, bool> operator==(const Rational& u, T v)
 {
-    Unsigned w = *this % v;
-    *this = std::move(w);
-    return *this;
+    return (u.denominator() == 1) && (u.numerator() == v);
 }
 //------------------------------------------------------------------------------
-inline Unsigned Unsigned::div(const Unsigned& v)
+template<typename T>
+impl::IfNative<T, bool> operator==(T v, const Rational& u)
 {
-    Unsigned::QR qr = ::bn::div(*this, v);
-    *this = std::move(qr.quot);
-    return qr.rem;
+    return u == v;
 }
 //------------------------------------------------------------------------------
-inline bool Unsigned::empty() const
+template<typename T>
+impl::IfNative<T, bool> operator!=(const Rational& u, T v)
 {
-    return digit.size() == 0;
+    return !(u == v);
 }
 //------------------------------------------------------------------------------
-inline std::size_t Unsigned::bits() const
+template<typename T>
+impl::IfNative<T, bool> operator!=(T v, const Rational& u)
 {
-    return impl::bitsPerDigit * digit.size() - countLeadingZeroes();
+    return !(u == v);
 }
 //------------------------------------------------------------------------------
-inline std::size_t Unsigned::ctz() const
+template<typename T>
+impl::IfNative<T, bool> operator<(const Rational& u, T v)
 {
-    std::size_t ret = 0;
-    std::size_t i = 0;
-    while ((i < digit.size()) && (digit[i] == 0)) {
-        ret += impl::bitsPerDigit;
-        ++i;
-    }
-    if (i < digit.size()) {
-        ret += impl::countTrailingZeroes(digit[i]);
-    }
-    return ret;
+    return impl::compare(u, impl::magnitude(v), impl::signum(v)) < 0;
 }
 //------------------------------------------------------------------------------
-inline Unsigned::operator std::uint64_t() const
+template<typename T>
+impl::IfNative<T, bool> operator<(T v, const Rational& u)
 {
-    if (bits() > 64) {
-        throw std::overflow_error("this does not fit in a uint64_t");
-    }
-    const std::size_t n = digit.size();
-    std::uint64_t ret = 0;
-    for (std::size_t i = 0; i < n; ++i) {
-        ret |= static_cast<uint64_t>(digit[i]) << (i * impl::bitsPerDigit);
-    }
-    return ret;
+    return impl::compare(u, impl::magnitude(v), impl::signum(v)) > 0;
 }
 //------------------------------------------------------------------------------
-inline std::string Unsigned::str() const
+template<typename T>
+impl::IfNative<T, bool> operator>=(const Rational& u, T v)
 {
-    if (digit.size() == 0) {
-        return std::string("0");
-    }
-    Unsigned temp = *this;
-    constexpr double log256 = 2.4082399653118496;
-    std::size_t numBytes = sizeof(impl::digit_t) * temp.digit.size();
-    std::size_t reserveDigits =
-        static_cast<std::size_t>(std::ceil(numBytes * log256))
-        + impl::maxDecDigitsPerDigit;
-    std::string s;
-    s.reserve(reserveDigits);
-    while (temp.digit.size() > 0) {
-        impl::digit_t mod = temp.divideByDigitReturnRem(impl::maxPow10PerDigit);
-        for (unsigned i = 0; i < impl::maxDecDigitsPerDigit; ++i) {
-            s.push_back('0' + static_cast<char>(mod % 10));
-            mod /= 10;
-        }
-    }
-    while (s.back() == '0') {
-        s.pop_back();
-    }
-    std::reverse(s.begin(), s.end());
-    return s;
+    return !(u < v);
 }
 //------------------------------------------------------------------------------
-inline std::size_t Unsigned::digits() const
+template<typename T>
+impl::IfNative<T, bool> operator>=(T v, const Rational& u)
 {
-    return digit.size();
+    return !(v < u);
 }
 //------------------------------------------------------------------------------
-template<int S, typename T>
-typename std::enable_if<S >= 8 * sizeof(T), T>::type Unsigned::safeRightShift(T)
+template<typename T>
+impl::IfNative<T, bool> operator>(const Rational& u, T v)
 {
-    return 0;
+    return v < u;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+impl::IfNative<T, bool> operator>(T v, const Rational& u)
+{
+    return u < v;
 }
 //------------------------------------------------------------------------------
-template<int S, typename T>
-    typename std::enable_if
-    < S<8 * sizeof(T), T>::type Unsigned::safeRightShift(T val)
+template<typename T>
+impl::IfNative<T, bool> operator<=(const Rational& u, T v)
 {
-    return val >> S;
+    return !(v < u);
 }
 //------------------------------------------------------------------------------
 template<typename T>
-void Unsigned::initFromIntegral(T val)
+impl::IfNative<T, bool> operator<=(T v, const Rational& u)
 {
-    const std::size_t n =
-        std::max<std::size_t>(sizeof(val) / sizeof(impl::digit_t), 1);
-    digit.resize(n);
-    std::size_t i = 0;
-    for (; val != 0; ++i, val = safeRightShift<impl::bitsPerDigit>(val)) {
-        digit[i] = static_cast<impl::digit_t>(val);
-    }
-    digit.resize(i);
+    return !(u < v);
 }
 //------------------------------------------------------------------------------
-template<std::size_t BPD, typename Generator>
-typename std::enable_if<(BPD < 8 * sizeof(unsigned)), Unsigned>::type
-    Unsigned::generateRandom(std::size_t numBits, Generator& gen)
+inline std::ostream& operator<<(std::ostream& out, const Rational& u)
 {
-    static_assert(
-        (8 * sizeof(unsigned)) % BPD == 0,
-        "bitsPerDigit must divide 8*sizeof(unsigned)");
-    Unsigned w;
-    const std::size_t n = (numBits - 1) / BPD + 1;
-    w.digit.resize(n);
-    unsigned r;
-    std::size_t rbits = 0;
-    std::uniform_int_distribution<unsigned> dis;
-    for (std::size_t i = 0; i < n; ++i) {
-        if (rbits == 0) {
-            r = dis(gen);
-            rbits = 8 * sizeof(unsigned);
-        }
-        w.digit[i] = static_cast<impl::digit_t>(r);
-        r >>= BPD;
-        rbits -= BPD;
-    }
-    w.randomGenMaskHighest(numBits % BPD);
-    w.removeLeadingZeroDigits();
-    return w;
+    out << u.num << "/" << u.den;
+    return out;
 }
 //------------------------------------------------------------------------------
-template<std::size_t BPD, typename Generator>
-typename std::enable_if<(BPD == 8 * sizeof(unsigned)), Unsigned>::type
-    Unsigned::generateRandom(std::size_t numBits, Generator& gen)
+namespace impl {
+//------------------------------------------------------------------------------
+constexpr unsigned serialVersion = 1;
+// Kinds of serialized numbers stored in the lower four bits of the tag.
+constexpr unsigned serialNegative = 1;
+constexpr unsigned serialRational = 2;
+// Magnitudes read from streams are buffered in chunks of this size, so that a
+// corrupt length cannot trigger a huge allocation before the data is read.
+constexpr std::size_t serialStreamChunk = 65536;
+//------------------------------------------------------------------------------
+inline std::size_t varintSize(std::size_t v)
 {
-    Unsigned w;
-    const std::size_t n = (numBits - 1) / BPD + 1;
-    w.digit.resize(n);
-    std::uniform_int_distribution<unsigned> dis;
-    for (std::size_t i = 0; i < n; ++i) {
-        w.digit[i] = dis(gen);
+    std::size_t n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        ++n;
     }
-    w.randomGenMaskHighest(numBits % BPD);
-    w.removeLeadingZeroDigits();
-    return w;
+    return n;
 }
 //------------------------------------------------------------------------------
-template<std::size_t BPD, typename Generator>
-typename std::enable_if<(BPD > 8 * sizeof(unsigned)), Unsigned>::type
-    Unsigned::generateRandom(std::size_t numBits, Generator& gen)
+inline unsigned char* writeVarint(unsigned char* p, std::size_t v)
 {
-    static_assert(
-        BPD % (8 * sizeof(unsigned)) == 0,
-        "8*sizeof(unsigned) must divide bitsPerDigit");
-    Unsigned w;
-    const std::size_t n = (numBits - 1) / BPD + 1;
-    w.digit.resize(n);
-    std::uniform_int_distribution<unsigned> dis;
-    for (std::size_t i = 0; i < n; ++i) {
-        w.digit[i] = dis(gen);
-        for (std::size_t j = 1; j < BPD / (8 * sizeof(unsigned)); ++j) {
-            w.digit[i] = (w.digit[i] << (8 * sizeof(unsigned))) | dis(gen);
-        }
+    while (v >= 0x80) {
+        *p++ = static_cast<unsigned char>(v | 0x80);
+        v >>= 7;
     }
-    w.randomGenMaskHighest(numBits % BPD);
-    w.removeLeadingZeroDigits();
-    return w;
+    *p++ = static_cast<unsigned char>(v);
+    return p;
 }
 //------------------------------------------------------------------------------
-inline void Unsigned::randomGenMaskHighest(std::size_t mb)
+inline std::size_t serializedMagnitudeSize(const Unsigned& u)
 {
-    if (mb == 0) {
-        return;
-    }
-    impl::digit_t mask = 1;
-    for (std::size_t i = 1; i < mb; ++i) {
-        mask = (mask << 1) | 1;
-    }
-    const std::size_t n = digit.size();
-    digit[n - 1] &= mask;
-    removeLeadingZeroDigits();
+    const std::size_t len = (u.bits() + 7) / 8;
+    return varintSize(len) + len;
 }
 //------------------------------------------------------------------------------
-inline std::size_t Unsigned::countLeadingZeroes() const
+inline unsigned char* writeMagnitude(unsigned char* p, const Unsigned& u)
 {
-    const std::size_t n = digit.size();
-    if (n == 0) {
-        return 0;
-    }
-    return ::bn::impl::countLeadingZeroes(digit[n - 1]);
+    const std::size_t len = (u.bits() + 7) / 8;
+    p = writeVarint(p, len);
+    u.toBytes(p, len);
+    return p + len;
 }
 //------------------------------------------------------------------------------
-inline void Unsigned::addDigit(impl::digit_t d)
+inline std::size_t writeSerialized(
+    void* buf,
+    std::size_t len,
+    unsigned kind,
+    const Unsigned& m)
 {
-    const std::size_t n = digit.size();
-    if (n == 0) {
-        if (d != 0) {
-            digit.resize(1);
-            digit[0] = d;
-        }
-        return;
-    }
-    bool carry = false;
-    digit[0] = impl::addCarry(digit[0], d, carry);
-    for (std::size_t i = 1; (i < n) && carry; ++i) {
-        digit[i] = impl::addCarry(digit[i], 0, carry);
-    }
-    if (carry) {
-        digit.resize(n + 1);
-        digit[n] = 1;
+    if (len < 1 + serializedMagnitudeSize(m)) {
+        throw std::length_error("buffer too small");
     }
+    unsigned char* p = static_cast<unsigned char*>(buf);
+    *p = static_cast<unsigned char>((serialVersion << 4) | kind);
+    return static_cast<std::size_t>(writeMagnitude(p + 1, m) - p);
 }
 //------------------------------------------------------------------------------
-inline void Unsigned::subtractDigit(impl::digit_t d)
+// Checks the version and returns the kind of a tag byte.
+inline unsigned checkSerialTag(unsigned char tag)
 {
-    const std::size_t n = digit.size();
-    if ((n == 0) || ((n == 1) && (d > digit[0]))) {
-        throw std::logic_error("result would be negative");
+    if ((tag >> 4) != serialVersion) {
+        throw std::invalid_argument("unsupported serialization version");
     }
-    bool borrow = false;
-    digit[0] = impl::subBorrow(digit[0], d, borrow);
-    for (std::size_t i = 1; (i < n) && borrow; ++i) {
-        digit[i] = impl::subBorrow(digit[i], 0, borrow);
+    const unsigned kind = tag & 0xfu;
+    if (kind > (serialRational | serialNegative)) {
+        throw std::invalid_argument("invalid serialization tag");
     }
-    removeLeadingZeroDigits();
+    return kind;
 }
 //------------------------------------------------------------------------------
-inline void Unsigned::multiplyByDigit(impl::digit_t d)
+// Reads the next byte of a varint and adds it to v.
+inline bool addVarintByte(unsigned char b, unsigned& shift, std::size_t& v)
 {
-    const std::size_t n = digit.size();
-    impl::digit_t carry = 0;
-    for (size_t i = 0; i < n; ++i) {
-        digit[i] = impl::multiplyAdd(digit[i], d, carry);
-    }
-    if (carry != 0) {
-        digit.resize(n + 1);
-        digit[n] = carry;
+    const std::size_t bits = b & 0x7fu;
+    if ((shift >= 8 * sizeof(std::size_t))
+        || ((bits << shift) >> shift != bits)) {
+        throw std::invalid_argument("serialized length too large");
     }
+    v |= bits << shift;
+    shift += 7;
+    return (b & 0x80) != 0;
 }
 //------------------------------------------------------------------------------
-inline impl::digit_t Unsigned::divideByDigitReturnRem(impl::digit_t d)
+// Parses serialized data from a buffer.
+class SerialReader
 {
-    assert(d != 0);
-    if (d == 1) {
-        return 0;
-    }
-    const std::size_t n = digit.size();
-    impl::digit_t remainder = 0;
-    for (std::size_t i = n; i != 0; --i) {
-        digit[i - 1] = impl::divideRemainder(digit[i - 1], d, remainder);
+public:
+    SerialReader(const void* buf, std::size_t len)
+        : first(static_cast<const unsigned char*>(buf)), p(first), end(p + len)
+    {
     }
-    if (digit[n - 1] == 0) {
-        digit.resize(n - 1);
+
+    unsigned tag()
+    {
+        need(1);
+        return checkSerialTag(*p++);
     }
-    return remainder;
-}
-//------------------------------------------------------------------------------
-inline impl::digit_t Unsigned::findDivQuotient(
-    impl::digit_t un,
-    impl::digit_t un1,
-    impl::digit_t un2,
-    impl::digit_t vn1,
-    impl::digit_t vn2)
-{
-    assert(vn1 & (static_cast<impl::digit_t>(1) << (impl::bitsPerDigit - 1)));
 
-    if (un < vn1) {
-        impl::digit_t r = un;
-        impl::digit_t q = impl::divideRemainder(un1, vn1, r);
+    Unsigned magnitude()
+    {
+        std::size_t len = 0;
+        unsigned shift = 0;
+        do {
+            need(1);
+        } while (addVarintByte(*p++, shift, len));
+        need(len);
+        Unsigned m = Unsigned::fromBytes(p, len);
+        p += len;
+        return m;
+    }
 
-        impl::digit_t carry = 0;
-        impl::digit_t p1 = impl::multiplyAdd(q, vn2, carry);
-        if ((carry < r) || ((carry == r) && (p1 <= un2))) {
-            return q;
-        }
+    std::size_t consumed() const
+    {
+        return static_cast<std::size_t>(p - first);
+    }
 
-        bool acarry = false;
-        r = impl::addCarry(r, vn1, acarry);
-        if (acarry) {
-            return q - 1;
+private:
+    void need(std::size_t n) const
+    {
+        if (static_cast<std::size_t>(end - p) < n) {
+            throw std::invalid_argument("serialized data is truncated");
         }
+    }
 
-        bool borrow = false;
-        p1 = impl::subBorrow(p1, vn2, borrow);
-        carry -= borrow;
-        if ((carry < r) || ((carry == r) && (p1 <= un2))) {
-            return q - 1;
-        }
-        return q - 2;
+private:
+    const unsigned char* first;
+    const unsigned char* p;
+    const unsigned char* end;
+};
+//------------------------------------------------------------------------------
+// Parses serialized data from a stream.
+class SerialStreamReader
+{
+public:
+    explicit SerialStreamReader(std::istream& in) : in(in)
+    {
     }
 
-    bool borrow = false;
-    un1 = impl::subBorrow(un1, vn1, borrow);
-    un -= borrow;
-    if (un < vn1) {
-        impl::digit_t r = un;
-        impl::digit_t q = impl::divideRemainder(un1, vn1, r);
+    unsigned tag()
+    {
+        return checkSerialTag(get());
+    }
 
-        bool acarry = false;
-        r = impl::addCarry(r, vn1, acarry);
-        if (acarry) {
-            return q;
+    Unsigned magnitude()
+    {
+        std::size_t len = 0;
+        unsigned shift = 0;
+        while (addVarintByte(get(), shift, len)) {
+        }
+        std::vector<unsigned char> bytes;
+        while (bytes.size() < len) {
+            const std::size_t pos = bytes.size();
+            const std::size_t n = std::min(len - pos, serialStreamChunk);
+            bytes.resize(pos + n);
+            if (!in.read(
+                    reinterpret_cast<char*>(&bytes[pos]),
+                    static_cast<std::streamsize>(n))) {
+                throw std::invalid_argument("serialized data is truncated");
+            }
         }
+        return Unsigned::fromBytes(bytes.data(), bytes.size());
+    }
 
-        impl::digit_t carry = 0;
-        impl::digit_t p1 = impl::multiplyAdd(q, vn2, carry);
-        if ((carry < r) || ((carry == r) && (p1 <= un2))) {
-            return q;
+private:
+    unsigned char get()
+    {
+        char c;
+        if (!in.get(c)) {
+            throw std::invalid_argument("serialized data is truncated");
         }
-        return q - 1;
+        return static_cast<unsigned char>(c);
     }
 
-    un1 -= vn1;
-    impl::digit_t r = un - 1;
-    impl::digit_t q = impl::divideRemainder(un1, vn1, r);
-    return q;
-}
+private:
+    std::istream& in;
+};
 //------------------------------------------------------------------------------
-inline impl::digit_t Unsigned::findDivQuotient(
-    const Unsigned& u,
-    std::size_t ls,
-    impl::digit_t vn1,
-    impl::digit_t vn2,
-    std::size_t i)
+template<typename Reader>
+Unsigned readUnsigned(Reader& reader)
 {
-    assert(u.digit.size() >= 3);
-    assert(i < u.digit.size());
-    if (ls == 0) {
-        return findDivQuotient(
-            u.digit[i], u.digit[i - 1], u.digit[i - 2], vn1, vn2);
+    if (reader.tag() != 0) {
+        throw std::invalid_argument("serialized data is no natural number");
     }
-    const std::size_t rs = impl::bitsPerDigit - ls;
-    impl::digit_t un = (u.digit[i] << ls) | (u.digit[i - 1] >> rs);
-    impl::digit_t un1 = (u.digit[i - 1] << ls) | (u.digit[i - 2] >> rs);
-    impl::digit_t un2 = (u.digit[i - 2] << ls);
-    if ((i - 2) > 0) {
-        un2 |= u.digit[i - 3] >> rs;
+    return reader.magnitude();
+}
+//------------------------------------------------------------------------------
+template<typename Reader>
+Signed readSigned(Reader& reader)
+{
+    const unsigned kind = reader.tag();
+    if ((kind & serialRational) != 0) {
+        throw std::invalid_argument("serialized data is no integer");
     }
-    return findDivQuotient(un, un1, un2, vn1, vn2);
+    Signed s(reader.magnitude());
+    return (kind & serialNegative) ? -s : s;
 }
 //------------------------------------------------------------------------------
-inline void Unsigned::removeLeadingZeroDigits()
+template<typename Reader>
+Rational readRational(Reader& reader)
 {
-    std::size_t n = digit.size();
-    while ((n > 0) && (digit[n - 1] == 0)) {
-        --n;
+    const unsigned kind = reader.tag();
+    Rational r;
+    r.num = Signed(reader.magnitude());
+    if (kind & serialNegative) {
+        r.num = -r.num;
     }
-    digit.resize(n);
+    if ((kind & serialRational) != 0) {
+        r.den = reader.magnitude();
+        if (r.den.empty()) {
+            throw std::invalid_argument("den is 0");
+        }
+        // Checks the reduced form without dividing, which also rejects a
+        // numerator of 0 over a denominator other than 1.
+        if (gcd(r.num.abs(), r.den) != 1) {
+            throw std::invalid_argument("fraction is not reduced");
+        }
+    }
+    return r;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+void writeSerializedToStream(std::ostream& out, const T& t)
+{
+    std::vector<unsigned char> bytes(serializedSize(t));
+    serialize(bytes.data(), bytes.size(), t);
+    out.write(
+        reinterpret_cast<const char*>(bytes.data()),
+        static_cast<std::streamsize>(bytes.size()));
+}
+//------------------------------------------------------------------------------
+}  // namespace impl
+//------------------------------------------------------------------------------
+inline std::size_t serializedSize(const Unsigned& u)
+{
+    return 1 + impl::serializedMagnitudeSize(u);
+}
+//------------------------------------------------------------------------------
+inline std::size_t serializedSize(const Signed& s)
+{
+    return 1 + impl::serializedMagnitudeSize(s.abs());
+}
+//------------------------------------------------------------------------------
+inline std::size_t serializedSize(const Rational& r)
+{
+    return 1 + impl::serializedMagnitudeSize(r.numerator().abs())
+         + impl::serializedMagnitudeSize(r.denominator());
+}
+//------------------------------------------------------------------------------
+inline std::size_t serialize(void* buf, std::size_t len, const Unsigned& u)
+{
+    return impl::writeSerialized(buf, len, 0, u);
+}
+//------------------------------------------------------------------------------
+inline std::size_t serialize(void* buf, std::size_t len, const Signed& s)
+{
+    const unsigned kind = (s.sgn() < 0) ? impl::serialNegative : 0;
+    return impl::writeSerialized(buf, len, kind, s.abs());
 }
 //------------------------------------------------------------------------------
-inline bool operator==(const Unsigned& u, const Unsigned& v)
+inline std::size_t serialize(void* buf, std::size_t len, const Rational& r)
 {
-    if (u.digit.size() != v.digit.size()) {
-        return false;
-    }
-    const std::size_t n = u.digit.size();
-    for (std::size_t i = 0; i < n; ++i) {
-        if (u.digit[i] != v.digit[i]) {
-            return false;
-        }
+    if (len < serializedSize(r)) {
+        throw std::length_error("buffer too small");
     }
-    return true;
+    const unsigned sign = (r.numerator().sgn() < 0) ? impl::serialNegative : 0;
+    const unsigned kind = impl::serialRational | sign;
+    unsigned char* p = static_cast<unsigned char*>(buf);
+    *p = static_cast<unsigned char>((impl::serialVersion << 4) | kind);
+    unsigned char* q = impl::writeMagnitude(p + 1, r.numerator().abs());
+    q = impl::writeMagnitude(q, r.denominator());
+    return static_cast<std::size_t>(q - p);
 }
 //------------------------------------------------------------------------------
-inline bool operator!=(const Unsigned& u, const Unsigned& v)
+inline void serialize(std::ostream& out, const Unsigned& u)
 {
-    return !(u == v);
+    impl::writeSerializedToStream(out, u);
 }
 //------------------------------------------------------------------------------
-inline bool operator<(const Unsigned& u, const Unsigned& v)
+inline void serialize(std::ostream& out, const Signed& s)
 {
-    if (u.digit.size() != v.digit.size()) {
-        return u.digit.size() < v.digit.size();
-    }
-    const std::size_t n = u.digit.size();
-    for (std::size_t i = n; i != 0; --i) {
-        if (u.digit[i - 1] == v.digit[i - 1]) {
-            continue;
-        }
-        return u.digit[i - 1] < v.digit[i - 1];
-    }
-    return false;
+    impl::writeSerializedToStream(out, s);
 }
 //------------------------------------------------------------------------------
-inline bool operator>=(const Unsigned& u, const Unsigned& v)
+inline void serialize(std::ostream& out, const Rational& r)
 {
-    return !(u < v);
+    impl::writeSerializedToStream(out, r);
 }
 //------------------------------------------------------------------------------
-inline bool operator>(const Unsigned& u, const Unsigned& v)
+inline std::size_t deserialize(const void* buf, std::size_t len, Unsigned& u)
 {
-    return v < u;
+    impl::SerialReader reader(buf, len);
+    u = impl::readUnsigned(reader);
+    return reader.consumed();
 }
 //------------------------------------------------------------------------------
-inline bool operator<=(const Unsigned& u, const Unsigned& v)
+inline std::size_t deserialize(const void* buf, std::size_t len, Signed& s)
 {
-    return !(v < u);
+    impl::SerialReader reader(buf, len);
+    s = impl::readSigned(reader);
+    return reader.consumed();
 }
 //------------------------------------------------------------------------------
-inline Unsigned operator|(const Unsigned& pu, const Unsigned& pv)
+inline std::size_t deserialize(const void* buf, std::size_t len, Rational& r)
 {
-    const Unsigned& u = pu.digit.size() >= pv.digit.size() ? pu : pv;
-    const Unsigned& v = pu.digit.size() >= pv.digit.size() ? pv : pu;
-    const std::size_t n = u.digit.size();
-    const std::size_t m = v.digit.size();
-    Unsigned w;
-    w.digit.resize(n);
-    for (std::size_t i = 0; i < m; ++i) {
-        w.digit[i] = u.digit[i] | v.digit[i];
-    }
-    for (std::size_t i = m; i < n; ++i) {
-        w.digit[i] = u.digit[i];
-    }
-    return w;
+    impl::SerialReader reader(buf, len);
+    r = impl::readRational(reader);
+    return reader.consumed();
 }
 //------------------------------------------------------------------------------
-inline Unsigned operator&(const Unsigned& u, const Unsigned& v)
+inline void deserialize(std::istream& in, Unsigned& u)
 {
-    Unsigned w;
-    const std::size_t n = std::min(u.digit.size(), v.digit.size());
-    w.digit.resize(n);
-    for (std::size_t i = 0; i < n; ++i) {
-        w.digit[i] = u.digit[i] & v.digit[i];
-    }
-    w.removeLeadingZeroDigits();
-    return w;
+    impl::SerialStreamReader reader(in);
+    u = impl::readUnsigned(reader);
 }
 //------------------------------------------------------------------------------
-inline Unsigned operator^(const Unsigned& pu, const Unsigned& pv)
+inline void deserialize(std::istream& in, Signed& s)
 {
-    const Unsigned& u = pu.digit.size() >= pv.digit.size() ? pu : pv;
-    const Unsigned& v = pu.digit.size() >= pv.digit.size() ? pv : pu;
-    const std::size_t n = u.digit.size();
-    const std::size_t m = v.digit.size();
-    Unsigned w;
-    w.digit.resize(n);
-    for (std::size_t i = 0; i < m; ++i) {
-        w.digit[i] = u.digit[i] ^ v.digit[i];
-    }
-    for (std::size_t i = m; i < n; ++i) {
-        w.digit[i] = u.digit[i];
-    }
-    w.removeLeadingZeroDigits();
-    return w;
+    impl::SerialStreamReader reader(in);
+    s = impl::readSigned(reader);
 }
 //------------------------------------------------------------------------------
-inline Unsigned operator<<(const Unsigned& u, std::size_t s)
+inline void deserialize(std::istream& in, Rational& r)
 {
-    if (s == 0) {
-        return u;
+    impl::SerialStreamReader reader(in);
+    r = impl::readRational(reader);
+}
+//------------------------------------------------------------------------------
+template<typename A, typename P, typename Q>
+PQT binarySplit(
+    std::size_t n1, std::size_t n2, const A& a, const P& p, const Q& q)
+{
+    if (n2 <= n1) {
+        return PQT{Signed(1), Signed(1), Signed()};
     }
-    const std::size_t n = u.digit.size();
-    if (n == 0) {
-        return u;
+    if (n2 - n1 == 1) {
+        PQT r{p(n1), q(n1), Signed()};
+        r.t = a(n1) * r.p;
+        return r;
     }
-    const std::size_t ds = s / impl::bitsPerDigit;
-    const std::size_t lbs = s % impl::bitsPerDigit;
-    Unsigned w;
-    if (lbs == 0) {
-        w.digit.resize(n + ds);
-        for (size_t i = 0; i < n; ++i) {
-            w.digit[i + ds] = u.digit[i];
-        }
-        for (size_t i = 0; i < ds; ++i) {
-            w.digit[i] = 0;
+    const std::size_t m = n1 + (n2 - n1) / 2;
+    PQT l;
+    PQT r;
+    auto half = [&](std::size_t i) {
+        if (i == 0) {
+            l = binarySplit(n1, m, a, p, q);
+        } else {
+            r = binarySplit(m, n2, a, p, q);
         }
-        return w;
-    }
-    const std::size_t rbs = impl::bitsPerDigit - lbs;
-    const std::size_t lz = u.countLeadingZeroes();
-    if (lbs > lz) {
-        w.digit.resize(n + ds + 1);
-        w.digit[n + ds] = u.digit[n - 1] >> rbs;
+    };
+    if (n2 - n1 >= impl::parallelSplitThreshold) {
+        impl::ThreadPool::instance().run(2, half);
     } else {
-        w.digit.resize(n + ds);
+        half(0);
+        half(1);
     }
-    for (std::size_t i = 0; i < n - 1; ++i) {
-        w.digit[ds + n - i - 1] =
-            (u.digit[n - i - 1] << lbs) | (u.digit[n - i - 2] >> rbs);
+    l.t *= r.q;
+    r.t *= l.p;
+    l.t += r.t;
+    l.p *= r.p;
+    l.q *= r.q;
+    return l;
+}
+//------------------------------------------------------------------------------
+namespace impl {
+//------------------------------------------------------------------------------
+// Number of additional decimal digits computed for the constants to absorb the
+// truncation errors of the series and of the square root.
+constexpr std::size_t constantGuardDigits = 10;
+//------------------------------------------------------------------------------
+}  // namespace impl
+//------------------------------------------------------------------------------
+inline Unsigned pi(std::size_t digits)
+{
+    // Chudnovsky: 1/pi = 12/640320^(3/2) * sum (-1)^n*(6n)!*(13591409 +
+    // 545140134*n) / ((3n)!*(n!)^3*640320^(3n)). Every term adds about 14.18
+    // decimal digits.
+    const std::size_t pd = digits + impl::constantGuardDigits;
+    const std::size_t n = pd / 14 + 2;
+    const Unsigned a0 = std::uint64_t(13591409);
+    const Unsigned a1 = std::uint64_t(545140134);
+    const Unsigned c3over24 = std::uint64_t(10939058860032000);
+    PQT s = binarySplit(
+        0,
+        n,
+        [&a0, &a1](std::size_t k) -> Signed {
+            return a0 + a1 * Unsigned(std::uint64_t(k));
+        },
+        [](std::size_t k) -> Signed {
+            if (k == 0) {
+                return 1;
+            }
+            const std::uint64_t k64 = k;
+            return -Signed(
+                Unsigned(6 * k64 - 5) * Unsigned(2 * k64 - 1)
+                * Unsigned(6 * k64 - 1));
+        },
+        [&c3over24](std::size_t k) -> Signed {
+            if (k == 0) {
+                return 1;
+            }
+            const Unsigned uk = std::uint64_t(k);
+            return uk * uk * uk * c3over24;
+        });
+    // pi = 426880*sqrt(10005)*Q/T
+    const Unsigned scale = pow(Unsigned(10), pd);
+    const Unsigned root = sqrt(Unsigned(10005) * scale * scale);
+    const Unsigned w = Unsigned(426880) * root * s.q.abs() / s.t.abs();
+    return w / pow(Unsigned(10), impl::constantGuardDigits);
+}
+//------------------------------------------------------------------------------
+inline Unsigned e(std::size_t digits)
+{
+    // The number of terms n must satisfy n! > 10^pd.
+    const std::size_t pd = digits + impl::constantGuardDigits;
+    std::size_t n = 1;
+    double lf = 0.0;
+    while (lf <= static_cast<double>(pd)) {
+        ++n;
+        lf += std::log10(static_cast<double>(n));
+    }
+    PQT s = binarySplit(
+        0,
+        n + 1,
+        [](std::size_t) -> Signed { return 1; },
+        [](std::size_t) -> Signed { return 1; },
+        [](std::size_t k) -> Signed {
+            return Unsigned(std::uint64_t(k == 0 ? 1 : k));
+        });
+    const Unsigned w = s.t.abs() * pow(Unsigned(10), pd) / s.q.abs();
+    return w / pow(Unsigned(10), impl::constantGuardDigits);
+}
+//------------------------------------------------------------------------------
+inline Unsigned log2(std::size_t digits)
+{
+    // The ratio of two consecutive terms is -n/(4*(2n+1)), so every term adds
+    // about log10(8) decimal digits.
+    const std::size_t pd = digits + impl::constantGuardDigits;
+    const std::size_t n = pd + pd / 8 + 2;
+    PQT s = binarySplit(
+        0,
+        n,
+        [](std::size_t) -> Signed { return 1; },
+        [](std::size_t k) -> Signed {
+            return (k == 0) ? Signed(1) : -Signed(std::uint64_t(k));
+        },
+        [](std::size_t k) -> Signed {
+            return (k == 0) ? Signed(1) : Signed(8 * std::uint64_t(k) + 4);
+        });
+    const Unsigned w = Unsigned(3) * s.t.abs() * pow(Unsigned(10), pd)
+                     / (Unsigned(4) * s.q.abs());
+    return w / pow(Unsigned(10), impl::constantGuardDigits);
+}
+//------------------------------------------------------------------------------
+inline ContinuedFraction::ContinuedFraction(const Rational& x)
+    : hasFirst(true), bufferPos(0), bufferSize(0)
+{
+    const Unsigned& d = x.denominator();
+    Unsigned::QR qr = div(x.numerator().abs(), d);
+    if (x.numerator().sgn() >= 0) {
+        first = std::move(qr.quot);
+        v = std::move(qr.rem);
+    } else if (qr.rem.empty()) {
+        first = -Signed(std::move(qr.quot));
+    } else {
+        first = -Signed(++qr.quot);
+        v = d - qr.rem;
     }
-    w.digit[ds] = u.digit[0] << lbs;
-    for (std::size_t i = 0; i < ds; ++i) {
-        w.digit[i] = 0;
+    if (!v.empty()) {
+        u = d;
     }
-    return w;
 }
 //------------------------------------------------------------------------------
-inline Unsigned operator>>(const Unsigned& u, std::size_t s)
+inline bool ContinuedFraction::hasNext() const
 {
-    if (s == 0) {
-        return u;
-    }
-    const std::size_t n = u.digit.size();
-    if (n == 0) {
-        return u;
+    return hasFirst || (bufferPos < bufferSize) || !v.empty();
+}
+//------------------------------------------------------------------------------
+inline Signed ContinuedFraction::next()
+{
+    if (hasFirst) {
+        hasFirst = false;
+        return first;
     }
-    Unsigned w;
-    const std::size_t lz = u.countLeadingZeroes();
-    const std::size_t nb = n * impl::bitsPerDigit - lz;
-    if (s >= nb) {
-        return w;
+    if (bufferPos == bufferSize) {
+        if (v.empty()) {
+            throw std::logic_error("no more terms");
+        }
+        refill();
+        if (bufferSize == 0) {
+            // The quotient is too large to be determined from the leading bits
+            Unsigned r = u.div(v);
+            Signed q(std::move(u));
+            u = std::move(v);
+            v = std::move(r);
+            return q;
+        }
     }
-    const std::size_t ds = s / impl::bitsPerDigit;
-    const std::size_t rbs = s % impl::bitsPerDigit;
-    if (rbs == 0) {
-        const std::size_t m = n - ds;
-        w.digit.resize(m);
-        for (std::size_t i = 0; i < m; ++i) {
-            w.digit[i] = u.digit[ds + i];
+    return Signed(buffer[bufferPos++]);
+}
+//------------------------------------------------------------------------------
+inline void ContinuedFraction::refill()
+{
+    bufferPos = 0;
+    bufferSize = 0;
+    if (u.bits() <= 64) {
+        std::uint64_t a = static_cast<std::uint64_t>(u);
+        std::uint64_t b = static_cast<std::uint64_t>(v);
+        while ((b != 0) && (bufferSize < maxBuffered)) {
+            const std::uint64_t q = a / b;
+            const std::uint64_t r = a - q * b;
+            buffer[bufferSize++] = q;
+            a = b;
+            b = r;
         }
-        return w;
+        u = a;
+        v = b;
+        return;
     }
-    const std::size_t lbs = impl::bitsPerDigit - rbs;
-    const std::size_t m = (nb - s - 1) / impl::bitsPerDigit + 1;
-    w.digit.resize(m);
-    for (std::size_t i = 0; i < n - ds - 1; ++i) {
-        w.digit[i] = (u.digit[i + ds] >> rbs) | (u.digit[i + ds + 1] << lbs);
+    lehmerStep();
+}
+//------------------------------------------------------------------------------
+inline void ContinuedFraction::lehmerStep()
+{
+    const std::size_t ub = u.bits();
+    if (ub - v.bits() > lehmerBits / 2) {
+        return;
     }
-    if (lz < lbs) {
-        w.digit[n - ds - 1] = u.digit[n - 1] >> rbs;
+    // Knuth, TAOCP Vol. 2, Algorithm 4.5.2L: simulate the Euclidean algorithm
+    // on the leading bits as long as the quotients are guaranteed to be the
+    // same as for the full numbers.
+    const std::size_t shift = ub - lehmerBits;
+    std::int64_t uh = static_cast<std::int64_t>(
+        static_cast<std::uint64_t>(u >> shift));
+    std::int64_t vh = static_cast<std::int64_t>(
+        static_cast<std::uint64_t>(v >> shift));
+    std::int64_t a = 1;
+    std::int64_t b = 0;
+    std::int64_t c = 0;
+    std::int64_t d = 1;
+    while (bufferSize < maxBuffered) {
+        if ((vh + c <= 0) || (vh + d <= 0) || (uh + a < 0) || (uh + b < 0)) {
+            break;
+        }
+        const std::int64_t q = (uh + a) / (vh + c);
+        if (q != (uh + b) / (vh + d)) {
+            break;
+        }
+        std::int64_t t = a - q * c;
+        a = c;
+        c = t;
+        t = b - q * d;
+        b = d;
+        d = t;
+        t = uh - q * vh;
+        uh = vh;
+        vh = t;
+        buffer[bufferSize++] = static_cast<std::uint64_t>(q);
+    }
+    if (bufferSize == 0) {
+        return;
     }
-    return w;
+    Unsigned nu = combine(u, a, v, b);
+    Unsigned nv = combine(u, c, v, d);
+    u = std::move(nu);
+    v = std::move(nv);
 }
 //------------------------------------------------------------------------------
-inline Unsigned operator+(const Unsigned& pu, const Unsigned& pv)
+inline Unsigned ContinuedFraction::combine(
+    const Unsigned& x, std::int64_t f, const Unsigned& y, std::int64_t g)
 {
-    const Unsigned& u = pu.digit.size() >= pv.digit.size() ? pu : pv;
-    const Unsigned& v = pu.digit.size() >= pv.digit.size() ? pv : pu;
-    const std::size_t n = u.digit.size();
-    const std::size_t m = v.digit.size();
-    Unsigned w;
-    w.digit.resize(n + 1);
-    bool carry = false;
-    for (std::size_t i = 0; i < m; ++i) {
-        w.digit[i] = impl::addCarry(u.digit[i], v.digit[i], carry);
+    // The cosequences have alternating signs, so each new remainder is the
+    // difference of two products with single-precision factors.
+    const Unsigned fx = x * static_cast<std::uint64_t>(f < 0 ? -f : f);
+    const Unsigned gy = y * static_cast<std::uint64_t>(g < 0 ? -g : g);
+    if (f < 0) {
+        return gy - fx;
     }
-    std::size_t i;
-    for (i = m; (i < n) && carry; ++i) {
-        w.digit[i] = impl::addCarry(u.digit[i], 0, carry);
+    if (g < 0) {
+        return fx - gy;
     }
-    for (; i < n; ++i) {
-        w.digit[i] = u.digit[i];
+    return fx + gy;
+}
+//------------------------------------------------------------------------------
+inline ContinuedFraction continuedFraction(const Rational& x)
+{
+    return ContinuedFraction(x);
+}
+//------------------------------------------------------------------------------
+inline Rational bestApproximation(const Rational& x, const Unsigned& maxDen)
+{
+    if (maxDen.empty()) {
+        throw std::invalid_argument("maxDen is 0");
     }
-    if (carry) {
-        w.digit[n] = 1;
+    if (x.den <= maxDen) {
+        return x;
+    }
+    // Compute the convergents h/k until the denominator exceeds maxDen. As the
+    // denominator of x exceeds maxDen, this happens before the expansion ends.
+    ContinuedFraction cf(x);
+    Signed h2 = 0;
+    Signed h1 = 1;
+    Unsigned k2 = 1;
+    Unsigned k1 = 0;
+    while (true) {
+        const Signed a = cf.next();
+        Signed h = a * h1 + h2;
+        Unsigned k = a.abs() * k1 + k2;
+        if (k > maxDen) {
+            break;
+        }
+        h2 = std::move(h1);
+        h1 = std::move(h);
+        k2 = std::move(k1);
+        k1 = std::move(k);
+    }
+    // The best semiconvergent uses the largest multiplier t keeping the
+    // denominator within the bound. It competes with the last convergent:
+    // |x - hs/ks| < |x - h1/k1| <=> |num*ks - hs*den|*k1 < |num*k1 - h1*den|*ks
+    const Unsigned t = (maxDen - k2) / k1;
+    Signed hs = Signed(t) * h1 + h2;
+    Unsigned ks = t * k1 + k2;
+    const Unsigned es = (x.num * ks - hs * x.den).abs() * k1;
+    const Unsigned ec = (x.num * k1 - h1 * x.den).abs() * ks;
+    // Convergents and semiconvergents are always reduced
+    Rational w;
+    if ((es < ec) || ((es == ec) && (ks < k1))) {
+        w.num = std::move(hs);
+        w.den = std::move(ks);
     } else {
-        w.digit.resize(n);
+        w.num = std::move(h1);
+        w.den = std::move(k1);
     }
     return w;
 }
 //------------------------------------------------------------------------------
-inline Unsigned operator-(const Unsigned& u, const Unsigned& v)
+// class FixedUnsigned
+//------------------------------------------------------------------------------
+template<std::size_t Bits>
+constexpr std::size_t FixedUnsigned<Bits>::numDigits;
+//------------------------------------------------------------------------------
+template<std::size_t Bits>
+constexpr FixedUnsigned<Bits>::FixedUnsigned() noexcept : digit()
 {
-    const std::size_t n = u.digit.size();
-    const std::size_t m = v.digit.size();
-    if (m > n) {
-        throw std::invalid_argument("minuend is larger than subtrahend");
+}
+//------------------------------------------------------------------------------
+template<std::size_t Bits>
+template<impl::digit_t... D>
+constexpr FixedUnsigned<Bits>::FixedUnsigned(
+    impl::UnsignedLiteral<D...>) noexcept
+    : digit{D...}
+{
+    static_assert(sizeof...(D) <= numDigits, "literal does not fit");
+}
+//------------------------------------------------------------------------------
+template<std::size_t Bits>
+FixedUnsigned<Bits>::FixedUnsigned(std::int32_t i)
+{
+    if (i < 0) {
+        throw std::invalid_argument("negative integer");
     }
-    Unsigned w;
-    w.digit.resize(n);
-    bool borrow = false;
-    for (std::size_t i = 0; i < m; ++i) {
-        w.digit[i] = impl::subBorrow(u.digit[i], v.digit[i], borrow);
+    initFromIntegral(static_cast<std::uint32_t>(i));
+}
+//------------------------------------------------------------------------------
+template<std::size_t Bits>
+FixedUnsigned<Bits>::FixedUnsigned(std::uint32_t i)
+{
+    initFromIntegral(i);
+}
+//------------------------------------------------------------------------------
+template<std::size_t Bits>
+FixedUnsigned<Bits>::FixedUnsigned(std::int64_t i)
+{
+    if (i < 0) {
+        throw std::invalid_argument("negative integer");
     }
-    std::size_t i;
-    for (i = m; (i < n) && borrow; ++i) {
-        w.digit[i] = impl::subBorrow(u.digit[i], 0, borrow);
+    initFromIntegral(static_cast<std::uint64_t>(i));
+}
+//------------------------------------------------------------------------------
+template<std::size_t Bits>
+FixedUnsigned<Bits>::FixedUnsigned(std::uint64_t i)
+{
+    initFromIntegral(i);
+}
+//------------------------------------------------------------------------------
+template<std::size_t Bits>
+FixedUnsigned<Bits>::FixedUnsigned(const Unsigned& u)
+{
+    const std::size_t n = u.digit.size();
+    if (n > numDigits) {
+        throw std::overflow_error("number does not fit");
     }
-    for (; i < n; ++i) {
-        w.digit[i] = u.digit[i];
+    for (std::size_t i = 0; i < n; ++i) {
+        digit[i] = u.digit[i];
     }
-    if (borrow != 0) {
-        throw std::invalid_argument("minuend is larger than subtrahend");
+    for (std::size_t i = n; i < numDigits; ++i) {
+        digit[i] = 0;
     }
-    w.removeLeadingZeroDigits();
-    return w;
 }
 //------------------------------------------------------------------------------
-inline Unsigned operator*(const Unsigned& u, const Unsigned& v)
+template<std::size_t Bits>
+FixedUnsigned<Bits>& FixedUnsigned<Bits>::operator++()
 {
-    const std::size_t n = u.digit.size();
-    const std::size_t m = v.digit.size();
-    const std::size_t nm = n + m;
-    Unsigned w;
-    w.digit.resize(nm);
-    for (std::size_t i = 0; i < nm; ++i) {
-        w.digit[i] = 0;
-    }
-    for (std::size_t i = 0; i < m; ++i) {
-        impl::digit_t carry = 0;
-        for (std::size_t j = 0; j < n; ++j) {
-            w.digit[i + j] = impl::multiplyAdd2(
-                u.digit[j], v.digit[i], w.digit[i + j], carry);
+    for (std::size_t i = 0; i < numDigits; ++i) {
+        if (++digit[i] != 0) {
+            break;
         }
-        w.digit[i + n] += carry;
     }
-    w.removeLeadingZeroDigits();
-    return w;
+    return *this;
+}
+//------------------------------------------------------------------------------
+template<std::size_t Bits>
+FixedUnsigned<Bits> FixedUnsigned<Bits>::operator++(int)
+{
+    FixedUnsigned ret = *this;
+    ++(*this);
+    return ret;
+}
+//------------------------------------------------------------------------------
+template<std::size_t Bits>
+FixedUnsigned<Bits>& FixedUnsigned<Bits>::operator--()
+{
+    for (std::size_t i = 0; i < numDigits; ++i) {
+        if (digit[i]-- != 0) {
+            break;
+        }
+    }
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline Unsigned operator/(const Unsigned& u, const Unsigned& v)
+template<std::size_t Bits>
+FixedUnsigned<Bits> FixedUnsigned<Bits>::operator--(int)
 {
-    return div(u, v).quot;
+    FixedUnsigned ret = *this;
+    --(*this);
+    return ret;
 }
 //------------------------------------------------------------------------------
-inline Unsigned operator%(const Unsigned& u, const Unsigned& v)
+template<std::size_t Bits>
+FixedUnsigned<Bits>& FixedUnsigned<Bits>::operator|=(const FixedUnsigned& v)
 {
-    return div(u, v).rem;
+    for (std::size_t i = 0; i < numDigits; ++i) {
+        digit[i] |= v.digit[i];
+    }
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline Unsigned::QR div(const Unsigned& u, const Unsigned& v)
+template<std::size_t Bits>
+FixedUnsigned<Bits>& FixedUnsigned<Bits>::operator&=(const FixedUnsigned& v)
 {
-    const std::size_t n = v.digit.size();
-    if (n == 0) {
-        throw std::invalid_argument("division by 0");
-    }
-    if (n > u.digit.size()) {
-        return Unsigned::QR{Unsigned(), u};
-    }
-    if (n == 1) {
-        Unsigned quot = u;
-        Unsigned rem;
-        rem.digit.resize(1);
-        rem.digit[0] = quot.divideByDigitReturnRem(v.digit[0]);
-        rem.removeLeadingZeroDigits();
-        return Unsigned::QR{quot, rem};
-    }
-    const std::size_t m = u.digit.size() - n;
-    Unsigned q;
-    q.digit.resize(m + 1);
-
-    // D1
-    const std::size_t ls = v.countLeadingZeroes();
-    impl::digit_t vn1;
-    impl::digit_t vn2;
-    if (ls == 0) {
-        vn1 = v.digit[n - 1];
-        vn2 = v.digit[n - 2];
-    } else {
-        const std::size_t rs = impl::bitsPerDigit - ls;
-        vn1 = (v.digit[n - 1] << ls) | (v.digit[n - 2] >> rs);
-        vn2 = (v.digit[n - 2] << ls);
-        if (n > 2) {
-            vn2 |= v.digit[n - 3] >> rs;
-        }
-    }
-    Unsigned nu;
-    nu.digit.resize(u.digit.size() + 1);
-    nu.digit = u.digit;
-    nu.digit.resize(u.digit.size() + 1);
-    nu.digit[u.digit.size()] = 0;
-
-    // D2
-    std::size_t j = m;
-    while (true) {
-        // D3
-        impl::digit_t qd = Unsigned::findDivQuotient(nu, ls, vn1, vn2, j + n);
-        // D4
-        impl::digit_t carry = 0;
-        for (std::size_t i = 0; i < n; ++i) {
-            impl::digit_t md = impl::multiplyAdd(qd, v.digit[i], carry);
-            bool borrow = false;
-            nu.digit[i + j] = impl::subBorrow(nu.digit[j + i], md, borrow);
-            carry += borrow;
-        }
-        bool borrow = false;
-        nu.digit[j + n] = impl::subBorrow(nu.digit[j + n], carry, borrow);
-        // D5
-        q.digit[j] = qd;
-        if (borrow) {
-            // D6
-            --q.digit[j];
-            bool acarry = false;
-            for (std::size_t i = 0; i < n; ++i) {
-                nu.digit[j + i] =
-                    impl::addCarry(nu.digit[j + i], v.digit[i], acarry);
-            }
-            nu.digit[j + n] += acarry;
-        }
-        // D7
-        if (j == 0) {
-            break;
-        }
-        --j;
+    for (std::size_t i = 0; i < numDigits; ++i) {
+        digit[i] &= v.digit[i];
     }
-    // D8
-    nu.removeLeadingZeroDigits();
-    q.removeLeadingZeroDigits();
-    return Unsigned::QR{q, nu};
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline Unsigned pow(const Unsigned& u, std::size_t exp)
+template<std::size_t Bits>
+FixedUnsigned<Bits>& FixedUnsigned<Bits>::operator^=(const FixedUnsigned& v)
 {
-    Unsigned r = 1;
-    Unsigned p = u;
-    while (true) {
-        if (exp & 1) {
-            r *= p;
-        }
-        exp >>= 1;
-        if (exp == 0) {
-            return r;
-        }
-        p *= p;
+    for (std::size_t i = 0; i < numDigits; ++i) {
+        digit[i] ^= v.digit[i];
     }
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline Unsigned powmod(const Unsigned& u, Unsigned exp, const Unsigned& mod)
+template<std::size_t Bits>
+FixedUnsigned<Bits>& FixedUnsigned<Bits>::operator<<=(std::size_t s)
 {
-    Unsigned r = 1;
-    if (exp.digits() == 0) {
-        return r;
+    if (s >= Bits) {
+        *this = FixedUnsigned();
+        return *this;
     }
-    Unsigned p = u % mod;
-    while (true) {
-        if (exp.digit[0] & 1) {
-            r = (r * p) % mod;
+    const std::size_t ds = s / impl::bitsPerDigit;
+    const std::size_t lbs = s % impl::bitsPerDigit;
+    if (lbs == 0) {
+        for (std::size_t i = numDigits; i != ds; --i) {
+            digit[i - 1] = digit[i - 1 - ds];
         }
-        exp >>= 1;
-        if (exp.digits() == 0) {
-            return r;
+    } else {
+        const std::size_t rbs = impl::bitsPerDigit - lbs;
+        for (std::size_t i = numDigits - 1; i != ds; --i) {
+            digit[i] = (digit[i - ds] << lbs) | (digit[i - ds - 1] >> rbs);
         }
-        p = (p * p) % mod;
+        digit[ds] = digit[0] << lbs;
+    }
+    for (std::size_t i = 0; i < ds; ++i) {
+        digit[i] = 0;
     }
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline Unsigned sqrt(const Unsigned& u)
+template<std::size_t Bits>
+FixedUnsigned<Bits>& FixedUnsigned<Bits>::operator>>=(std::size_t s)
 {
-    if (u.empty()) {
-        return u;
+    if (s >= Bits) {
+        *this = FixedUnsigned();
+        return *this;
     }
-    std::size_t shift = (u.bits() - 1) & ~static_cast<std::size_t>(1);
-    Unsigned bit = 1;
-    bit <<= shift;
-
-    Unsigned r;
-    Unsigned n = u;
-    while (bit != 0) {
-        if (n >= r + bit) {
-            n -= r;
-            n -= bit;
-            r >>= 1;
-            r += bit;
-        } else {
-            r >>= 1;
+    const std::size_t ds = s / impl::bitsPerDigit;
+    const std::size_t rbs = s % impl::bitsPerDigit;
+    const std::size_t m = numDigits - ds;
+    if (rbs == 0) {
+        for (std::size_t i = 0; i < m; ++i) {
+            digit[i] = digit[i + ds];
         }
-        bit >>= 2;
+    } else {
+        const std::size_t lbs = impl::bitsPerDigit - rbs;
+        for (std::size_t i = 0; i + 1 < m; ++i) {
+            digit[i] = (digit[i + ds] >> rbs) | (digit[i + ds + 1] << lbs);
+        }
+        digit[m - 1] = digit[numDigits - 1] >> rbs;
     }
-    return r;
+    for (std::size_t i = m; i < numDigits; ++i) {
+        digit[i] = 0;
+    }
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline Unsigned egcd(const Unsigned& u, const Unsigned& v)
+template<std::size_t Bits>
+FixedUnsigned<Bits>& FixedUnsigned<Bits>::operator+=(const FixedUnsigned& v)
 {
-    const bool vlte = (v <= u);
-    Unsigned a = vlte ? u : v;
-    Unsigned b = vlte ? v : u;
-    Unsigned zero;
-    while (!b.empty()) {
-        Unsigned c = a % b;
-        a = std::move(b);
-        b = std::move(c);
+    bool carry = false;
+    for (std::size_t i = 0; i < numDigits; ++i) {
+        digit[i] = impl::addCarry(digit[i], v.digit[i], carry);
     }
-    return a;
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline Unsigned bgcd(const Unsigned& u, const Unsigned& v)
+template<std::size_t Bits>
+FixedUnsigned<Bits>& FixedUnsigned<Bits>::operator-=(const FixedUnsigned& v)
 {
-    if (u.empty()) {
-        return v;
-    }
-    if (v.empty()) {
-        return u;
+    bool borrow = false;
+    for (std::size_t i = 0; i < numDigits; ++i) {
+        digit[i] = impl::subBorrow(digit[i], v.digit[i], borrow);
     }
-
-    Unsigned wu = u;
-    Unsigned wv = v;
-    std::size_t utz = wu.ctz();
-    std::size_t vtz = wv.ctz();
-    std::size_t shift = std::min(utz, vtz);
-    wu >>= utz;
-    wv >>= shift;
-    do {
-        vtz = wv.ctz();
-        wv >>= vtz;
-        if (wu > wv) {
-            std::swap(wu, wv);
+    return *this;
+}
+//------------------------------------------------------------------------------
+template<std::size_t Bits>
+FixedUnsigned<Bits>& FixedUnsigned<Bits>::operator*=(const FixedUnsigned& v)
+{
+    FixedUnsigned w;
+    for (std::size_t i = 0; i < numDigits; ++i) {
+        impl::digit_t carry = 0;
+        for (std::size_t j = 0; i + j < numDigits; ++j) {
+            w.digit[i + j] =
+                impl::multiplyAdd2(digit[i], v.digit[j], w.digit[i + j], carry);
         }
-        wv -= wu;
-    } while (wv != 0);
-    return wu << shift;
+    }
+    *this = w;
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline Unsigned gcd(const Unsigned& u, const Unsigned& v)
+template<std::size_t Bits>
+FixedUnsigned<Bits>& FixedUnsigned<Bits>::operator/=(const FixedUnsigned& v)
 {
-    return bgcd(u, v);
+    divide(*this, v, this, nullptr);
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline std::ostream& operator<<(std::ostream& os, const Unsigned& u)
+template<std::size_t Bits>
+FixedUnsigned<Bits>& FixedUnsigned<Bits>::operator%=(const FixedUnsigned& v)
 {
-    return os << u.str();
+    divide(*this, v, nullptr, this);
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline std::ostream& operator<<(std::ostream& out, const Unsigned::QR& qr)
+template<std::size_t Bits>
+constexpr bool FixedUnsigned<Bits>::empty() const
 {
-    out << "(q=" << qr.quot << " r=" << qr.rem << ")";
-    return out;
+    return zeroBelow(numDigits);
 }
 //------------------------------------------------------------------------------
-inline bool operator==(const Unsigned::QR& qr1, const Unsigned::QR& qr2)
+template<std::size_t Bits>
+std::size_t FixedUnsigned<Bits>::bits() const
 {
-    return (qr1.quot == qr2.quot) && (qr1.rem == qr2.rem);
+    const std::size_t n = significantDigits();
+    if (n == 0) {
+        return 0;
+    }
+    return impl::bitsPerDigit * n - impl::countLeadingZeroes(digit[n - 1]);
 }
 //------------------------------------------------------------------------------
-inline bool operator!=(const Unsigned::QR& qr1, const Unsigned::QR& qr2)
+template<std::size_t Bits>
+FixedUnsigned<Bits>::operator Unsigned() const
 {
-    return !(qr1 == qr2);
+    const std::size_t n = significantDigits();
+    Unsigned u;
+    u.digit.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        u.digit[i] = digit[i];
+    }
+    return u;
 }
 //------------------------------------------------------------------------------
-inline Signed::Signed() noexcept : sign(0)
+template<std::size_t Bits>
+FixedUnsigned<Bits>::operator std::uint64_t() const
 {
+    if (bits() > 64) {
+        throw std::overflow_error("this does not fit in a uint64_t");
+    }
+    const std::size_t n =
+        std::min<std::size_t>(numDigits, 64 / impl::bitsPerDigit);
+    std::uint64_t ret = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        ret |= static_cast<uint64_t>(digit[i]) << (i * impl::bitsPerDigit);
+    }
+    return ret;
 }
 //------------------------------------------------------------------------------
-inline Signed::Signed(const Signed& other) : val(other.val), sign(other.sign)
+template<std::size_t Bits>
+std::string FixedUnsigned<Bits>::str() const
+{
+    if (empty()) {
+        return std::string("0");
+    }
+    FixedUnsigned temp = *this;
+    std::string s;
+    for (std::size_t n = temp.significantDigits(); n != 0;) {
+        impl::digit_t mod = 0;
+        for (std::size_t i = n; i != 0; --i) {
+            temp.digit[i - 1] = impl::divideRemainder(
+                temp.digit[i - 1], impl::maxPow10PerDigit, mod);
+        }
+        if (temp.digit[n - 1] == 0) {
+            --n;
+        }
+        for (unsigned i = 0; i < impl::maxDecDigitsPerDigit; ++i) {
+            s.push_back('0' + static_cast<char>(mod % 10));
+            mod /= 10;
+        }
+    }
+    while (s.back() == '0') {
+        s.pop_back();
+    }
+    std::reverse(s.begin(), s.end());
+    return s;
+}
+//------------------------------------------------------------------------------
+template<std::size_t Bits>
+template<typename T>
+void FixedUnsigned<Bits>::initFromIntegral(T val)
 {
+    for (std::size_t i = 0; i < numDigits; ++i) {
+        digit[i] = static_cast<impl::digit_t>(val);
+        val = Unsigned::safeRightShift<impl::bitsPerDigit>(val);
+    }
+    if (val != 0) {
+        throw std::overflow_error("integer does not fit");
+    }
 }
 //------------------------------------------------------------------------------
-inline Signed::Signed(Signed&& other) noexcept
-    : val(std::move(other.val)), sign(other.sign)
+template<std::size_t Bits>
+std::size_t FixedUnsigned<Bits>::significantDigits() const
 {
+    std::size_t n = numDigits;
+    while ((n > 0) && (digit[n - 1] == 0)) {
+        --n;
+    }
+    return n;
 }
 //------------------------------------------------------------------------------
-inline Signed::Signed(const Unsigned& other)
-    : val(other), sign(val.empty() ? 0 : 1)
+template<std::size_t Bits>
+void FixedUnsigned<Bits>::divide(
+    const FixedUnsigned& u,
+    const FixedUnsigned& v,
+    FixedUnsigned* q,
+    FixedUnsigned* r)
 {
+    const std::size_t n = v.significantDigits();
+    if (n == 0) {
+        throw std::invalid_argument("division by 0");
+    }
+    const std::size_t un = u.significantDigits();
+    if (un < n) {
+        if (r) {
+            *r = u;
+        }
+        if (q) {
+            *q = FixedUnsigned();
+        }
+        return;
+    }
+    FixedUnsigned quot;
+    if (n == 1) {
+        impl::digit_t rem = 0;
+        for (std::size_t i = un; i != 0; --i) {
+            quot.digit[i - 1] =
+                impl::divideRemainder(u.digit[i - 1], v.digit[0], rem);
+        }
+        if (r) {
+            *r = FixedUnsigned();
+            r->digit[0] = rem;
+        }
+        if (q) {
+            *q = quot;
+        }
+        return;
+    }
+
+    // D1: normalize so that the highest bit of the divisor is set
+    const std::size_t ls = impl::countLeadingZeroes(v.digit[n - 1]);
+    impl::digit_t vn[numDigits];
+    impl::digit_t nu[numDigits + 1];
+    if (ls == 0) {
+        for (std::size_t i = 0; i < n; ++i) {
+            vn[i] = v.digit[i];
+        }
+        for (std::size_t i = 0; i < un; ++i) {
+            nu[i] = u.digit[i];
+        }
+        nu[un] = 0;
+    } else {
+        const std::size_t rs = impl::bitsPerDigit - ls;
+        for (std::size_t i = n - 1; i != 0; --i) {
+            vn[i] = (v.digit[i] << ls) | (v.digit[i - 1] >> rs);
+        }
+        vn[0] = v.digit[0] << ls;
+        nu[un] = u.digit[un - 1] >> rs;
+        for (std::size_t i = un - 1; i != 0; --i) {
+            nu[i] = (u.digit[i] << ls) | (u.digit[i - 1] >> rs);
+        }
+        nu[0] = u.digit[0] << ls;
+    }
+
+    // D2
+    for (std::size_t j = un - n + 1; j != 0; --j) {
+        // D3
+        impl::digit_t qd = Unsigned::findDivQuotient(
+            nu[j - 1 + n], nu[j - 2 + n], nu[j - 3 + n], vn[n - 1], vn[n - 2]);
+        // D4
+        impl::digit_t carry = 0;
+        bool borrow = false;
+        for (std::size_t i = 0; i < n; ++i) {
+            impl::digit_t md = impl::multiplyAdd(qd, vn[i], carry);
+            nu[j - 1 + i] = impl::subBorrow(nu[j - 1 + i], md, borrow);
+        }
+        nu[j - 1 + n] = impl::subBorrow(nu[j - 1 + n], carry, borrow);
+        // D5
+        if (borrow) {
+            // D6
+            --qd;
+            bool acarry = false;
+            for (std::size_t i = 0; i < n; ++i) {
+                nu[j - 1 + i] = impl::addCarry(nu[j - 1 + i], vn[i], acarry);
+            }
+            nu[j - 1 + n] += acarry;
+        }
+        quot.digit[j - 1] = qd;
+    }
+
+    // D8: unnormalize the remainder
+    if (r) {
+        *r = FixedUnsigned();
+        if (ls == 0) {
+            for (std::size_t i = 0; i < n; ++i) {
+                r->digit[i] = nu[i];
+            }
+        } else {
+            const std::size_t rs = impl::bitsPerDigit - ls;
+            for (std::size_t i = 0; i < n; ++i) {
+                r->digit[i] = (nu[i] >> ls) | (nu[i + 1] << rs);
+            }
+        }
+    }
+    if (q) {
+        *q = quot;
+    }
 }
 //------------------------------------------------------------------------------
-inline Signed::Signed(Unsigned&& other) noexcept
-    : val(std::move(other)), sign(val.empty() ? 0 : 1)
+// Recursive, so that the comparisons can be evaluated in constant expressions.
+template<std::size_t Bits>
+constexpr bool FixedUnsigned<Bits>::zeroBelow(std::size_t n) const
 {
+    return (n == 0) || ((digit[n - 1] == 0) && zeroBelow(n - 1));
 }
 //------------------------------------------------------------------------------
-inline Signed::Signed(std::int32_t i)
-    : val(
-        i < 0 ? ~static_cast<std::uint32_t>(i) + 1
-              : static_cast<std::uint32_t>(i))
-    , sign(
-          i > 0   ? 1
-          : i < 0 ? -1
-                  : 0)
+template<std::size_t Bits>
+constexpr bool
+    FixedUnsigned<Bits>::equalBelow(const FixedUnsigned& v, std::size_t n) const
 {
+    return (n == 0)
+        || ((digit[n - 1] == v.digit[n - 1]) && equalBelow(v, n - 1));
 }
 //------------------------------------------------------------------------------
-inline Signed::Signed(std::uint32_t i) : val(i), sign(i > 0 ? 1 : 0)
+template<std::size_t Bits>
+constexpr bool
+    FixedUnsigned<Bits>::lessBelow(const FixedUnsigned& v, std::size_t n) const
 {
+    return (n != 0)
+        && ((digit[n - 1] < v.digit[n - 1])
+            || ((digit[n - 1] == v.digit[n - 1]) && lessBelow(v, n - 1)));
 }
 //------------------------------------------------------------------------------
-inline Signed::Signed(std::int64_t i)
-    : val(
-        i < 0 ? ~static_cast<std::uint64_t>(i) + 1
-              : static_cast<std::uint64_t>(i))
-    , sign(
-          i > 0   ? 1
-          : i < 0 ? -1
-                  : 0)
+template<std::size_t Bits>
+constexpr bool
+    operator==(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v)
 {
+    return u.equalBelow(v, FixedUnsigned<Bits>::numDigits);
 }
 //------------------------------------------------------------------------------
-inline Signed::Signed(std::uint64_t i) : val(i), sign(i > 0 ? 1 : 0)
+template<std::size_t Bits>
+constexpr bool
+    operator!=(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v)
 {
+    return !(u == v);
 }
 //------------------------------------------------------------------------------
-inline Signed::Signed(const char* dec)
-    : val(dec[0] == '-' ? dec + 1 : dec)
-    , sign(
-          val.empty()     ? 0
-          : dec[0] == '-' ? -1
-                          : 1)
+template<std::size_t Bits>
+constexpr bool
+    operator<(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v)
 {
+    return u.lessBelow(v, FixedUnsigned<Bits>::numDigits);
 }
 //------------------------------------------------------------------------------
-inline Signed& Signed::operator=(const Signed& other)
+template<std::size_t Bits>
+constexpr bool
+    operator>=(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v)
 {
-    val = other.val;
-    sign = other.sign;
-    return *this;
+    return !(u < v);
 }
 //------------------------------------------------------------------------------
-inline Signed& Signed::operator=(Signed&& other) noexcept
+template<std::size_t Bits>
+constexpr bool
+    operator>(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v)
 {
-    val = std::move(other.val);
-    sign = other.sign;
-    return *this;
+    return v < u;
 }
 //------------------------------------------------------------------------------
-inline std::string Signed::str() const
+template<std::size_t Bits>
+constexpr bool
+    operator<=(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v)
 {
-    std::string vs = val.str();
-    if (sign == -1) {
-        vs = "-" + vs;
-    }
-    return vs;
+    return !(v < u);
 }
 //------------------------------------------------------------------------------
-inline int Signed::sgn() const
+template<std::size_t Bits>
+FixedUnsigned<Bits>
+    operator|(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v)
 {
-    return sign;
+    FixedUnsigned<Bits> w = u;
+    w |= v;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline const Unsigned& Signed::abs() const
+template<std::size_t Bits>
+FixedUnsigned<Bits>
+    operator&(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v)
 {
-    return val;
+    FixedUnsigned<Bits> w = u;
+    w &= v;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline Signed& Signed::operator++()
+template<std::size_t Bits>
+FixedUnsigned<Bits>
+    operator^(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v)
 {
-    switch (sign) {
-    case -1:
-        --val;
-        if (val.empty()) {
-            sign = 0;
-        }
-        break;
-    case 0:
-        ++val;
-        sign = 1;
-        break;
-    case 1: ++val; break;
-    }
-    return *this;
+    FixedUnsigned<Bits> w = u;
+    w ^= v;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline Signed Signed::operator++(int)
+template<std::size_t Bits>
+FixedUnsigned<Bits> operator<<(const FixedUnsigned<Bits>& u, std::size_t s)
 {
-    Signed ret = *this;
-    ++(*this);
-    return ret;
+    FixedUnsigned<Bits> w = u;
+    w <<= s;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline Signed& Signed::operator--()
+template<std::size_t Bits>
+FixedUnsigned<Bits> operator>>(const FixedUnsigned<Bits>& u, std::size_t s)
 {
-    switch (sign) {
-    case -1: ++val; break;
-    case 0:
-        ++val;
-        sign = -1;
-        break;
-    case 1:
-        --val;
-        if (val.empty()) {
-            sign = 0;
-        }
-        break;
-    }
-    return *this;
+    FixedUnsigned<Bits> w = u;
+    w >>= s;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline Signed Signed::operator--(int)
+template<std::size_t Bits>
+FixedUnsigned<Bits>
+    operator+(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v)
 {
-    Signed ret = *this;
-    --(*this);
-    return ret;
+    FixedUnsigned<Bits> w = u;
+    w += v;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline Signed& Signed::operator+=(const Signed& v)
+template<std::size_t Bits>
+FixedUnsigned<Bits>
+    operator-(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v)
 {
-    if (sign == v.sign) {
-        val += v.val;
-    } else if (val > v.val) {
-        val -= v.val;
-    } else {
-        val = v.val - val;
-        sign = val.empty() ? 0 : v.sign;
-    }
-    return *this;
+    FixedUnsigned<Bits> w = u;
+    w -= v;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline Signed& Signed::operator-=(const Signed& v)
+template<std::size_t Bits>
+FixedUnsigned<Bits>
+    operator*(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v)
 {
-    if (-sign == v.sign) {
-        val += v.val;
-    } else if (val > v.val) {
-        val -= v.val;
-    } else {
-        val = v.val - val;
-        sign = val.empty() ? 0 : -v.sign;
-    }
-    return *this;
+    FixedUnsigned<Bits> w = u;
+    w *= v;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline Signed& Signed::operator*=(const Signed& v)
+template<std::size_t Bits>
+FixedUnsigned<Bits>
+    operator/(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v)
 {
-    val *= v.val;
-    sign *= v.sign;
-    return *this;
+    FixedUnsigned<Bits> w = u;
+    w /= v;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline Signed& Signed::operator/=(const Signed& v)
+template<std::size_t Bits>
+FixedUnsigned<Bits>
+    operator%(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v)
 {
-    val /= v.val;
-    sign *= v.sign;
-    return *this;
+    FixedUnsigned<Bits> w = u;
+    w %= v;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline Signed& Signed::operator%=(const Signed& v)
+template<std::size_t Bits>
+typename FixedUnsigned<Bits>::QR
+    div(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v)
 {
-    val %= v.val;
-    return *this;
+    typename FixedUnsigned<Bits>::QR qr;
+    FixedUnsigned<Bits>::divide(u, v, &qr.quot, &qr.rem);
+    return qr;
 }
 //------------------------------------------------------------------------------
-inline Signed Signed::div(const Signed& v)
+template<std::size_t Bits>
+FixedUnsigned<2 * Bits>
+    mulWide(const FixedUnsigned<Bits>& u, const FixedUnsigned<Bits>& v)
 {
-    Signed rem(val.div(v.val));
-    rem.sign = sign;
-    sign *= v.sign;
-    return rem;
+    constexpr std::size_t n = FixedUnsigned<Bits>::numDigits;
+    FixedUnsigned<2 * Bits> w;
+    for (std::size_t i = 0; i < n; ++i) {
+        impl::digit_t carry = 0;
+        for (std::size_t j = 0; j < n; ++j) {
+            w.digit[i + j] = impl::multiplyAdd2(
+                u.digit[i], v.digit[j], w.digit[i + j], carry);
+        }
+        w.digit[i + n] = carry;
+    }
+    return w;
 }
 //------------------------------------------------------------------------------
-inline bool operator==(const Signed& u, const Signed& v)
+template<std::size_t Bits>
+std::ostream& operator<<(std::ostream& out, const FixedUnsigned<Bits>& u)
 {
-    return (u.sign == v.sign) && (u.val == v.val);
+    return out << u.str();
 }
 //------------------------------------------------------------------------------
-inline bool operator!=(const Signed& u, const Signed& v)
-{
-    return !(u == v);
-}
+// class FixedSigned
 //------------------------------------------------------------------------------
-inline bool operator<(const Signed& u, const Signed& v)
+template<std::size_t Bits>
+FixedSigned<Bits>::FixedSigned() noexcept
 {
-    if (u.sign != v.sign) {
-        return u.sign < v.sign;
-    }
-    return u.val < v.val;
 }
 //------------------------------------------------------------------------------
-inline bool operator>=(const Signed& u, const Signed& v)
+template<std::size_t Bits>
+FixedSigned<Bits>::FixedSigned(std::int32_t i)
 {
-    return !(u < v);
+    const std::uint32_t m = static_cast<std::uint32_t>(i);
+    assignMagnitude(FixedUnsigned<Bits>(i < 0 ? ~m + 1 : m), i < 0);
 }
 //------------------------------------------------------------------------------
-inline bool operator>(const Signed& u, const Signed& v)
+template<std::size_t Bits>
+FixedSigned<Bits>::FixedSigned(std::uint32_t i)
 {
-    return (v < u);
+    assignMagnitude(FixedUnsigned<Bits>(i), false);
 }
 //------------------------------------------------------------------------------
-inline bool operator<=(const Signed& u, const Signed& v)
+template<std::size_t Bits>
+FixedSigned<Bits>::FixedSigned(std::int64_t i)
 {
-    return !(u > v);
+    const std::uint64_t m = static_cast<std::uint64_t>(i);
+    assignMagnitude(FixedUnsigned<Bits>(i < 0 ? ~m + 1 : m), i < 0);
 }
 //------------------------------------------------------------------------------
-inline Signed operator-(const Signed& u)
+template<std::size_t Bits>
+FixedSigned<Bits>::FixedSigned(std::uint64_t i)
 {
-    Signed w;
-    w.sign = -u.sign;
-    w.val = u.val;
-    return w;
+    assignMagnitude(FixedUnsigned<Bits>(i), false);
 }
 //------------------------------------------------------------------------------
-inline Signed operator+(const Signed& u, const Signed& v)
+template<std::size_t Bits>
+FixedSigned<Bits>::FixedSigned(const Signed& s)
 {
-    Signed w;
-    if (u.sign == v.sign) {
-        w.val = u.val + v.val;
-        w.sign = u.sign;
-    } else if (u.val > v.val) {
-        w.val = u.val - v.val;
-        w.sign = u.sign;
-    } else {
-        w.val = v.val - u.val;
-        w.sign = w.val.empty() ? 0 : v.sign;
-    }
-    return w;
+    assignMagnitude(FixedUnsigned<Bits>(s.abs()), s.sgn() < 0);
 }
 //------------------------------------------------------------------------------
-inline Signed operator-(const Signed& u, const Signed& v)
+template<std::size_t Bits>
+int FixedSigned<Bits>::sgn() const
 {
-    Signed w;
-    if (-u.sign == v.sign) {
-        w.val = u.val + v.val;
-        w.sign = u.sign;
-    } else if (u.val > v.val) {
-        w.val = u.val - v.val;
-        w.sign = u.sign;
-    } else {
-        w.val = v.val - u.val;
-        w.sign = w.val.empty() ? 0 : -v.sign;
+    if (negative()) {
+        return -1;
     }
-    return w;
+    return val.empty() ? 0 : 1;
 }
 //------------------------------------------------------------------------------
-inline Signed operator*(const Signed& u, const Signed& v)
+template<std::size_t Bits>
+FixedUnsigned<Bits> FixedSigned<Bits>::abs() const
 {
-    Signed w;
-    w.val = u.val * v.val;
-    w.sign = u.sign * v.sign;
-    return w;
+    return negative() ? FixedUnsigned<Bits>() - val : val;
 }
 //------------------------------------------------------------------------------
-inline Signed operator/(const Signed& u, const Signed& v)
+template<std::size_t Bits>
+FixedSigned<Bits>& FixedSigned<Bits>::operator++()
 {
-    return div(u, v).quot;
+    ++val;
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline Signed operator%(const Signed& u, const Signed& v)
+template<std::size_t Bits>
+FixedSigned<Bits> FixedSigned<Bits>::operator++(int)
 {
-    return div(u, v).rem;
+    FixedSigned ret = *this;
+    ++val;
+    return ret;
 }
 //------------------------------------------------------------------------------
-inline Signed::QR div(const Signed& u, const Signed& v)
+template<std::size_t Bits>
+FixedSigned<Bits>& FixedSigned<Bits>::operator--()
 {
-    Unsigned::QR uqr = ::bn::div(u.val, v.val);
-    Signed::QR qr{std::move(uqr.quot), std::move(uqr.rem)};
-    qr.quot.sign = u.sign * v.sign;
-    qr.rem.sign = u.sign;
-    return qr;
+    --val;
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline std::ostream& operator<<(std::ostream& os, const Signed& s)
+template<std::size_t Bits>
+FixedSigned<Bits> FixedSigned<Bits>::operator--(int)
 {
-    if (s.sign == -1) {
-        os << '-';
-    }
-    os << s.val;
-    return os;
+    FixedSigned ret = *this;
+    --val;
+    return ret;
 }
 //------------------------------------------------------------------------------
-inline Rational::Rational() noexcept : den(1)
+template<std::size_t Bits>
+FixedSigned<Bits>& FixedSigned<Bits>::operator+=(const FixedSigned& v)
 {
+    val += v.val;
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline Rational::Rational(const Signed& num, const Unsigned& den)
-    : num(num), den(den)
+template<std::size_t Bits>
+FixedSigned<Bits>& FixedSigned<Bits>::operator-=(const FixedSigned& v)
 {
-    if (den.empty()) {
-        throw std::invalid_argument("den is 0");
-    }
-    reduce();
+    val -= v.val;
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline Rational::Rational(Signed&& num, Unsigned&& den)
-    : num(std::move(num)), den(std::move(den))
+template<std::size_t Bits>
+FixedSigned<Bits>& FixedSigned<Bits>::operator*=(const FixedSigned& v)
 {
-    if (this->den.empty()) {
-        throw std::invalid_argument("den is 0");
-    }
-    reduce();
+    val *= v.val;
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline Rational::Rational(double d) : den(1)
-{
-    if (!std::isfinite(d)) {
-        throw std::invalid_argument("d is not finite");
-    }
-    std::uint64_t u;
-    memcpy(&u, &d, 8);
-    std::uint64_t frac = u & 0xFFFFFFFFFFFFFull;
-    std::uint64_t bexp = (u >> 52) & 0x7FFull;
-    std::uint64_t sign = u >> 63;
-    if (bexp == 0) {
-        if (frac != 0) {
-            num.val = Unsigned(frac);
-            num.sign = (sign == 1) ? -1 : 1;
-            den <<= (1022 + 52);
-        }
-    } else {
-        frac |= 0x10000000000000ull;
-        num.val = Unsigned(frac);
-        num.sign = (sign == 1) ? -1 : 1;
-        if (bexp < (1023 + 52)) {
-            den <<= (1023 + 52 - bexp);
-        } else {
-            num.val <<= (bexp - 1023 - 52);
-        }
+template<std::size_t Bits>
+FixedSigned<Bits>& FixedSigned<Bits>::operator/=(const FixedSigned& v)
+{
+    const bool neg = negative() != v.negative();
+    val = abs() / v.abs();
+    if (neg) {
+        negate();
     }
-    reduce();
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline Rational::Rational(const Unsigned& v) : num(v), den(1)
+template<std::size_t Bits>
+FixedSigned<Bits>& FixedSigned<Bits>::operator%=(const FixedSigned& v)
 {
+    const bool neg = negative();
+    val = abs() % v.abs();
+    if (neg) {
+        negate();
+    }
+    return *this;
 }
 //------------------------------------------------------------------------------
-inline Rational::Rational(Unsigned&& v) : num(std::move(v)), den(1)
+template<std::size_t Bits>
+FixedSigned<Bits>::operator Signed() const
 {
+    Signed s(static_cast<Unsigned>(abs()));
+    return negative() ? -s : s;
 }
 //------------------------------------------------------------------------------
-inline Rational::Rational(const Signed& v) : num(v), den(1)
+template<std::size_t Bits>
+std::string FixedSigned<Bits>::str() const
 {
+    if (negative()) {
+        return "-" + abs().str();
+    }
+    return val.str();
 }
 //------------------------------------------------------------------------------
-inline Rational::Rational(Signed&& v) : num(std::move(v)), den(1)
+template<std::size_t Bits>
+bool FixedSigned<Bits>::negative() const
 {
+    constexpr std::size_t n = FixedUnsigned<Bits>::numDigits;
+    return (val.digit[n - 1] >> (impl::bitsPerDigit - 1)) != 0;
 }
 //------------------------------------------------------------------------------
-inline const Signed& Rational::numerator() const
+template<std::size_t Bits>
+void FixedSigned<Bits>::negate()
 {
-    return num;
+    val = FixedUnsigned<Bits>() - val;
 }
 //------------------------------------------------------------------------------
-inline const Unsigned& Rational::denominator() const
+template<std::size_t Bits>
+void FixedSigned<Bits>::assignMagnitude(const FixedUnsigned<Bits>& m, bool neg)
 {
-    return den;
+    val = m;
+    if (neg) {
+        negate();
+        if (!m.empty() && !negative()) {
+            throw std::overflow_error("integer does not fit");
+        }
+    } else if (negative()) {
+        throw std::overflow_error("integer does not fit");
+    }
 }
 //------------------------------------------------------------------------------
-inline Rational Rational::reciprocal() const
+template<std::size_t Bits>
+bool operator==(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v)
 {
-    if (num.abs().empty()) {
-        throw std::logic_error("numerator is 0");
+    return u.val == v.val;
+}
+//------------------------------------------------------------------------------
+template<std::size_t Bits>
+bool operator!=(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v)
+{
+    return !(u == v);
+}
+//------------------------------------------------------------------------------
+template<std::size_t Bits>
+bool operator<(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v)
+{
+    const bool un = u.negative();
+    const bool vn = v.negative();
+    if (un != vn) {
+        return un;
     }
-    Rational w;
-    w.num = den;
-    w.den = num.abs();
-    w.num.sign = num.sign;
-    return w;
+    return u.val < v.val;
 }
 //------------------------------------------------------------------------------
-inline Rational& Rational::operator+=(const Rational& v)
+template<std::size_t Bits>
+bool operator>=(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v)
 {
-    num *= v.den;
-    num += v.num * den;
-    den *= v.den;
-    reduce();
-    return *this;
+    return !(u < v);
 }
 //------------------------------------------------------------------------------
-inline Rational& Rational::operator-=(const Rational& v)
+template<std::size_t Bits>
+bool operator>(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v)
 {
-    num *= v.den;
-    num -= v.num * den;
-    den *= v.den;
-    reduce();
-    return *this;
+    return v < u;
 }
 //------------------------------------------------------------------------------
-inline Rational& Rational::operator*=(const Rational& v)
+template<std::size_t Bits>
+bool operator<=(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v)
 {
-    num *= v.num;
-    den *= v.den;
-    reduce();
-    return *this;
+    return !(v < u);
 }
 //------------------------------------------------------------------------------
-inline Rational& Rational::operator/=(const Rational& v)
+template<std::size_t Bits>
+FixedSigned<Bits> operator-(const FixedSigned<Bits>& u)
 {
-    if (v.num.abs().empty()) {
-        throw std::invalid_argument("division by 0");
-    }
-    num *= v.den;
-    den *= v.num.abs();
-    num.sign *= v.num.sign;
-    reduce();
-    return *this;
+    return FixedSigned<Bits>() - u;
 }
 //------------------------------------------------------------------------------
-inline Rational::operator double() const
+template<std::size_t Bits>
+FixedSigned<Bits>
+    operator+(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v)
 {
-    if (num.abs().empty()) {
-        return 0.0;
-    }
-    std::ptrdiff_t d = static_cast<std::ptrdiff_t>(num.abs().bits())
-                     - static_cast<std::ptrdiff_t>(den.bits());
-    // We use the fact that 2^(d-1) < *this < 2^(d+1)
-    if (d <= -1075) {
-        // Underflow
-        return std::copysign(0.0, num.sign);
-    }
-    if (d >= 1025) {
-        // Overflow
-        return std::copysign(std::numeric_limits<double>::infinity(), num.sign);
-    }
-    // Shift the numerator so that the quotient of the shifted numerator and
-    // the denominator have at least 54 bits. According to the inequation above,
-    // the quotient will have either 54 or 55 bits.
-    std::ptrdiff_t nls = 54 - d;
-    Unsigned snum = (nls >= 0) ? num.abs() << static_cast<std::size_t>(nls)
-                               : num.abs() >> static_cast<std::size_t>(-nls);
-    std::uint64_t q = static_cast<std::uint64_t>(snum / den);
-    // If the quotient has 55 bits, discard one bit.
-    if (q & (1ull << 54)) {
-        q >>= 1;
-        --nls;
-    }
-    // Check if we have to round up
-    if (q & 3) {
-        ++q;
-        // If the quotient has 55 bits, discard one bit.
-        if (q & (1ull << 54)) {
-            q >>= 1;
-            --nls;
-        }
-    }
-    // Discard the bit used to check if rounding up is necessary
-    q >>= 1;
-    --nls;
-    // Create the components
-    std::uint64_t sign = (num.sign == -1) ? 1 : 0;
-    std::uint64_t bexp;
-    std::uint64_t frac;
-    if (nls > 1074) {
-        bexp = 0;
-        std::size_t sr = nls - 1074;
-        frac = (sr > 63) ? 0 : q >> sr;
-    } else if (-nls > 971) {
-        // Overflow
-        bexp = 2047;
-        frac = 0;
-    } else {
-        bexp = 1075 - nls;
-        // Create the fraction by masking the leading bit of q
-        frac = q & 0xFFFFFFFFFFFFFull;
-    }
-    std::uint64_t uret = (sign << 63) | (bexp << 52) | frac;
-    double ret;
-    memcpy(&ret, &uret, 8);
-    return ret;
+    FixedSigned<Bits> w = u;
+    w += v;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline std::string Rational::str() const
+template<std::size_t Bits>
+FixedSigned<Bits>
+    operator-(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v)
 {
-    std::ostringstream out;
-    out << *this;
-    return out.str();
+    FixedSigned<Bits> w = u;
+    w -= v;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline void Rational::reduce()
+template<std::size_t Bits>
+FixedSigned<Bits>
+    operator*(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v)
 {
-    Unsigned d = gcd(num.abs(), den);
-    num /= d;
-    den /= d;
+    FixedSigned<Bits> w = u;
+    w *= v;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline bool operator==(const Rational& u, const Rational& v)
+template<std::size_t Bits>
+FixedSigned<Bits>
+    operator/(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v)
 {
-    return (u.num == v.num) && (u.den == v.den);
+    FixedSigned<Bits> w = u;
+    w /= v;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline bool operator!=(const Rational& u, const Rational& v)
+template<std::size_t Bits>
+FixedSigned<Bits>
+    operator%(const FixedSigned<Bits>& u, const FixedSigned<Bits>& v)
 {
-    return !(u == v);
+    FixedSigned<Bits> w = u;
+    w %= v;
+    return w;
 }
 //------------------------------------------------------------------------------
-inline bool operator<(const Rational& u, const Rational& v)
+template<std::size_t Bits>
+std::ostream& operator<<(std::ostream& out, const FixedSigned<Bits>& s)
 {
-    if (u.num.sgn() != v.num.sgn()) {
-        return u.num.sgn() < v.num.sgn();
-    }
-    if (u.num.sgn() == 0) {
-        return false;
-    }
-    const Rational& a = (u.num.sgn() == 1) ? u : v;
-    const Rational& b = (u.num.sgn() == 1) ? v : u;
-    const std::ptrdiff_t m = static_cast<std::ptrdiff_t>(a.num.abs().digits())
-                           - static_cast<std::ptrdiff_t>(a.den.digits());
-    const std::ptrdiff_t n = static_cast<std::ptrdiff_t>(b.num.abs().digits())
-                           - static_cast<std::ptrdiff_t>(b.den.digits());
-    if ((m + 1) <= (n - 1)) {
-        return true;
-    }
-    if ((n + 1) <= (m - 1)) {
-        return false;
+    return out << s.str();
+}
+//------------------------------------------------------------------------------
+// class UnsignedBatch
+//------------------------------------------------------------------------------
+template<std::size_t Bits>
+constexpr std::size_t UnsignedBatch<Bits>::numDigits;
+//------------------------------------------------------------------------------
+template<std::size_t Bits>
+UnsignedBatch<Bits>::UnsignedBatch(std::size_t lanes)
+    : lanes(lanes), digit(numDigits * lanes)
+{
+}
+//------------------------------------------------------------------------------
+template<std::size_t Bits>
+UnsignedBatch<Bits>
+    UnsignedBatch<Bits>::fromUnsigned(const std::vector<Unsigned>& values)
+{
+    UnsignedBatch b(values.size());
+    for (std::size_t l = 0; l < values.size(); ++l) {
+        b.set(l, FixedUnsigned<Bits>(values[l]));
     }
-    const Unsigned ane = a.num.abs() * b.den;
-    const Unsigned bne = b.num.abs() * a.den;
-    return ane < bne;
+    return b;
 }
 //------------------------------------------------------------------------------
-inline bool operator>=(const Rational& u, const Rational& v)
+template<std::size_t Bits>
+std::size_t UnsignedBatch<Bits>::size() const noexcept
 {
-    return !(u < v);
+    return lanes;
 }
 //------------------------------------------------------------------------------
-inline bool operator>(const Rational& u, const Rational& v)
+template<std::size_t Bits>
+FixedUnsigned<Bits> UnsignedBatch<Bits>::get(std::size_t lane) const
 {
-    return v < u;
+    assert(lane < lanes);
+    FixedUnsigned<Bits> u;
+    for (std::size_t k = 0; k < numDigits; ++k) {
+        u.digit[k] = digit[k * lanes + lane];
+    }
+    return u;
 }
 //------------------------------------------------------------------------------
-inline bool operator<=(const Rational& u, const Rational& v)
+template<std::size_t Bits>
+void UnsignedBatch<Bits>::set(std::size_t lane, const FixedUnsigned<Bits>& u)
 {
-    return !(u > v);
+    assert(lane < lanes);
+    for (std::size_t k = 0; k < numDigits; ++k) {
+        digit[k * lanes + lane] = u.digit[k];
+    }
 }
 //------------------------------------------------------------------------------
-inline Rational operator-(const Rational& u)
+template<std::size_t Bits>
+std::vector<Unsigned> UnsignedBatch<Bits>::toUnsigned() const
 {
-    return Rational(-u.num, u.den);
+    std::vector<Unsigned> values;
+    values.reserve(lanes);
+    for (std::size_t l = 0; l < lanes; ++l) {
+        values.push_back(Unsigned(get(l)));
+    }
+    return values;
 }
 //------------------------------------------------------------------------------
-inline Rational operator+(const Rational& u, const Rational& v)
+template<std::size_t Bits>
+impl::digit_t* UnsignedBatch<Bits>::row(std::size_t k) noexcept
 {
-    Rational w(u.num * v.den + v.num * u.den, u.den * v.den);
-    return w;
+    assert(k < numDigits);
+    return digit.data() + k * lanes;
 }
 //------------------------------------------------------------------------------
-inline Rational operator-(const Rational& u, const Rational& v)
+template<std::size_t Bits>
+const impl::digit_t* UnsignedBatch<Bits>::row(std::size_t k) const noexcept
 {
-    Rational w(u.num * v.den - v.num * u.den, u.den * v.den);
-    return w;
+    assert(k < numDigits);
+    return digit.data() + k * lanes;
 }
 //------------------------------------------------------------------------------
-inline Rational operator*(const Rational& u, const Rational& v)
+template<std::size_t Bits>
+void batchAdd(
+    const UnsignedBatch<Bits>& u,
+    const UnsignedBatch<Bits>& v,
+    UnsignedBatch<Bits>& w)
 {
-    Rational w(u.num * v.num, u.den * v.den);
-    return w;
+    const std::size_t lanes = u.size();
+    if (v.size() != lanes) {
+        throw std::invalid_argument("batches differ in size");
+    }
+    if (w.size() != lanes) {
+        w = UnsignedBatch<Bits>(lanes);
+    }
+    // Every digit is read before the same digit of w is written, so w may
+    // alias u or v.
+    for (std::size_t first = 0; first < lanes; first += impl::batchLanes) {
+        const std::size_t len = std::min(impl::batchLanes, lanes - first);
+        impl::digit_t carry[impl::batchLanes] = {};
+        for (std::size_t k = 0; k < UnsignedBatch<Bits>::numDigits; ++k) {
+            const impl::digit_t* a = u.row(k) + first;
+            const impl::digit_t* b = v.row(k) + first;
+            impl::digit_t* r = w.row(k) + first;
+            for (std::size_t l = 0; l < len; ++l) {
+                bool c = carry[l] != 0;
+                r[l] = impl::addCarry(a[l], b[l], c);
+                carry[l] = c;
+            }
+        }
+    }
 }
 //------------------------------------------------------------------------------
-inline Rational operator/(const Rational& u, const Rational& v)
+template<std::size_t Bits>
+void batchMul(
+    const UnsignedBatch<Bits>& u,
+    const UnsignedBatch<Bits>& v,
+    UnsignedBatch<Bits>& w)
+{
+    const std::size_t lanes = u.size();
+    if (v.size() != lanes) {
+        throw std::invalid_argument("batches differ in size");
+    }
+    const std::size_t n = UnsignedBatch<Bits>::numDigits;
+    // The products are accumulated in w, or in a separate batch if w aliases
+    // u or v.
+    const bool alias = (&w == &u) || (&w == &v);
+    UnsignedBatch<Bits> t;
+    if (alias) {
+        t = UnsignedBatch<Bits>(lanes);
+    } else if (w.size() != lanes) {
+        w = UnsignedBatch<Bits>(lanes);
+    } else if (lanes != 0) {
+        std::fill(w.row(0), w.row(0) + n * lanes, impl::digit_t(0));
+    }
+    UnsignedBatch<Bits>& p = alias ? t : w;
+    for (std::size_t first = 0; first < lanes; first += impl::batchLanes) {
+        const std::size_t len = std::min(impl::batchLanes, lanes - first);
+        for (std::size_t i = 0; i < n; ++i) {
+            const impl::digit_t* b = v.row(i) + first;
+            impl::digit_t carry[impl::batchLanes] = {};
+            for (std::size_t j = 0; i + j < n; ++j) {
+                const impl::digit_t* a = u.row(j) + first;
+                impl::digit_t* r = p.row(i + j) + first;
+                for (std::size_t l = 0; l < len; ++l) {
+                    r[l] = impl::multiplyAdd2(a[l], b[l], r[l], carry[l]);
+                }
+            }
+        }
+    }
+    if (alias) {
+        w = std::move(t);
+    }
+}
+//------------------------------------------------------------------------------
+template<std::size_t Bits>
+void batchMod(
+    const UnsignedBatch<Bits>& u,
+    const FixedUnsigned<Bits>& m,
+    UnsignedBatch<Bits>& w)
 {
-    if (v.num.abs().empty()) {
+    if (m.empty()) {
         throw std::invalid_argument("division by 0");
     }
-    Rational w(u.num.abs() * v.den, u.den * v.num.abs());
-    w.num.sign = u.num.sgn() * v.num.sgn();
-    return w;
+    const std::size_t lanes = u.size();
+    if (w.size() != lanes) {
+        w = UnsignedBatch<Bits>(lanes);
+    }
+    for (std::size_t l = 0; l < lanes; ++l) {
+        w.set(l, u.get(l) % m);
+    }
 }
 //------------------------------------------------------------------------------
-inline std::ostream& operator<<(std::ostream& out, const Rational& u)
+// class UnsignedLiteral
+//------------------------------------------------------------------------------
+namespace impl {
+//------------------------------------------------------------------------------
+template<digit_t... D>
+constexpr std::size_t UnsignedLiteral<D...>::numDigits;
+//------------------------------------------------------------------------------
+template<digit_t... D>
+constexpr digit_t UnsignedLiteral<D...>::digit[numDigits + 1];
+//------------------------------------------------------------------------------
+template<digit_t... D>
+UnsignedLiteral<D...>::operator Unsigned() const
 {
-    out << u.num << "/" << u.den;
-    return out;
+    Unsigned u;
+    u.digit.resize(numDigits);
+    for (std::size_t i = 0; i < numDigits; ++i) {
+        u.digit[i] = digit[i];
+    }
+    return u;
+}
+//------------------------------------------------------------------------------
+template<digit_t... D>
+UnsignedLiteral<D...>::operator Signed() const
+{
+    return Signed(static_cast<Unsigned>(*this));
+}
+//------------------------------------------------------------------------------
+}  // namespace impl
+//------------------------------------------------------------------------------
+inline namespace literals {
+//------------------------------------------------------------------------------
+template<char... C>
+constexpr typename impl::LiteralOf<
+    typename impl::ParseDecimal<impl::DigitList<>, C...>::type>::type
+    operator"" _bn()
+{
+    return typename impl::LiteralOf<
+        typename impl::ParseDecimal<impl::DigitList<>, C...>::type>::type();
 }
 //------------------------------------------------------------------------------
+}  // namespace literals
+//------------------------------------------------------------------------------
 namespace impl {
 //------------------------------------------------------------------------------
 template<typename T>
@@ -3946,6 +13468,58 @@ typename std::enable_if<std::is_unsigned<T>::value, std::size_t>::type
     return ret;
 }
 //------------------------------------------------------------------------------
+template<typename T>
+typename std::enable_if<std::is_signed<T>::value, std::uint64_t>::type
+    magnitude(T i)
+{
+    return (i < 0) ? 0 - static_cast<std::uint64_t>(i)
+                   : static_cast<std::uint64_t>(i);
+}
+//------------------------------------------------------------------------------
+template<typename T>
+typename std::enable_if<std::is_unsigned<T>::value, std::uint64_t>::type
+    magnitude(T i)
+{
+    return i;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+typename std::enable_if<std::is_signed<T>::value, int>::type signum(T i)
+{
+    return (i > 0) - (i < 0);
+}
+//------------------------------------------------------------------------------
+template<typename T>
+typename std::enable_if<std::is_unsigned<T>::value, int>::type signum(T i)
+{
+    return i != 0;
+}
+//------------------------------------------------------------------------------
+template<typename T>
+std::uint64_t nonNegative(T i)
+{
+    if (signum(i) < 0) {
+        throw std::invalid_argument("i is negative");
+    }
+    return magnitude(i);
+}
+//------------------------------------------------------------------------------
+inline bool fitsInDigit(std::uint64_t m)
+{
+    // Shifting twice avoids shifting by the width of m for 64-bit digits.
+    return ((m >> (bitsPerDigit - 1)) >> 1) == 0;
+}
+//------------------------------------------------------------------------------
+inline std::uint64_t gcd64(std::uint64_t a, std::uint64_t b)
+{
+    while (b != 0) {
+        const std::uint64_t r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+//------------------------------------------------------------------------------
 #if defined DIGIT_T && defined DDIGIT_T
 using ddigit_t = DDIGIT_T;
 #else
@@ -4013,6 +13587,19 @@ inline std::size_t countTrailingZeroes(digit_t val)
     return countTrailingZeroes<digit_t>(val);
 }
 //------------------------------------------------------------------------------
+inline digit_t inverseDigit(digit_t d)
+{
+    // d*d = 1 mod 8 holds for every odd d, and each Newton step
+    // x = x*(2 - d*x) doubles the number of correct low bits.
+    digit_t x = d;
+    for (std::size_t bits = 3; bits < bitsPerDigit; bits *= 2) {
+        const ddigit_t dx = static_cast<ddigit_t>(d) * x;
+        const digit_t e = static_cast<digit_t>(2 - static_cast<digit_t>(dx));
+        x = static_cast<digit_t>(static_cast<ddigit_t>(x) * e);
+    }
+    return x;
+}
+//------------------------------------------------------------------------------
 }  // namespace impl
 //------------------------------------------------------------------------------
 }  // namespace bn
@@ -0,0 +1,479 @@
+/**
+ * Copyright (c) 2024 Stefan Uhrig
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+//------------------------------------------------------------------------------
+// Cross-checks the kernels of the library against a simple reference
+// implementation on 32-bit limbs, which shares no code with the library. The
+// operand sizes straddle the thresholds at which the library switches between
+// algorithms, and the test is built for every digit width.
+//
+// The number of random operands per size can be raised with the environment
+// variable BN_DIFF_ITERATIONS for longer runs.
+//------------------------------------------------------------------------------
+#include "bignum.h"
+
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+//------------------------------------------------------------------------------
+using namespace bn;
+using namespace std;
+//------------------------------------------------------------------------------
+namespace {
+//------------------------------------------------------------------------------
+// Reference implementation
+//------------------------------------------------------------------------------
+using Ref = vector<uint32_t>;
+//------------------------------------------------------------------------------
+void trim(Ref& a)
+{
+    while (!a.empty() && (a.back() == 0)) {
+        a.pop_back();
+    }
+}
+//------------------------------------------------------------------------------
+Ref toRef(const Unsigned& u)
+{
+    const vector<uint8_t> bytes = u.toBytes(Endianness::little, 1);
+    Ref a((bytes.size() + 3) / 4, 0);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        a[i / 4] |= static_cast<uint32_t>(bytes[i]) << (8 * (i % 4));
+    }
+    trim(a);
+    return a;
+}
+//------------------------------------------------------------------------------
+int compare(const Ref& a, const Ref& b)
+{
+    if (a.size() != b.size()) {
+        return (a.size() < b.size()) ? -1 : 1;
+    }
+    for (size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i]) {
+            return (a[i] < b[i]) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+//------------------------------------------------------------------------------
+Ref add(const Ref& a, const Ref& b)
+{
+    Ref r(max(a.size(), b.size()) + 1, 0);
+    uint64_t carry = 0;
+    for (size_t i = 0; i + 1 < r.size(); ++i) {
+        carry += (i < a.size()) ? a[i] : 0;
+        carry += (i < b.size()) ? b[i] : 0;
+        r[i] = static_cast<uint32_t>(carry);
+        carry >>= 32;
+    }
+    r.back() = static_cast<uint32_t>(carry);
+    trim(r);
+    return r;
+}
+//------------------------------------------------------------------------------
+// Requires a >= b.
+Ref subtract(const Ref& a, const Ref& b)
+{
+    Ref r(a.size(), 0);
+    int64_t borrow = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        int64_t d = static_cast<int64_t>(a[i]) - borrow
+                  - ((i < b.size()) ? static_cast<int64_t>(b[i]) : 0);
+        borrow = (d < 0) ? 1 : 0;
+        r[i] = static_cast<uint32_t>(d + (borrow << 32));
+    }
+    trim(r);
+    return r;
+}
+//------------------------------------------------------------------------------
+Ref multiply(const Ref& a, const Ref& b)
+{
+    Ref r(a.size() + b.size(), 0);
+    for (size_t i = 0; i < a.size(); ++i) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < b.size(); ++j) {
+            carry += static_cast<uint64_t>(a[i]) * b[j] + r[i + j];
+            r[i + j] = static_cast<uint32_t>(carry);
+            carry >>= 32;
+        }
+        r[i + b.size()] = static_cast<uint32_t>(carry);
+    }
+    trim(r);
+    return r;
+}
+//------------------------------------------------------------------------------
+// Bitwise long division. Requires b != 0.
+pair<Ref, Ref> divide(const Ref& a, const Ref& b)
+{
+    Ref q(a.size(), 0);
+    Ref r;
+    for (size_t bit = 32 * a.size(); bit-- > 0;) {
+        uint32_t in = (a[bit / 32] >> (bit % 32)) & 1;
+        for (uint32_t& limb : r) {
+            const uint32_t out = limb >> 31;
+            limb = (limb << 1) | in;
+            in = out;
+        }
+        if (in != 0) {
+            r.push_back(in);
+        }
+        if (compare(r, b) >= 0) {
+            r = subtract(r, b);
+            q[bit / 32] |= uint32_t(1) << (bit % 32);
+        }
+    }
+    trim(q);
+    return make_pair(q, r);
+}
+//------------------------------------------------------------------------------
+Ref lowBits(Ref a, size_t bits)
+{
+    const size_t words = (bits + 31) / 32;
+    if (a.size() >= words) {
+        a.resize(words);
+        if (bits % 32 != 0) {
+            a.back() &= (uint32_t(1) << (bits % 32)) - 1;
+        }
+    }
+    trim(a);
+    return a;
+}
+//------------------------------------------------------------------------------
+Ref highBits(const Ref& a, size_t bits)
+{
+    const size_t shift = bits % 32;
+    Ref r;
+    for (size_t i = bits / 32; i < a.size(); ++i) {
+        uint64_t w = a[i] >> shift;
+        if ((shift != 0) && (i + 1 < a.size())) {
+            w |= static_cast<uint64_t>(a[i + 1]) << (32 - shift);
+        }
+        r.push_back(static_cast<uint32_t>(w));
+    }
+    trim(r);
+    return r;
+}
+//------------------------------------------------------------------------------
+string toString(Ref a, unsigned base)
+{
+    if (a.empty()) {
+        return "0";
+    }
+    string s;
+    while (!a.empty()) {
+        uint64_t rem = 0;
+        for (size_t i = a.size(); i-- > 0;) {
+            const uint64_t cur = (rem << 32) | a[i];
+            a[i] = static_cast<uint32_t>(cur / base);
+            rem = cur % base;
+        }
+        trim(a);
+        s.push_back("0123456789abcdefghijklmnopqrstuvwxyz"[rem]);
+    }
+    reverse(s.begin(), s.end());
+    return s;
+}
+//------------------------------------------------------------------------------
+// Operands
+//------------------------------------------------------------------------------
+size_t iterations()
+{
+    const char* env = getenv("BN_DIFF_ITERATIONS");
+    return (env != nullptr) ? static_cast<size_t>(atoi(env)) : 10;
+}
+//------------------------------------------------------------------------------
+// Returns a number with exactly numDigits digits. Half of the numbers consist
+// of long runs of zero and one bits, which provoke rare carries and
+// corrections.
+Unsigned randomNumber(size_t numDigits, mt19937& gen)
+{
+    vector<uint8_t> bytes(numDigits * sizeof(impl::digit_t));
+    if (bytes.empty()) {
+        return Unsigned();
+    }
+    if (gen() % 2 == 0) {
+        for (uint8_t& b : bytes) {
+            b = static_cast<uint8_t>(gen());
+        }
+    } else {
+        size_t i = 0;
+        while (i < bytes.size()) {
+            const uint8_t fill = (gen() % 2 == 0) ? 0x00 : 0xff;
+            const size_t len = 1 + gen() % (bytes.size() - i);
+            for (size_t k = 0; k < len; ++k, ++i) {
+                bytes[i] = fill;
+            }
+            if ((i < bytes.size()) && (gen() % 4 == 0)) {
+                bytes[i++] = static_cast<uint8_t>(gen());
+            }
+        }
+    }
+    if (bytes.back() == 0) {
+        bytes.back() = static_cast<uint8_t>(1 + gen() % 255);
+    }
+    return Unsigned::fromBytes(bytes.data(), bytes.size());
+}
+//------------------------------------------------------------------------------
+// Returns sizes straddling the threshold t in digits.
+vector<size_t> around(size_t t)
+{
+    vector<size_t> sizes;
+    for (size_t s : {t - 1, t, t + 1, 2 * t + 1}) {
+        if ((s > 0) && (s <= (size_t(1) << 14))) {
+            sizes.push_back(s);
+        }
+    }
+    return sizes;
+}
+//------------------------------------------------------------------------------
+// Returns the sizes of operands at which the kernel of an operation of two
+// operands of n and m digits changes.
+vector<size_t> sizes()
+{
+    vector<size_t> s = {1, 2, 3, 4, 5, 7, 8, 9, 16, 17, 31, 33};
+    size_t root = 1;
+    while (root * root < impl::parallelMulThreshold) {
+        ++root;
+    }
+    for (size_t t :
+         {root, impl::radixFormatThreshold, impl::radixParseThreshold}) {
+        for (size_t n : around(t)) {
+            s.push_back(n);
+        }
+    }
+    sort(s.begin(), s.end());
+    s.erase(unique(s.begin(), s.end()), s.end());
+    return s;
+}
+//------------------------------------------------------------------------------
+// Restores a single thread at the end of a scope.
+struct Threads
+{
+    explicit Threads(size_t n)
+    {
+        setThreadCount(n);
+    }
+    ~Threads()
+    {
+        setThreadCount(1);
+    }
+};
+//------------------------------------------------------------------------------
+}  // namespace
+//------------------------------------------------------------------------------
+TEST(DifferentialTest, addAndSubtract)
+{
+    mt19937 gen(1);
+    for (size_t n : sizes()) {
+        for (size_t m : {size_t(0), size_t(1), n / 2, n - 1, n}) {
+            for (size_t i = 0; i < iterations(); ++i) {
+                Unsigned u = randomNumber(n, gen);
+                Unsigned v = randomNumber(m, gen);
+                if (u < v) {
+                    swap(u, v);
+                }
+                const Ref ru = toRef(u);
+                const Ref rv = toRef(v);
+                ASSERT_EQ(add(ru, rv), toRef(u + v)) << u << " + " << v;
+                ASSERT_EQ(add(ru, rv), toRef(v + u)) << v << " + " << u;
+                ASSERT_EQ(subtract(ru, rv), toRef(u - v)) << u << " - " << v;
+                Unsigned w = u;
+                w += v;
+                ASSERT_EQ(add(ru, rv), toRef(w));
+                w -= u;
+                ASSERT_EQ(rv, toRef(w));
+            }
+        }
+    }
+}
+//------------------------------------------------------------------------------
+TEST(DifferentialTest, multiply)
+{
+    mt19937 gen(2);
+    for (size_t threads : {1, 4}) {
+        Threads t(threads);
+        for (size_t n : sizes()) {
+            for (size_t m : {size_t(1), n / 3 + 1, n, 2 * n + 3}) {
+                for (size_t i = 0; i < iterations(); ++i) {
+                    const Unsigned u = randomNumber(n, gen);
+                    const Unsigned v = randomNumber(m, gen);
+                    const Ref expected = multiply(toRef(u), toRef(v));
+                    ASSERT_EQ(expected, toRef(u * v)) << u << " * " << v;
+                    ASSERT_EQ(expected, toRef(v * u)) << v << " * " << u;
+                }
+            }
+        }
+    }
+}
+//------------------------------------------------------------------------------
+TEST(DifferentialTest, shortProducts)
+{
+    mt19937 gen(6);
+    const size_t bits = impl::bitsPerDigit;
+    for (size_t n : sizes()) {
+        for (size_t m : {size_t(1), n / 2 + 1, n}) {
+            for (size_t i = 0; i < iterations(); ++i) {
+                const Unsigned u = randomNumber(n, gen);
+                const Unsigned v = randomNumber(m, gen);
+                const Ref ru = toRef(u);
+                const Ref rv = toRef(v);
+                const Ref p = multiply(ru, rv);
+                for (size_t k :
+                     {size_t(0), size_t(1), m, n, n + m - 1, n + m}) {
+                    ASSERT_EQ(lowBits(p, k * bits), toRef(mulLow(u, v, k)))
+                        << u << " * " << v << " low " << k;
+                    ASSERT_EQ(lowBits(p, k * bits), toRef(mulLow(v, u, k)));
+                    // The result may be too small by less than max(k, 1).
+                    const Ref high = highBits(p, k * bits);
+                    const Ref r = toRef(mulHigh(u, v, k));
+                    const Ref bound = add(r, Ref{uint32_t(max(k, size_t(1)))});
+                    ASSERT_LE(compare(r, high), 0)
+                        << u << " * " << v << " high " << k;
+                    ASSERT_LT(compare(high, bound), 0)
+                        << u << " * " << v << " high " << k;
+                }
+                Ref mid;
+                for (size_t j = 0; j < m; ++j) {
+                    const Ref row = lowBits(
+                        highBits(ru, (m - 1 - j) * bits), (n - m + 1) * bits);
+                    const Ref vj = lowBits(highBits(rv, j * bits), bits);
+                    mid = add(mid, multiply(row, vj));
+                }
+                ASSERT_EQ(mid, toRef(mulMiddle(u, v))) << u << " mid " << v;
+            }
+        }
+    }
+}
+//------------------------------------------------------------------------------
+TEST(DifferentialTest, divide)
+{
+    mt19937 gen(3);
+    const impl::digit_t top = impl::digit_t(1) << (impl::bitsPerDigit - 1);
+    for (size_t n : sizes()) {
+        for (size_t m : {size_t(1), size_t(2), n / 2 + 1, n, n + 1}) {
+            for (size_t i = 0; i < iterations() + 2; ++i) {
+                const Unsigned u = randomNumber(n, gen);
+                Unsigned v = randomNumber(m, gen);
+                // Divisors with a normalized or a maximal leading digit.
+                if (i == 0) {
+                    v |= Unsigned(top) << (impl::bitsPerDigit * (m - 1));
+                } else if (i == 1) {
+                    v = (Unsigned(1) << (impl::bitsPerDigit * m)) - 1;
+                }
+                const pair<Ref, Ref> expected = divide(toRef(u), toRef(v));
+                const Unsigned::QR qr = div(u, v);
+                ASSERT_EQ(expected.first, toRef(qr.quot)) << u << " / " << v;
+                ASSERT_EQ(expected.second, toRef(qr.rem)) << u << " % " << v;
+                ASSERT_EQ(expected.first, toRef(u / v));
+                ASSERT_EQ(expected.second, toRef(u % v));
+                ASSERT_EQ(expected.first, toRef(divexact(u - qr.rem, v)))
+                    << u << " - " << qr.rem << " / " << v;
+                ASSERT_EQ(expected.second.empty(), isDivisible(u, v)) << u;
+                ASSERT_TRUE(isDivisible(u - qr.rem, v)) << u << " / " << v;
+                ASSERT_TRUE(isCongruent(u, qr.rem, v)) << u << " / " << v;
+            }
+        }
+    }
+}
+//------------------------------------------------------------------------------
+TEST(DifferentialTest, radixConversion)
+{
+    mt19937 gen(4);
+    vector<size_t> lengths = sizes();
+    for (size_t n : around(impl::parallelRadixThreshold)) {
+        lengths.push_back(n);
+    }
+    for (size_t threads : {1, 4}) {
+        Threads t(threads);
+        for (unsigned base : {2u, 3u, 7u, 8u, 10u, 16u, 32u, 36u}) {
+            for (size_t n : lengths) {
+                for (size_t i = 0; i < iterations(); ++i) {
+                    const Unsigned u = randomNumber(n, gen);
+                    const string expected = toString(toRef(u), base);
+                    ASSERT_EQ(expected, u.str(base)) << "base " << base;
+                    ASSERT_EQ(u, Unsigned::fromString(expected, base))
+                        << "base " << base << ": " << expected;
+                }
+            }
+        }
+    }
+}
+//------------------------------------------------------------------------------
+TEST(DifferentialTest, fixedAndBatch)
+{
+    constexpr size_t bits = 256;
+    mt19937 gen(5);
+    const size_t numDigits = bits / impl::bitsPerDigit;
+    vector<Unsigned> us;
+    vector<Unsigned> vs;
+    for (size_t n = 1; n <= numDigits; ++n) {
+        for (size_t i = 0; i < iterations(); ++i) {
+            us.push_back(randomNumber(n, gen));
+            vs.push_back(randomNumber(1 + gen() % numDigits, gen));
+        }
+    }
+    const FixedUnsigned<bits> m(randomNumber(numDigits / 2 + 1, gen));
+    const Ref mod = toRef(static_cast<Unsigned>(m));
+    for (size_t i = 0; i < us.size(); ++i) {
+        const FixedUnsigned<bits> u(us[i]);
+        const FixedUnsigned<bits> v(vs[i]);
+        const Ref ru = toRef(us[i]);
+        const Ref rv = toRef(vs[i]);
+        ASSERT_EQ(
+            lowBits(add(ru, rv), bits), toRef(static_cast<Unsigned>(u + v)));
+        ASSERT_EQ(
+            lowBits(multiply(ru, rv), bits),
+            toRef(static_cast<Unsigned>(u * v)));
+        if (compare(ru, rv) >= 0) {
+            ASSERT_EQ(subtract(ru, rv), toRef(static_cast<Unsigned>(u - v)));
+        }
+        const pair<Ref, Ref> expected = divide(ru, rv);
+        const typename FixedUnsigned<bits>::QR qr = div(u, v);
+        ASSERT_EQ(expected.first, toRef(static_cast<Unsigned>(qr.quot)));
+        ASSERT_EQ(expected.second, toRef(static_cast<Unsigned>(qr.rem)));
+    }
+
+    const UnsignedBatch<bits> bu = UnsignedBatch<bits>::fromUnsigned(us);
+    const UnsignedBatch<bits> bv = UnsignedBatch<bits>::fromUnsigned(vs);
+    UnsignedBatch<bits> sum(us.size());
+    UnsignedBatch<bits> product(us.size());
+    UnsignedBatch<bits> rem(us.size());
+    batchAdd(bu, bv, sum);
+    batchMul(bu, bv, product);
+    batchMod(bu, m, rem);
+    UnsignedBatch<bits> square = bu;
+    batchMul(square, square, square);
+    const vector<Unsigned> sums = sum.toUnsigned();
+    const vector<Unsigned> products = product.toUnsigned();
+    const vector<Unsigned> rems = rem.toUnsigned();
+    const vector<Unsigned> squares = square.toUnsigned();
+    for (size_t i = 0; i < us.size(); ++i) {
+        const Ref ru = toRef(us[i]);
+        const Ref rv = toRef(vs[i]);
+        ASSERT_EQ(lowBits(add(ru, rv), bits), toRef(sums[i]));
+        ASSERT_EQ(lowBits(multiply(ru, rv), bits), toRef(products[i]));
+        ASSERT_EQ(lowBits(multiply(ru, ru), bits), toRef(squares[i]));
+        ASSERT_EQ(divide(ru, mod).second, toRef(rems[i]));
+    }
+}
@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) 2024 Stefan Uhrig
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+//------------------------------------------------------------------------------
+#include "bignum.h"
+
+#include <gmock/gmock.h>
+
+#include <random>
+//------------------------------------------------------------------------------
+using namespace bn;
+using namespace std;
+//------------------------------------------------------------------------------
+using S64 = FixedSigned<64>;
+using S128 = FixedSigned<128>;
+//------------------------------------------------------------------------------
+TEST(FixedSignedTest, constructDefault)
+{
+    S128 s;
+    EXPECT_EQ(0, s.sgn());
+    EXPECT_EQ("0", s.str());
+}
+//------------------------------------------------------------------------------
+TEST(FixedSignedTest, constructFromIntegral)
+{
+    EXPECT_EQ("-123", S64(-123).str());
+    EXPECT_EQ("-9223372036854775808", S64(INT64_MIN).str());
+    EXPECT_EQ("9223372036854775807", S64(INT64_MAX).str());
+    EXPECT_EQ("18446744073709551615", S128(UINT64_MAX).str());
+    EXPECT_THROW(S64(UINT64_MAX), std::overflow_error);
+    EXPECT_EQ(-1, S64(INT64_MIN).sgn());
+    EXPECT_EQ(1, S64(7).sgn());
+}
+//------------------------------------------------------------------------------
+TEST(FixedSignedTest, convertSigned)
+{
+    Signed s = -Signed(pow(Unsigned(2), 127));
+    S128 f(s);
+    EXPECT_EQ(s, static_cast<Signed>(f));
+    EXPECT_EQ(s.abs(), static_cast<Unsigned>(f.abs()));
+    EXPECT_THROW(S128(-s), std::overflow_error);
+    EXPECT_THROW(S128(s - 1), std::overflow_error);
+    EXPECT_EQ(-s - 1, static_cast<Signed>(S128(-s - 1)));
+}
+//------------------------------------------------------------------------------
+TEST(FixedSignedTest, randomAgainstInt64)
+{
+    std::mt19937_64 gen(0);
+    for (int i = 0; i < 2000; ++i) {
+        int64_t a = static_cast<int64_t>(gen()) >> (gen() % 64);
+        int64_t b = static_cast<int64_t>(gen()) >> (gen() % 64);
+        S64 fa(a);
+        S64 fb(b);
+        uint64_t ua = static_cast<uint64_t>(a);
+        uint64_t ub = static_cast<uint64_t>(b);
+        EXPECT_EQ(S64(static_cast<int64_t>(ua + ub)), fa + fb);
+        EXPECT_EQ(S64(static_cast<int64_t>(ua - ub)), fa - fb);
+        EXPECT_EQ(S64(static_cast<int64_t>(ua * ub)), fa * fb);
+        EXPECT_EQ(S64(static_cast<int64_t>(0 - ua)), -fa);
+        EXPECT_EQ(a < b, fa < fb);
+        EXPECT_EQ(a <= b, fa <= fb);
+        EXPECT_EQ(a == b, fa == fb);
+        if ((b != 0) && !((a == INT64_MIN) && (b == -1))) {
+            EXPECT_EQ(S64(a / b), fa / fb);
+            EXPECT_EQ(S64(a % b), fa % fb);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+TEST(FixedSignedTest, incrementAndDecrement)
+{
+    S64 s(INT64_MAX);
+    EXPECT_EQ(S64(INT64_MIN), ++s);
+    EXPECT_EQ(S64(INT64_MIN), s--);
+    EXPECT_EQ(S64(INT64_MAX), s);
+    S64 z(0);
+    EXPECT_EQ(S64(-1), --z);
+    EXPECT_EQ(S64(-1), z++);
+    EXPECT_EQ(0, z.sgn());
+}
+//------------------------------------------------------------------------------
+TEST(FixedSignedTest, operatorOut)
+{
+    std::ostringstream s;
+    s << S128(-42);
+    EXPECT_EQ("-42", s.str());
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,200 @@
+/**
+ * Copyright (c) 2024 Stefan Uhrig
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+//------------------------------------------------------------------------------
+#include "bignum.h"
+
+#include <gmock/gmock.h>
+
+#include <random>
+//------------------------------------------------------------------------------
+using namespace bn;
+using namespace std;
+//------------------------------------------------------------------------------
+using U64 = FixedUnsigned<64>;
+using U256 = FixedUnsigned<256>;
+//------------------------------------------------------------------------------
+TEST(FixedUnsignedTest, constructDefault)
+{
+    U256 u;
+    EXPECT_TRUE(u.empty());
+    EXPECT_EQ(0u, u.bits());
+    EXPECT_EQ("0", u.str());
+}
+//------------------------------------------------------------------------------
+TEST(FixedUnsignedTest, constexprLiteral)
+{
+    constexpr FixedUnsigned<128> max =
+        340282366920938463463374607431768211455_bn;
+    constexpr FixedUnsigned<128> prime =
+        170141183460469231731687303715884105727_bn;
+    constexpr FixedUnsigned<128> zero = 0_bn;
+    static_assert(!max.empty(), "literal must not be empty");
+    static_assert(zero.empty(), "literal must be empty");
+    static_assert(prime < max, "literals must compare");
+    static_assert(prime != max, "literals must compare");
+    static_assert(
+        max == FixedUnsigned<128>(340282366920938463463374607431768211455_bn),
+        "literals must compare");
+    EXPECT_EQ("340282366920938463463374607431768211455", max.str());
+    EXPECT_EQ((Unsigned(1) << 127) - 1, static_cast<Unsigned>(prime));
+    EXPECT_EQ(prime + prime + FixedUnsigned<128>(1), max);
+    EXPECT_TRUE((++FixedUnsigned<128>(max)).empty());
+}
+//------------------------------------------------------------------------------
+TEST(FixedUnsignedTest, constructFromIntegral)
+{
+    EXPECT_EQ("123", U64(123).str());
+    EXPECT_EQ("4294967295", U64(0xffffffffu).str());
+    EXPECT_EQ("9223372036854775807", U64(INT64_MAX).str());
+    EXPECT_EQ("18446744073709551615", U256(UINT64_MAX).str());
+    EXPECT_THROW(U64(-1), std::invalid_argument);
+    EXPECT_THROW(U64(INT64_MIN), std::invalid_argument);
+}
+//------------------------------------------------------------------------------
+TEST(FixedUnsignedTest, convertUnsigned)
+{
+    Unsigned u = pow(Unsigned(3), 150);
+    U256 f(u);
+    EXPECT_EQ(u.str(), f.str());
+    EXPECT_EQ(u, static_cast<Unsigned>(f));
+    EXPECT_EQ(u.bits(), f.bits());
+    EXPECT_THROW(U256(Unsigned(1) << 256), std::overflow_error);
+    EXPECT_THROW(static_cast<uint64_t>(f), std::overflow_error);
+    EXPECT_EQ(UINT64_MAX, static_cast<uint64_t>(U256(UINT64_MAX)));
+    EXPECT_EQ(Unsigned(), static_cast<Unsigned>(U256()));
+}
+//------------------------------------------------------------------------------
+TEST(FixedUnsignedTest, wrapAround)
+{
+    U64 max(UINT64_MAX);
+    U64 u = max;
+    EXPECT_TRUE((++u).empty());
+    EXPECT_EQ(max, --u);
+    EXPECT_EQ(max, u++);
+    EXPECT_EQ(U64(0), u--);
+    EXPECT_EQ(max, u);
+    EXPECT_EQ(max * max, U64(1));
+    EXPECT_EQ(U64() - U64(5), U64(UINT64_MAX - 4));
+    EXPECT_EQ(U64(1) << 64, U64());
+    EXPECT_EQ(max >> 63, U64(1));
+}
+//------------------------------------------------------------------------------
+TEST(FixedUnsignedTest, randomAgainstUint64)
+{
+    std::mt19937_64 gen(0);
+    for (int i = 0; i < 2000; ++i) {
+        uint64_t a = gen() >> (gen() % 64);
+        uint64_t b = gen() >> (gen() % 64);
+        unsigned s = gen() % 64;
+        U64 fa(a);
+        U64 fb(b);
+        EXPECT_EQ(a + b, static_cast<uint64_t>(fa + fb));
+        EXPECT_EQ(a - b, static_cast<uint64_t>(fa - fb));
+        EXPECT_EQ(a * b, static_cast<uint64_t>(fa * fb));
+        EXPECT_EQ(a | b, static_cast<uint64_t>(fa | fb));
+        EXPECT_EQ(a & b, static_cast<uint64_t>(fa & fb));
+        EXPECT_EQ(a ^ b, static_cast<uint64_t>(fa ^ fb));
+        EXPECT_EQ(a << s, static_cast<uint64_t>(fa << s));
+        EXPECT_EQ(a >> s, static_cast<uint64_t>(fa >> s));
+        EXPECT_EQ(a < b, fa < fb);
+        EXPECT_EQ(a == b, fa == fb);
+        if (b != 0) {
+            EXPECT_EQ(a / b, static_cast<uint64_t>(fa / fb));
+            EXPECT_EQ(a % b, static_cast<uint64_t>(fa % fb));
+        }
+    }
+}
+//------------------------------------------------------------------------------
+TEST(FixedUnsignedTest, randomAgainstUnsigned)
+{
+    std::mt19937 gen(0);
+    const Unsigned mod = Unsigned(1) << 256;
+    for (int i = 0; i < 500; ++i) {
+        Unsigned a = Unsigned::random(1 + gen() % 256, gen);
+        Unsigned b = Unsigned::random(1 + gen() % 256, gen);
+        U256 fa(a);
+        U256 fb(b);
+        EXPECT_EQ((a + b) % mod, static_cast<Unsigned>(fa + fb));
+        EXPECT_EQ((a + mod - b) % mod, static_cast<Unsigned>(fa - fb));
+        EXPECT_EQ((a * b) % mod, static_cast<Unsigned>(fa * fb));
+        EXPECT_EQ(a * b, static_cast<Unsigned>(mulWide(fa, fb)));
+        EXPECT_EQ(a.str(), fa.str());
+        if (!b.empty()) {
+            Unsigned::QR qr = div(a, b);
+            U256::QR fqr = div(fa, fb);
+            EXPECT_EQ(qr.quot, static_cast<Unsigned>(fqr.quot));
+            EXPECT_EQ(qr.rem, static_cast<Unsigned>(fqr.rem));
+        }
+    }
+}
+//------------------------------------------------------------------------------
+TEST(FixedUnsignedTest, divisionByZero)
+{
+    U256 u(1);
+    EXPECT_THROW(u / U256(), std::invalid_argument);
+    EXPECT_THROW(u % U256(), std::invalid_argument);
+    EXPECT_THROW(div(u, U256()), std::invalid_argument);
+}
+//------------------------------------------------------------------------------
+TEST(FixedUnsignedTest, operatorOut)
+{
+    std::ostringstream s;
+    s << U256(Unsigned("123456789012345678901234567890"));
+    EXPECT_EQ("123456789012345678901234567890", s.str());
+}
+//------------------------------------------------------------------------------
+TEST(FixedUnsignedTest, batch)
+{
+    mt19937 gen(0);
+    const size_t lanes = 37;
+    vector<Unsigned> a;
+    vector<Unsigned> b;
+    for (size_t l = 0; l < lanes; ++l) {
+        a.push_back(Unsigned::random(256, gen));
+        b.push_back(Unsigned::random(l * 7, gen));
+    }
+    UnsignedBatch<256> ua = UnsignedBatch<256>::fromUnsigned(a);
+    UnsignedBatch<256> ub = UnsignedBatch<256>::fromUnsigned(b);
+    EXPECT_EQ(lanes, ua.size());
+    EXPECT_EQ(a, ua.toUnsigned());
+    EXPECT_EQ(U256(b[5]), ub.get(5));
+
+    const Unsigned mod = Unsigned(1) << 256;
+    UnsignedBatch<256> w;
+    batchAdd(ua, ub, w);
+    batchMul(w, ub, w);
+    const U256 m(Unsigned("1000000000000000000000000000057"));
+    batchMod(w, m, w);
+    vector<Unsigned> r = w.toUnsigned();
+    for (size_t l = 0; l < lanes; ++l) {
+        Unsigned e = (a[l] + b[l]) % mod * b[l] % mod % Unsigned(m);
+        EXPECT_EQ(e, r[l]);
+    }
+
+    ua.set(0, U256(7));
+    EXPECT_EQ(U256(7), ua.get(0));
+    EXPECT_EQ(7, ua.row(0)[0]);
+    EXPECT_THROW(batchAdd(ua, UnsignedBatch<256>(3), w), std::invalid_argument);
+    EXPECT_THROW(batchMul(ua, UnsignedBatch<256>(3), w), std::invalid_argument);
+    EXPECT_THROW(batchMod(ua, U256(), w), std::invalid_argument);
+    EXPECT_THROW(
+        UnsignedBatch<64>::fromUnsigned(vector<Unsigned>{Unsigned(1) << 64}),
+        std::overflow_error);
+}
+//------------------------------------------------------------------------------
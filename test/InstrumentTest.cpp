@@ -0,0 +1,191 @@
+/**
+ * Copyright (c) 2024 Stefan Uhrig
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+//------------------------------------------------------------------------------
+#include "bignum.h"
+
+#include <gmock/gmock.h>
+
+#include <random>
+#include <string>
+//------------------------------------------------------------------------------
+using namespace bn;
+using namespace std;
+//------------------------------------------------------------------------------
+namespace {
+//------------------------------------------------------------------------------
+const OperationStatistics& stats(const Statistics& s, Operation op)
+{
+    return s.operations[static_cast<size_t>(op)];
+}
+//------------------------------------------------------------------------------
+}  // namespace
+//------------------------------------------------------------------------------
+TEST(InstrumentTest, reset)
+{
+    Unsigned u = Unsigned(1) << 1000;
+    u = u * u + u;
+    resetStatistics();
+    const Statistics s = statistics();
+    for (size_t i = 0; i < numOperations; ++i) {
+        EXPECT_EQ(0u, s.operations[i].calls);
+        EXPECT_EQ(0u, s.operations[i].nanoseconds);
+        for (size_t k = 0; k < numSizeBuckets; ++k) {
+            EXPECT_EQ(0u, s.operations[i].sizes[k]);
+        }
+    }
+    EXPECT_EQ(0u, s.allocations);
+    EXPECT_EQ(0u, s.allocatedBytes);
+    EXPECT_EQ(0u, s.reallocations);
+    EXPECT_EQ(0u, s.deallocations);
+}
+//------------------------------------------------------------------------------
+TEST(InstrumentTest, operations)
+{
+    std::mt19937 gen(0);
+    const Unsigned u = Unsigned::random(1000, gen) | (Unsigned(1) << 999);
+    const Unsigned v = Unsigned::random(500, gen) | (Unsigned(1) << 499);
+    resetStatistics();
+
+    const Unsigned w = u * v;
+    Statistics s = statistics();
+    EXPECT_EQ(1u, stats(s, Operation::multiply).calls);
+    EXPECT_EQ(
+        1u,
+        stats(s, Operation::multiply).sizes[impl::sizeBucket(u.digits())]);
+    EXPECT_EQ(0u, stats(s, Operation::add).calls);
+    EXPECT_GE(s.allocations, 1u);
+    EXPECT_GE(s.allocatedBytes, w.digits() * sizeof(impl::digit_t));
+
+    EXPECT_EQ(u, w / v);
+    Unsigned x = u + v;
+    x -= v;
+    x += v;
+    EXPECT_EQ(u + v, x);
+    s = statistics();
+    EXPECT_EQ(1u, stats(s, Operation::divide).calls);
+    EXPECT_EQ(3u, stats(s, Operation::add).calls);
+    EXPECT_EQ(1u, stats(s, Operation::subtract).calls);
+
+    resetStatistics();
+    EXPECT_EQ(u, Unsigned(u.str().c_str()));
+    EXPECT_EQ(u, sqrt(u * u));
+    EXPECT_EQ(v, gcd(u * v, v));
+    powmod(u, v, w);
+    s = statistics();
+    EXPECT_EQ(1u, stats(s, Operation::format).calls);
+    EXPECT_EQ(1u, stats(s, Operation::parse).calls);
+    EXPECT_EQ(1u, stats(s, Operation::sqrt).calls);
+    EXPECT_EQ(1u, stats(s, Operation::gcd).calls);
+    EXPECT_EQ(1u, stats(s, Operation::powmod).calls);
+    EXPECT_GT(stats(s, Operation::multiply).calls, 500u);
+    EXPECT_GT(stats(s, Operation::powmod).nanoseconds, 0u);
+    EXPECT_GE(
+        stats(s, Operation::powmod).nanoseconds,
+        stats(s, Operation::multiply).nanoseconds);
+    // The square has 2*u.digits() - 1 digits if the product of the leading
+    // digits does not carry, so the bucket is taken from the square itself.
+    const Unsigned square = u * u;
+    EXPECT_EQ(
+        1u, stats(s, Operation::sqrt).sizes[impl::sizeBucket(square.digits())]);
+    EXPECT_EQ(
+        1u, stats(s, Operation::format).sizes[impl::sizeBucket(u.digits())]);
+}
+//------------------------------------------------------------------------------
+TEST(InstrumentTest, allocations)
+{
+    Unsigned u = Unsigned(1) << 1000;
+    resetStatistics();
+    u <<= 10000;
+    Statistics s = statistics();
+    EXPECT_EQ(1u, s.allocations);
+    EXPECT_EQ(1u, s.reallocations);
+    EXPECT_EQ(1u, s.deallocations);
+    EXPECT_GE(s.allocatedBytes, 11000 / 8u);
+
+    Unsigned v = u;
+    s = statistics();
+    EXPECT_EQ(2u, s.allocations);
+    EXPECT_EQ(1u, s.reallocations);
+}
+//------------------------------------------------------------------------------
+TEST(InstrumentTest, outputParametersReuseMemory)
+{
+    std::mt19937 gen(1);
+    const Unsigned m = Unsigned::random(800, gen) | (Unsigned(1) << 799);
+    const Unsigned e = Unsigned::random(64, gen);
+    Unsigned u = Unsigned::random(800, gen) % m;
+    Unsigned v = Unsigned::random(800, gen) % m;
+    Unsigned w;
+    Unsigned q;
+    Unsigned r;
+    // The first round grows the destinations, the second must not allocate.
+    for (int round = 0; round < 2; ++round) {
+        resetStatistics();
+        for (int i = 0; i < 10; ++i) {
+            mul(w, u, v);
+            divQR(q, r, w, m);
+            add(u, r, v);
+            sub(u, u, v);
+            divQR(q, v, u, m);
+        }
+    }
+    EXPECT_EQ(0u, statistics().allocations);
+
+    powmod(w, u, e, m);
+    resetStatistics();
+    powmod(w, u, e, m);
+    const size_t allocations = statistics().allocations;
+    powmod(w, u, e * e * e, m);
+    EXPECT_EQ(allocations, statistics().allocations - allocations);
+
+    // With scratch numbers of the caller, only the first call allocates.
+    PowmodScratch scratch;
+    const Unsigned e3 = e * e * e;
+    powmod(w, u, e3, m, scratch);
+    const Unsigned expected = w;
+    resetStatistics();
+    powmod(w, u, e3, m, scratch);
+    EXPECT_EQ(0u, statistics().allocations);
+    EXPECT_EQ(expected, w);
+}
+//------------------------------------------------------------------------------
+TEST(InstrumentTest, formatWithoutAllocations)
+{
+    // Numbers converted without splitting are divided in a copy on the stack.
+    std::mt19937 gen(2);
+    const Unsigned u = Unsigned::random(
+        impl::radixFormatThreshold * impl::bitsPerDigit, gen);
+    const string expected = u.str();
+    string s(expected.size(), ' ');
+    resetStatistics();
+    const ToCharsResult r = to_chars(&s[0], &s[0] + s.size(), u);
+    EXPECT_EQ(0u, statistics().allocations);
+    EXPECT_EQ(std::errc(), r.ec);
+    EXPECT_EQ(expected, s);
+    EXPECT_EQ(
+        std::errc::value_too_large,
+        to_chars(&s[0], &s[0] + s.size() - 1, u).ec);
+}
+//------------------------------------------------------------------------------
+TEST(InstrumentTest, operationName)
+{
+    EXPECT_STREQ("add", operationName(Operation::add));
+    EXPECT_STREQ("multiply", operationName(Operation::multiply));
+    EXPECT_STREQ("parse", operationName(Operation::parse));
+}
@@ -399,6 +399,55 @@ TEST(RationalTest, operatorDiv)
     EXPECT_THROW(rm12 / r01, invalid_argument);
 }
 //------------------------------------------------------------------------------
+TEST(RationalTest, nativeOperators)
+{
+    const Rational big(Signed("-1234567890123456789012345"), Unsigned(7777));
+    const int64_t values[] = {0, 1, -1, 6, -35, 1111, 1000003,
+                              numeric_limits<int64_t>::max(),
+                              numeric_limits<int64_t>::min()};
+    const Rational rs[] = {big, -big, Rational(Signed(-3), Unsigned(7)),
+                           Rational(Signed(42)), Rational()};
+    for (const Rational& u : rs) {
+        for (int64_t i : values) {
+            const Rational v(impl::toSigned(i));
+            EXPECT_EQ(u + v, u + i) << u << " " << i;
+            EXPECT_EQ(v + u, i + u) << u << " " << i;
+            EXPECT_EQ(u - v, u - i) << u << " " << i;
+            EXPECT_EQ(v - u, i - u) << u << " " << i;
+            EXPECT_EQ(u * v, u * i) << u << " " << i;
+            EXPECT_EQ(v * u, i * u) << u << " " << i;
+            EXPECT_EQ(u == v, u == i);
+            EXPECT_EQ(u != v, i != u);
+            EXPECT_EQ(u < v, u < i) << u << " " << i;
+            EXPECT_EQ(v < u, i < u) << u << " " << i;
+            EXPECT_EQ(u >= v, u >= i);
+            EXPECT_EQ(u > v, u > i);
+            EXPECT_EQ(u <= v, u <= i);
+            if (i != 0) {
+                EXPECT_EQ(u / v, u / i) << u << " " << i;
+            } else {
+                EXPECT_THROW(u / i, invalid_argument);
+            }
+            if (u != 0) {
+                EXPECT_EQ(v / u, i / u) << u << " " << i;
+            }
+        }
+    }
+    Rational w(Signed(3), Unsigned(4));
+    w *= 2;
+    EXPECT_EQ(Rational(Signed(3), Unsigned(2)), w);
+    w /= -9;
+    EXPECT_EQ(Rational(Signed(-1), Unsigned(6)), w);
+    w += 1u;
+    EXPECT_EQ(Rational(Signed(5), Unsigned(6)), w);
+    w -= 1;
+    EXPECT_EQ(Rational(Signed(-1), Unsigned(6)), w);
+    w *= 6;
+    EXPECT_EQ(-1, w);
+    EXPECT_EQ(Signed(-1), w.numerator());
+    EXPECT_EQ(Unsigned(1), w.denominator());
+}
+//------------------------------------------------------------------------------
 TEST(RationalTest, operatorStream)
 {
     Rational rm12(-1, 2);
@@ -406,3 +455,140 @@ TEST(RationalTest, operatorStream)
     os << rm12;
     EXPECT_EQ(string("-1/2"), os.str());
 }
+//------------------------------------------------------------------------------
+TEST(RationalTest, serialize)
+{
+    Rational r(Signed("-12345678901234567890"), Unsigned("98765432109876543"));
+    vector<unsigned char> buf(serializedSize(r));
+    EXPECT_EQ(buf.size(), serialize(buf.data(), buf.size(), r));
+    EXPECT_EQ(0x13, buf[0]);
+    Rational q;
+    EXPECT_EQ(buf.size(), deserialize(buf.data(), buf.size(), q));
+    EXPECT_EQ(r, q);
+    Signed s;
+    EXPECT_THROW(deserialize(buf.data(), buf.size(), s), std::invalid_argument);
+    EXPECT_THROW(
+        deserialize(buf.data(), buf.size() - 1, q), std::invalid_argument);
+
+    const unsigned char zeroDen[] = {0x12, 0x01, 0x01, 0x00};
+    EXPECT_THROW(
+        deserialize(zeroDen, sizeof(zeroDen), q), std::invalid_argument);
+    const unsigned char unreduced[] = {0x12, 0x01, 0x06, 0x01, 0x04};
+    EXPECT_THROW(
+        deserialize(unreduced, sizeof(unreduced), q), std::invalid_argument);
+    const unsigned char zeroNum[] = {0x12, 0x00, 0x01, 0x05};
+    EXPECT_THROW(
+        deserialize(zeroNum, sizeof(zeroNum), q), std::invalid_argument);
+    const unsigned char zero[] = {0x12, 0x00, 0x01, 0x01};
+    EXPECT_EQ(4u, deserialize(zero, sizeof(zero), q));
+    EXPECT_EQ(Rational(), q);
+    const unsigned char reduced[] = {0x13, 0x01, 0x03, 0x01, 0x02};
+    EXPECT_EQ(5u, deserialize(reduced, sizeof(reduced), q));
+    EXPECT_EQ(Rational(-3, 2), q);
+    const unsigned char integer[] = {0x11, 0x01, 0x07};
+    EXPECT_EQ(3u, deserialize(integer, sizeof(integer), q));
+    EXPECT_EQ(Rational(-7), q);
+
+    stringstream ss;
+    serialize(ss, r);
+    serialize(ss, Signed(-7));
+    Rational a, b;
+    deserialize(ss, a);
+    deserialize(ss, b);
+    EXPECT_EQ(r, a);
+    EXPECT_EQ(Rational(-7), b);
+}
+//------------------------------------------------------------------------------
+TEST(RationalTest, continuedFraction)
+{
+    auto expand = [](const Rational& x) {
+        vector<Signed> terms;
+        ContinuedFraction cf = continuedFraction(x);
+        while (cf.hasNext()) {
+            terms.push_back(cf.next());
+        }
+        EXPECT_THROW(cf.next(), logic_error);
+        return terms;
+    };
+
+    EXPECT_EQ(vector<Signed>({0}), expand(Rational()));
+    EXPECT_EQ(vector<Signed>({-3}), expand(Rational(-3)));
+    EXPECT_EQ(vector<Signed>({4, 2, 6, 7}), expand(Rational(415, 93)));
+    EXPECT_EQ(vector<Signed>({-5, 1, 1, 6, 7}), expand(Rational(-415, 93)));
+
+    // Quotient that does not fit into single precision
+    Unsigned big = Unsigned(1) << 200;
+    EXPECT_EQ(
+        vector<Signed>({0, big, 3}), expand(Rational(3, 3 * big + 1)));
+
+    // Consecutive Fibonacci numbers require Lehmer steps with many quotients
+    Unsigned f1 = 1;
+    Unsigned f2 = 1;
+    for (int i = 0; i < 500; ++i) {
+        Unsigned f = f1 + f2;
+        f1 = move(f2);
+        f2 = move(f);
+    }
+    vector<Signed> fib = expand(Rational(f2, f1));
+    EXPECT_EQ(500u, fib.size());
+    EXPECT_EQ(Signed(2), fib.back());
+    fib.pop_back();
+    EXPECT_EQ(vector<Signed>(fib.size(), 1), fib);
+
+    // Compare with the Euclidean algorithm on random numbers
+    mt19937 gen(0);
+    for (int i = 0; i < 20; ++i) {
+        Unsigned num = Unsigned::random(1000 + i * 37, gen);
+        Unsigned den = Unsigned::random(900 + i * 53, gen) + 1;
+        Rational x(num, den);
+        Unsigned a = x.numerator().abs();
+        Unsigned b = x.denominator();
+        vector<Signed> exp;
+        while (!b.empty()) {
+            Unsigned::QR qr = div(a, b);
+            exp.push_back(qr.quot);
+            a = move(b);
+            b = move(qr.rem);
+        }
+        EXPECT_EQ(exp, expand(x));
+    }
+}
+//------------------------------------------------------------------------------
+TEST(RationalTest, bestApproximation)
+{
+    Rational x = 3.141592653589793;
+    EXPECT_EQ(Rational(3), bestApproximation(x, 1));
+    EXPECT_EQ(Rational(22, 7), bestApproximation(x, 10));
+    EXPECT_EQ(Rational(311, 99), bestApproximation(x, 100));
+    EXPECT_EQ(Rational(355, 113), bestApproximation(x, 1000));
+    EXPECT_EQ(Rational(-355, 113), bestApproximation(-x, 1000));
+    EXPECT_EQ(x, bestApproximation(x, x.denominator()));
+    EXPECT_EQ(Rational(1, 3), bestApproximation(Rational(1, 3), 3));
+    EXPECT_EQ(Rational(0), bestApproximation(Rational(1, 5), 2));
+    EXPECT_EQ(Rational(1, 2), bestApproximation(Rational(3, 10), 2));
+    EXPECT_THROW(bestApproximation(x, 0), invalid_argument);
+
+    // Exhaustive comparison for small denominators
+    for (int n = -12; n <= 12; ++n) {
+        for (int d = 1; d <= 12; ++d) {
+            Rational y(n, d);
+            for (int m = 1; m <= 5; ++m) {
+                Rational best;
+                Rational bestErr;
+                bool found = false;
+                for (int k = 1; k <= m; ++k) {
+                    int h = static_cast<int>(floor(double(n) * k / d));
+                    for (Rational c : {Rational(h, k), Rational(h + 1, k)}) {
+                        Rational err = (c > y) ? c - y : y - c;
+                        if (!found || (err < bestErr)) {
+                            best = c;
+                            bestErr = err;
+                            found = true;
+                        }
+                    }
+                }
+                EXPECT_EQ(best, bestApproximation(y, m));
+            }
+        }
+    }
+}
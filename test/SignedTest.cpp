@@ -94,6 +94,75 @@ TEST(SignedTest, constructFromString)
     EXPECT_EQ(ones, one.str());
 }
 //------------------------------------------------------------------------------
+TEST(SignedTest, fromStringAndStrWithBase)
+{
+    EXPECT_EQ(Signed(-255), Signed::fromString("-ff", 16));
+    EXPECT_EQ(Signed(0), Signed::fromString("-0", 2));
+    EXPECT_EQ(Signed(35), Signed::fromString("Z", 36));
+    EXPECT_EQ("-ff", Signed(-255).str(16));
+    EXPECT_EQ("-FF", Signed(-255).str(16, true));
+    EXPECT_EQ("0", Signed(0).str(16));
+    EXPECT_THROW(Signed::fromString("-", 10), invalid_argument);
+    EXPECT_THROW(Signed::fromString("--1", 10), invalid_argument);
+
+    ostringstream os;
+    os << showbase << hex << Signed(-255) << " " << Signed(0) << " " << oct
+       << Signed(8);
+    EXPECT_EQ("-0xff 0 010", os.str());
+}
+//------------------------------------------------------------------------------
+TEST(SignedTest, toAndFromChars)
+{
+    char buf[64];
+    Signed s("-123456789012345678901234567890");
+    ASSERT_LE(31u, maxChars(s));
+    ToCharsResult r = to_chars(buf, buf + sizeof(buf), s);
+    EXPECT_EQ(std::errc(), r.ec);
+    EXPECT_EQ(s.str(), std::string(buf, r.ptr));
+    EXPECT_EQ(std::errc::value_too_large, to_chars(buf, buf + 30, s).ec);
+    EXPECT_EQ(std::errc::value_too_large, to_chars(buf, buf, s).ec);
+
+    Signed t;
+    FromCharsResult fr = from_chars(buf, r.ptr, t);
+    EXPECT_EQ(std::errc(), fr.ec);
+    EXPECT_EQ(r.ptr, fr.ptr);
+    EXPECT_EQ(s, t);
+    const char m[] = "-x";
+    fr = from_chars(m, m + 2, t);
+    EXPECT_EQ(std::errc::invalid_argument, fr.ec);
+    EXPECT_EQ(m, fr.ptr);
+    EXPECT_EQ(s, t);
+}
+//------------------------------------------------------------------------------
+TEST(SignedTest, serialize)
+{
+    Signed s("-123456789012345678901234567890");
+    vector<unsigned char> buf(serializedSize(s));
+    EXPECT_EQ(buf.size(), serialize(buf.data(), buf.size(), s));
+    EXPECT_EQ(0x11, buf[0]);
+    Signed t;
+    EXPECT_EQ(buf.size(), deserialize(buf.data(), buf.size(), t));
+    EXPECT_EQ(s, t);
+    Unsigned u;
+    EXPECT_THROW(deserialize(buf.data(), buf.size(), u), std::invalid_argument);
+
+    serialize(buf.data(), buf.size(), -s);
+    EXPECT_EQ(buf.size(), deserialize(buf.data(), buf.size(), u));
+    EXPECT_EQ(s.abs(), u);
+
+    stringstream ss;
+    serialize(ss, s);
+    serialize(ss, Signed());
+    serialize(ss, Unsigned(5));
+    Signed a, b, c;
+    deserialize(ss, a);
+    deserialize(ss, b);
+    deserialize(ss, c);
+    EXPECT_EQ(s, a);
+    EXPECT_EQ(Signed(), b);
+    EXPECT_EQ(Signed(5), c);
+}
+//------------------------------------------------------------------------------
 TEST(SignedTest, abs)
 {
     Unsigned one = 1;
@@ -342,6 +411,9 @@ TEST(SignedTest, comparisonLT)
     EXPECT_TRUE(zero < one);
     EXPECT_FALSE(one < zero);
     EXPECT_TRUE(one < two);
+    EXPECT_TRUE(-two < -one);
+    EXPECT_FALSE(-one < -two);
+    EXPECT_TRUE(-one < zero);
 }
 //------------------------------------------------------------------------------
 TEST(SignedTest, comparisonGET)
@@ -481,6 +553,101 @@ TEST(SignedTest, div)
     Signed::QR qr5 = div(zero, three);
     EXPECT_EQ(zero, qr5.quot);
     EXPECT_EQ(zero, qr5.rem);
+
+    Signed::QR qr6 = div(mthree, five);
+    EXPECT_EQ(zero, qr6.quot);
+    EXPECT_EQ(mthree, qr6.rem);
+
+    Signed::QR qr7 = div(five * mthree, five);
+    EXPECT_EQ(mthree, qr7.quot);
+    EXPECT_EQ(zero, qr7.rem);
+}
+//------------------------------------------------------------------------------
+TEST(SignedTest, nativeOperators)
+{
+    const Signed big = Signed("-123456789012345678901234567890");
+    const int64_t values[] = {0, 1, -1, 7, -200, 1000003, -1000003,
+                              numeric_limits<int64_t>::max(),
+                              numeric_limits<int64_t>::min()};
+    for (const Signed& u : {big, -big, Signed(5), Signed(-5), Signed()}) {
+        for (int64_t i : values) {
+            const Signed v = impl::toSigned(i);
+            EXPECT_EQ(u + v, u + i) << u << " " << i;
+            EXPECT_EQ(v + u, i + u) << u << " " << i;
+            EXPECT_EQ(u - v, u - i) << u << " " << i;
+            EXPECT_EQ(v - u, i - u) << u << " " << i;
+            EXPECT_EQ(u * v, u * i) << u << " " << i;
+            EXPECT_EQ(v * u, i * u) << u << " " << i;
+            EXPECT_EQ(u == v, u == i);
+            EXPECT_EQ(u != v, i != u);
+            EXPECT_EQ(u < v, u < i) << u << " " << i;
+            EXPECT_EQ(v < u, i < u) << u << " " << i;
+            EXPECT_EQ(u >= v, u >= i);
+            EXPECT_EQ(u > v, u > i);
+            EXPECT_EQ(u <= v, u <= i);
+            if (i != 0) {
+                EXPECT_EQ(u / v, u / i) << u << " " << i;
+                EXPECT_EQ(u % v, u % i) << u << " " << i;
+            } else {
+                EXPECT_THROW(u / i, invalid_argument);
+                EXPECT_THROW(u % i, invalid_argument);
+            }
+            if (!u.abs().empty()) {
+                EXPECT_EQ(v / u, i / u) << u << " " << i;
+                EXPECT_EQ(v % u, i % u) << u << " " << i;
+            }
+        }
+    }
+    Signed w = -10;
+    w += 3u;
+    EXPECT_EQ(-7, w);
+    w -= -20;
+    EXPECT_EQ(13, w);
+    w *= -2LL;
+    EXPECT_EQ(-26, w);
+    w /= 4;
+    EXPECT_EQ(-6, w);
+    w %= 4;
+    EXPECT_EQ(-2, w);
+    w %= 2;
+    EXPECT_EQ(Signed(), w);
+    EXPECT_TRUE(Signed(-1) < 0);
+    EXPECT_TRUE(-3 < Signed(-2));
+    EXPECT_TRUE(uint64_t(-1) > Signed(numeric_limits<int64_t>::max()));
+}
+//------------------------------------------------------------------------------
+TEST(SignedTest, divexact)
+{
+    const Signed p("8683317618811886495518194401279999999");
+    const Signed q("-1066340417491710595814572169");
+
+    EXPECT_EQ(q, divexact(p * q, p));
+    EXPECT_EQ(p, divexact(p * q, q));
+    EXPECT_EQ(-p, divexact(-p * q, q));
+    EXPECT_EQ(Signed(), divexact(Signed(), q));
+    EXPECT_EQ(0, divexact(Signed(), q).sgn());
+    EXPECT_THROW(divexact(p, Signed()), std::invalid_argument);
+}
+//------------------------------------------------------------------------------
+TEST(SignedTest, isDivisible)
+{
+    const Signed p("8683317618811886495518194401279999999");
+    const Signed q("-1066340417491710595814572169");
+
+    EXPECT_TRUE(isDivisible(p * q, q));
+    EXPECT_TRUE(isDivisible(p * q, -p));
+    EXPECT_FALSE(isDivisible(p * q + 1, q));
+    EXPECT_TRUE(isDivisible(Signed(), q));
+    EXPECT_FALSE(isDivisible(q, Signed()));
+
+    EXPECT_TRUE(isDivisibleBy2Exp(Signed(-96), 5));
+    EXPECT_FALSE(isDivisibleBy2Exp(Signed(-96), 6));
+
+    EXPECT_TRUE(isCongruent(Signed(-3), Signed(4), Signed(7)));
+    EXPECT_TRUE(isCongruent(Signed(-3), Signed(4), Signed(-7)));
+    EXPECT_FALSE(isCongruent(Signed(-3), Signed(3), Signed(7)));
+    EXPECT_TRUE(isCongruent(p * q - 2, Signed(-2), q));
+    EXPECT_TRUE(isCongruent(q, q, Signed()));
 }
 //------------------------------------------------------------------------------
 TEST(SignedTest, operatorStream)
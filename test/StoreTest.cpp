@@ -175,6 +175,28 @@ TEST(StoreTest, copyAssignmentHeapFromSMem)
     }
 }
 //------------------------------------------------------------------------------
+TEST(StoreTest, copyAssignmentHeapFromSMemThenMove)
+{
+    bn::impl::Store source;
+    source.resize(bn::impl::Store::smemsize + 1);
+    for (std::size_t i = 0; i < source.size(); ++i) {
+        source[i] = static_cast<bn::impl::digit_t>(i);
+    }
+
+    bn::impl::Store target;
+    target = source;
+    bn::impl::Store other;
+    other.resize(bn::impl::Store::smemsize + 2);
+    for (std::size_t i = 0; i < other.size(); ++i) {
+        other[i] = static_cast<bn::impl::digit_t>(i + 1);
+    }
+    target = std::move(other);
+    ASSERT_EQ(bn::impl::Store::smemsize + 2, target.size());
+    for (std::size_t i = 0; i < target.size(); ++i) {
+        EXPECT_EQ(static_cast<bn::impl::digit_t>(i + 1), target[i]);
+    }
+}
+//------------------------------------------------------------------------------
 TEST(StoreTest, copyAssignmentHeapGrow)
 {
     bn::impl::Store source;
@@ -356,3 +378,24 @@ TEST(StoreTest, resizeShrinkRealloc)
         EXPECT_EQ(static_cast<bn::impl::digit_t>(i), store[i]);
     }
 }
+//------------------------------------------------------------------------------
+TEST(StoreTest, setSizeKeepsCapacity)
+{
+    bn::impl::Store store;
+    store.setSize(4 * bn::impl::Store::smemsize);
+    for (std::size_t i = 0; i < store.size(); ++i) {
+        store[i] = static_cast<bn::impl::digit_t>(i);
+    }
+    const bn::impl::digit_t* mem = &store[0];
+    store.setSize(1);
+    store.setSize(3 * bn::impl::Store::smemsize);
+    EXPECT_EQ(mem, &store[0]);
+    ASSERT_EQ(3 * bn::impl::Store::smemsize, store.size());
+    for (std::size_t i = 0; i < store.size(); ++i) {
+        EXPECT_EQ(static_cast<bn::impl::digit_t>(i), store[i]);
+    }
+    store.setSize(5 * bn::impl::Store::smemsize);
+    for (std::size_t i = 0; i < 3 * bn::impl::Store::smemsize; ++i) {
+        EXPECT_EQ(static_cast<bn::impl::digit_t>(i), store[i]);
+    }
+}
@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2024 Stefan Uhrig
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+//------------------------------------------------------------------------------
+#include "bignum.h"
+
+#include <gmock/gmock.h>
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <vector>
+//------------------------------------------------------------------------------
+using namespace bn;
+using namespace std;
+//------------------------------------------------------------------------------
+namespace {
+//------------------------------------------------------------------------------
+vector<Unsigned> randomNumbers(size_t count)
+{
+    mt19937 gen(0);
+    vector<Unsigned> numbers;
+    for (size_t i = 0; i < count; ++i) {
+        numbers.push_back(Unsigned::random(gen() % 300, gen));
+    }
+    return numbers;
+}
+//------------------------------------------------------------------------------
+void expectColumn(const vector<Unsigned>& numbers, const UnsignedColumn& c)
+{
+    ASSERT_EQ(numbers.size(), c.size());
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        EXPECT_EQ(numbers[i], c[i]);
+    }
+}
+//------------------------------------------------------------------------------
+}  // namespace
+//------------------------------------------------------------------------------
+TEST(UnsignedColumnTest, pushBack)
+{
+    UnsignedColumn c;
+    EXPECT_EQ(0u, c.size());
+    EXPECT_EQ(0u, c.totalDigits());
+    EXPECT_FALSE(c.mapped());
+    vector<Unsigned> numbers = randomNumbers(100);
+    size_t digits = 0;
+    for (const Unsigned& u : numbers) {
+        c.push_back(u);
+        digits += u.digits();
+    }
+    EXPECT_EQ(digits, c.totalDigits());
+    expectColumn(numbers, c);
+
+    c.push_back(c[3]);
+    numbers.push_back(numbers[3]);
+    expectColumn(numbers, c);
+    EXPECT_EQ(numbers[3] * numbers[4], c[3] * c[4]);
+
+    UnsignedColumn d(std::move(c));
+    expectColumn(numbers, d);
+    EXPECT_EQ(0u, c.size());
+    c = std::move(d);
+    expectColumn(numbers, c);
+}
+//------------------------------------------------------------------------------
+TEST(UnsignedColumnTest, saveAndLoad)
+{
+    const string path = "UnsignedColumnTest.bin";
+    const vector<Unsigned> numbers = randomNumbers(200);
+    UnsignedColumn c;
+    c.reserve(numbers.size(), 0);
+    for (const Unsigned& u : numbers) {
+        c.push_back(u);
+    }
+    c.save(path);
+
+    UnsignedColumn read = UnsignedColumn::load(path, false);
+    EXPECT_FALSE(read.mapped());
+    expectColumn(numbers, read);
+
+    UnsignedColumn mapped = UnsignedColumn::load(path);
+    expectColumn(numbers, mapped);
+    if (mapped.mapped()) {
+        EXPECT_THROW(mapped.push_back(Unsigned(1)), std::logic_error);
+    }
+    UnsignedColumn moved(std::move(mapped));
+    expectColumn(numbers, moved);
+
+    UnsignedColumn().save(path);
+    EXPECT_EQ(0u, UnsignedColumn::load(path).size());
+    EXPECT_EQ(0u, UnsignedColumn::load(path, false).size());
+
+    {
+        ofstream out(path.c_str(), ios::binary | ios::trunc);
+        out << "not a column file, but long enough for a header";
+    }
+    EXPECT_THROW(UnsignedColumn::load(path), std::runtime_error);
+    EXPECT_THROW(UnsignedColumn::load(path, false), std::runtime_error);
+    remove(path.c_str());
+    EXPECT_THROW(UnsignedColumn::load(path), std::runtime_error);
+    EXPECT_THROW(UnsignedColumn::load(path, false), std::runtime_error);
+}
@@ -21,8 +21,12 @@
 #include "uint128.h"
 
 #include <gmock/gmock.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <utility>
 //------------------------------------------------------------------------------
 using namespace bn;
@@ -153,6 +157,463 @@ TEST(UnsignedTest, constructFromString)
     EXPECT_THROW(Unsigned temp2("a"), invalid_argument);
 }
 //------------------------------------------------------------------------------
+TEST(UnsignedTest, fromStringAndStrWithBase)
+{
+    EXPECT_EQ("ff", Unsigned(255).str(16));
+    EXPECT_EQ("FF", Unsigned(255).str(16, true));
+    EXPECT_EQ("377", Unsigned(255).str(8));
+    EXPECT_EQ("11111111", Unsigned(255).str(2));
+    EXPECT_EQ("73", Unsigned(255).str(36));
+    EXPECT_EQ("0", Unsigned().str(2));
+    EXPECT_EQ("0", Unsigned().str(7));
+    EXPECT_EQ(Unsigned(255), Unsigned::fromString("fF", 16));
+    EXPECT_EQ(Unsigned(255), Unsigned::fromString("0000377", 8));
+    EXPECT_EQ(Unsigned(255), Unsigned::fromString("73", 36));
+    EXPECT_EQ(Unsigned(), Unsigned::fromString("000", 3));
+    EXPECT_EQ(
+        Unsigned("1208925819614629174706175"),
+        Unsigned::fromString("ffffffffffffffffffff", 16));
+    EXPECT_THROW(Unsigned::fromString("", 16), invalid_argument);
+    EXPECT_THROW(Unsigned::fromString("12", 2), invalid_argument);
+    EXPECT_THROW(Unsigned::fromString("g", 16), invalid_argument);
+    EXPECT_THROW(Unsigned::fromString("-1", 10), invalid_argument);
+    EXPECT_THROW(Unsigned::fromString("1", 1), invalid_argument);
+    EXPECT_THROW(Unsigned::fromString("1", 37), invalid_argument);
+    EXPECT_THROW(Unsigned(1).str(0), invalid_argument);
+    EXPECT_THROW(Unsigned(1).str(37), invalid_argument);
+}
+//------------------------------------------------------------------------------
+TEST(UnsignedTest, strWithBaseLarge)
+{
+    std::mt19937 gen(0);
+    for (unsigned base = 2; base <= 36; ++base) {
+        Unsigned u = Unsigned::random(1500 + 97 * base, gen);
+        std::string expected;
+        for (Unsigned temp = u; !temp.empty(); temp /= base) {
+            expected.push_back(
+                "0123456789abcdefghijklmnopqrstuvwxyz"[static_cast<uint64_t>(
+                    temp % base)]);
+        }
+        std::reverse(expected.begin(), expected.end());
+        EXPECT_EQ(expected, u.str(base));
+        EXPECT_EQ(u, Unsigned::fromString(expected, base));
+    }
+    // Powers of the base need padding with zeros when split.
+    for (unsigned base : {3u, 10u, 36u}) {
+        Unsigned p = pow(Unsigned(base), 777);
+        EXPECT_EQ("1" + std::string(777, '0'), p.str(base));
+        EXPECT_EQ(p, Unsigned::fromString("1" + std::string(777, '0'), base));
+        --p;
+        EXPECT_EQ(p, Unsigned::fromString(p.str(base), base));
+    }
+}
+//------------------------------------------------------------------------------
+TEST(UnsignedTest, toChars)
+{
+    std::mt19937 gen(0);
+    char buf[4096];
+    for (unsigned base : {2u, 7u, 10u, 16u, 36u}) {
+        Unsigned u = Unsigned::random(3000, gen);
+        const std::string s = u.str(base);
+        ASSERT_LE(s.size(), maxChars(u, base));
+        ToCharsResult r = to_chars(buf, buf + sizeof(buf), u, base);
+        EXPECT_EQ(std::errc(), r.ec);
+        EXPECT_EQ(s, std::string(buf, r.ptr));
+        // Exact size is enough even if it is below the bound.
+        r = to_chars(buf, buf + s.size(), u, base);
+        EXPECT_EQ(std::errc(), r.ec);
+        EXPECT_EQ(s, std::string(buf, r.ptr));
+        r = to_chars(buf, buf + s.size() - 1, u, base);
+        EXPECT_EQ(std::errc::value_too_large, r.ec);
+        EXPECT_EQ(buf + s.size() - 1, r.ptr);
+    }
+    ToCharsResult r = to_chars(buf, buf + 1, Unsigned(), 10);
+    EXPECT_EQ(std::errc(), r.ec);
+    EXPECT_EQ("0", std::string(buf, r.ptr));
+    EXPECT_EQ(std::errc::value_too_large, to_chars(buf, buf, Unsigned()).ec);
+    EXPECT_EQ(
+        std::errc::invalid_argument, to_chars(buf, buf + 10, Unsigned(), 1).ec);
+    EXPECT_EQ(0u, maxChars(Unsigned(), 37));
+}
+//------------------------------------------------------------------------------
+TEST(UnsignedTest, fromChars)
+{
+    const char s[] = {'1', '2', '3', 'x', '4'};
+    Unsigned u;
+    FromCharsResult r = from_chars(s, s + 2, u);
+    EXPECT_EQ(std::errc(), r.ec);
+    EXPECT_EQ(s + 2, r.ptr);
+    EXPECT_EQ(Unsigned(12), u);
+    r = from_chars(s, s + sizeof(s), u);
+    EXPECT_EQ(s + 3, r.ptr);
+    EXPECT_EQ(Unsigned(123), u);
+    r = from_chars(s, s + sizeof(s), u, 2);
+    EXPECT_EQ(s + 1, r.ptr);
+    EXPECT_EQ(Unsigned(1), u);
+    r = from_chars(s + 3, s + sizeof(s), u, 16);
+    EXPECT_EQ(std::errc::invalid_argument, r.ec);
+    EXPECT_EQ(s + 3, r.ptr);
+    EXPECT_EQ(Unsigned(1), u);
+    r = from_chars(s + 3, s + sizeof(s), u, 36);
+    EXPECT_EQ(s + 5, r.ptr);
+    EXPECT_EQ(Unsigned(33 * 36 + 4), u);
+    EXPECT_EQ(std::errc::invalid_argument, from_chars(s, s, u).ec);
+    EXPECT_EQ(std::errc::invalid_argument, from_chars(s, s + 1, u, 0).ec);
+}
+//------------------------------------------------------------------------------
+TEST(UnsignedTest, fromBytesAndToBytes)
+{
+    const std::uint8_t le[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06};
+    const std::uint8_t be[] = {0x06, 0x05, 0x04, 0x03, 0x02, 0x01};
+    Unsigned u = Unsigned::fromString("60504030201", 16);
+    EXPECT_EQ(u, Unsigned::fromBytes(le, sizeof(le)));
+    EXPECT_EQ(u, Unsigned::fromBytes(be, sizeof(be), Endianness::big));
+    EXPECT_EQ(u, Unsigned::fromBytes(be, sizeof(be), Endianness::big, 2));
+    EXPECT_EQ(
+        std::vector<std::uint8_t>(le, le + sizeof(le)),
+        u.toBytes(Endianness::little));
+    EXPECT_EQ(
+        std::vector<std::uint8_t>(be, be + sizeof(be)),
+        u.toBytes(Endianness::big));
+    EXPECT_EQ(8u, u.toBytes(Endianness::big, 4).size());
+    EXPECT_TRUE(Unsigned::fromBytes(le, 0).empty());
+    EXPECT_TRUE(Unsigned().toBytes().empty());
+
+    const std::uint32_t words[] = {0x89abcdef, 0x01234567, 0};
+    Unsigned w =
+        Unsigned::fromBytes(words, sizeof(words), Endianness::native, 4);
+    EXPECT_EQ(Unsigned(UINT64_C(0x0123456789abcdef)), w);
+    std::uint32_t out[3] = {1, 1, 1};
+    w.toBytes(out, sizeof(out), Endianness::native, 4);
+    EXPECT_EQ(0x89abcdefu, out[0]);
+    EXPECT_EQ(0x01234567u, out[1]);
+    EXPECT_EQ(0u, out[2]);
+
+    std::uint8_t buf[5] = {};
+    EXPECT_THROW(u.toBytes(buf, sizeof(buf)), std::overflow_error);
+    EXPECT_THROW(Unsigned::fromBytes(le, 5, Endianness::big, 2),
+                 std::invalid_argument);
+    EXPECT_THROW(Unsigned::fromBytes(le, 6, Endianness::big, 0),
+                 std::invalid_argument);
+
+    std::mt19937 gen(0);
+    const Endianness orders[] = {
+        Endianness::little, Endianness::big, Endianness::native};
+    for (std::size_t bits = 1; bits < 600; bits += 37) {
+        Unsigned r = Unsigned::random(bits, gen);
+        for (Endianness order : orders) {
+            for (std::size_t ws = 1; ws <= 8; ws *= 2) {
+                std::vector<std::uint8_t> b = r.toBytes(order, ws);
+                EXPECT_EQ(0u, b.size() % ws);
+                EXPECT_EQ(
+                    r, Unsigned::fromBytes(b.data(), b.size(), order, ws));
+            }
+        }
+    }
+}
+//------------------------------------------------------------------------------
+TEST(UnsignedTest, serialize)
+{
+    Unsigned u = Unsigned::fromString("102030405060708090a0b0c0d0e0f", 16);
+    unsigned char buf[32];
+    ASSERT_EQ(17u, serializedSize(u));
+    EXPECT_EQ(17u, serialize(buf, sizeof(buf), u));
+    EXPECT_EQ(0x10, buf[0]);
+    EXPECT_EQ(15, buf[1]);
+    EXPECT_EQ(0x0f, buf[2]);
+    EXPECT_EQ(0x01, buf[16]);
+    Unsigned v;
+    EXPECT_EQ(17u, deserialize(buf, sizeof(buf), v));
+    EXPECT_EQ(u, v);
+    EXPECT_THROW(serialize(buf, 16, u), std::length_error);
+    EXPECT_THROW(deserialize(buf, 16, v), std::invalid_argument);
+    buf[0] = 0x20;
+    EXPECT_THROW(deserialize(buf, sizeof(buf), v), std::invalid_argument);
+    buf[0] = 0x11;
+    EXPECT_THROW(deserialize(buf, sizeof(buf), v), std::invalid_argument);
+    EXPECT_EQ(u, v);
+
+    EXPECT_EQ(2u, serializedSize(Unsigned()));
+    Unsigned big = Unsigned(1) << 1100;
+    EXPECT_EQ(141u, serializedSize(big));
+
+    stringstream ss;
+    serialize(ss, u);
+    serialize(ss, Unsigned());
+    serialize(ss, big);
+    Unsigned a, b, c;
+    deserialize(ss, a);
+    deserialize(ss, b);
+    deserialize(ss, c);
+    EXPECT_EQ(u, a);
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(big, c);
+    EXPECT_THROW(deserialize(ss, a), std::invalid_argument);
+
+    const unsigned char huge[] = {0x10, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                  0xff, 0xff, 0xff, 0xff, 0xff, 0x01};
+    EXPECT_THROW(deserialize(huge, sizeof(huge), a), std::invalid_argument);
+    stringstream truncated(string(reinterpret_cast<const char*>(huge), 6));
+    EXPECT_THROW(deserialize(truncated, a), std::invalid_argument);
+}
+//------------------------------------------------------------------------------
+TEST(UnsignedTest, view)
+{
+    std::mt19937 gen(0);
+    Unsigned u = Unsigned::random(300, gen);
+    Unsigned v = Unsigned::random(130, gen) + 1;
+    vector<digit_t> ud(u.digits() + 3, 0);
+    vector<digit_t> vd(v.digits(), 0);
+    std::copy(UnsignedView(u).data(), UnsignedView(u).data() + u.digits(),
+              ud.begin());
+    std::copy(UnsignedView(v).data(), UnsignedView(v).data() + v.digits(),
+              vd.begin());
+    UnsignedView uv(ud.data(), ud.size());
+    UnsignedView vv(vd.data(), vd.size());
+    EXPECT_EQ(u.digits(), uv.digits());
+    EXPECT_EQ(u.bits(), uv.bits());
+    EXPECT_EQ(u, Unsigned(uv));
+    EXPECT_TRUE(uv == u);
+    EXPECT_TRUE(u != vv);
+    EXPECT_TRUE(vv < uv);
+    EXPECT_TRUE(uv > v);
+    EXPECT_TRUE(uv >= uv);
+    EXPECT_TRUE(v <= vv);
+    EXPECT_EQ(u + v, uv + vv);
+    EXPECT_EQ(u - v, uv - v);
+    EXPECT_EQ(u * v, u * vv);
+    EXPECT_EQ(u / v, uv / vv);
+    EXPECT_EQ(u % v, uv % vv);
+    EXPECT_EQ(div(u, v), div(uv, vv));
+    EXPECT_EQ(u / 7, uv / UnsignedView(Unsigned(7)));
+    EXPECT_THROW(vv - uv, std::invalid_argument);
+    EXPECT_THROW(uv / UnsignedView(), std::invalid_argument);
+    EXPECT_EQ(u.str(), uv.str());
+    EXPECT_EQ(u.str(16, true), uv.str(16, true));
+
+    char buf[128];
+    ASSERT_LE(maxChars(u), maxChars(uv));
+    ToCharsResult r = to_chars(buf, buf + sizeof(buf), uv);
+    EXPECT_EQ(u.str(), string(buf, r.ptr));
+    ostringstream os;
+    os << hex << uv;
+    EXPECT_EQ(u.str(16), os.str());
+
+    vector<digit_t> zeros(4, 0);
+    UnsignedView zv(zeros.data(), zeros.size());
+    EXPECT_TRUE(zv.empty());
+    EXPECT_EQ(0u, zv.bits());
+    EXPECT_TRUE(zv == UnsignedView());
+    EXPECT_TRUE(Unsigned(zv).empty());
+    EXPECT_EQ("0", zv.str());
+}
+//------------------------------------------------------------------------------
+TEST(UnsignedTest, parallelMultiply)
+{
+    std::mt19937 gen(0);
+    vector<pair<Unsigned, Unsigned>> operands;
+    const size_t bits[][2] = {{8, 8}, {100, 100}, {1000, 1000}, {5000, 64},
+                              {64, 5000}, {3001, 777}, {4096, 4096}};
+    for (const auto& b : bits) {
+        operands.emplace_back(
+            Unsigned::random(b[0], gen), Unsigned::random(b[1], gen));
+    }
+    operands.emplace_back(Unsigned(1) << 3000, Unsigned::random(3000, gen));
+    vector<Unsigned> serial;
+    for (const auto& o : operands) {
+        serial.push_back(o.first * o.second);
+    }
+    EXPECT_EQ(1u, threadCount());
+    setThreadCount(4);
+    EXPECT_EQ(4u, threadCount());
+    for (size_t i = 0; i < operands.size(); ++i) {
+        EXPECT_EQ(serial[i], operands[i].first * operands[i].second);
+    }
+    setThreadCount(3);
+    EXPECT_EQ(3u, threadCount());
+    for (size_t i = 0; i < operands.size(); ++i) {
+        EXPECT_EQ(serial[i], operands[i].second * operands[i].first);
+    }
+    setThreadCount(1);
+    EXPECT_EQ(1u, threadCount());
+}
+//------------------------------------------------------------------------------
+TEST(UnsignedTest, parallelStrAndParse)
+{
+    std::mt19937 gen(0);
+    vector<Unsigned> numbers;
+    for (size_t bits = 1; bits < 20000; bits = 3 * bits + 1) {
+        numbers.push_back(Unsigned::random(bits, gen));
+    }
+    numbers.push_back(pow(Unsigned(10), 3000));
+    vector<string> dec;
+    vector<string> b7;
+    for (const Unsigned& u : numbers) {
+        dec.push_back(u.str());
+        b7.push_back(u.str(7));
+    }
+    setThreadCount(4);
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        EXPECT_EQ(dec[i], numbers[i].str());
+        EXPECT_EQ(b7[i], numbers[i].str(7));
+        EXPECT_EQ(numbers[i], Unsigned(dec[i].c_str()));
+        EXPECT_EQ(numbers[i], Unsigned::fromString(b7[i], 7));
+    }
+    string bad = dec.back();
+    bad[bad.size() / 3] = 'x';
+    EXPECT_THROW(Unsigned(bad.c_str()), std::invalid_argument);
+    bad = dec.back();
+    bad[bad.size() - 5] = 'x';
+    EXPECT_THROW(Unsigned(bad.c_str()), std::invalid_argument);
+    setThreadCount(1);
+}
+//------------------------------------------------------------------------------
+TEST(UnsignedTest, nestedParallelTasks)
+{
+    setThreadCount(4);
+    std::atomic<size_t> leaves(0);
+    std::function<void(size_t)> fork = [&](size_t depth) {
+        if (depth == 0) {
+            ++leaves;
+            return;
+        }
+        impl::ThreadPool::instance().run(
+            3, [&](size_t) { fork(depth - 1); });
+    };
+    fork(6);
+    EXPECT_EQ(729u, leaves.load());
+    EXPECT_THROW(
+        impl::ThreadPool::instance().run(
+            8,
+            [](size_t i) {
+                impl::ThreadPool::instance().run(2, [i](size_t j) {
+                    if (i == 5 && j == 1) {
+                        throw std::runtime_error("task");
+                    }
+                });
+            }),
+        std::runtime_error);
+    std::vector<Unsigned> expected{pi(2000), e(2000), bn::log2(1000)};
+    setThreadCount(1);
+    EXPECT_EQ(expected[0], pi(2000));
+    EXPECT_EQ(expected[1], e(2000));
+    EXPECT_EQ(expected[2], bn::log2(1000));
+}
+//------------------------------------------------------------------------------
+TEST(UnsignedTest, radixCache)
+{
+    std::mt19937 gen(0);
+    const Unsigned u = Unsigned::random(6000, gen);
+    const string dec = u.str();
+    const string b36 = u.str(36);
+
+    clearCaches();
+    EXPECT_EQ(0u, cacheMemory());
+    prewarmCaches(dec.size());
+    const size_t warm = cacheMemory();
+    EXPECT_GT(warm, 0u);
+    EXPECT_EQ(dec, u.str());
+    EXPECT_EQ(u, Unsigned(dec.c_str()));
+    EXPECT_EQ(warm, cacheMemory());
+    prewarmCaches(dec.size(), 16);
+    EXPECT_EQ(warm, cacheMemory());
+    EXPECT_THROW(prewarmCaches(10, 37), std::invalid_argument);
+
+    clearCaches();
+    const size_t limit = cacheLimit();
+    setCacheLimit(0);
+    EXPECT_EQ(0u, cacheLimit());
+    EXPECT_EQ(dec, u.str());
+    EXPECT_EQ(u, Unsigned::fromString(b36, 36));
+    EXPECT_EQ(0u, cacheMemory());
+    setCacheLimit(limit);
+
+    vector<std::thread> threads;
+    std::atomic<size_t> errors(0);
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 2; ++i) {
+                if ((u.str() != dec) || (u.str(36) != b36)
+                    || (Unsigned(dec.c_str()) != u)) {
+                    ++errors;
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(0u, errors.load());
+    EXPECT_GT(cacheMemory(), 0u);
+}
+//------------------------------------------------------------------------------
+TEST(UnsignedTest, traceHook)
+{
+    vector<TraceEvent> events;
+    auto hook = [&](const TraceEvent& e) {
+        events.push_back(e);
+        // Not reported.
+        (Unsigned(1) << 1000) * (Unsigned(1) << 1000);
+    };
+    const Unsigned u = Unsigned(1) << (200 * bitsPerDigit - 1);
+    const Unsigned v = Unsigned(1) << (150 * bitsPerDigit - 1);
+    setTraceHook(hook, 100, std::chrono::hours(1));
+    const Unsigned w = u * v;
+    EXPECT_EQ(v, v * Unsigned(3) / Unsigned(3));
+    ASSERT_EQ(3u, events.size());
+    EXPECT_EQ(Operation::multiply, events[0].operation);
+    EXPECT_STREQ("multiply", events[0].name);
+    EXPECT_EQ(200u, events[0].digits[0]);
+    EXPECT_EQ(150u, events[0].digits[1]);
+    EXPECT_EQ(0u, events[0].digits[2]);
+    EXPECT_GE(events[0].elapsed.count(), 0);
+    EXPECT_EQ(Operation::multiply, events[1].operation);
+    EXPECT_EQ(Operation::divide, events[2].operation);
+    EXPECT_EQ(151u, events[2].digits[0]);
+    EXPECT_EQ(1u, events[2].digits[1]);
+
+    // A duration of 0 places no condition on the duration.
+    events.clear();
+    setTraceHook(hook, 100, std::chrono::hours(0));
+    EXPECT_EQ("10", (Unsigned(3) + Unsigned(7)).str());
+    EXPECT_TRUE(events.empty());
+    EXPECT_EQ(w, u * v);
+    ASSERT_EQ(1u, events.size());
+    EXPECT_EQ(Operation::multiply, events[0].operation);
+
+    events.clear();
+    setTraceHook(hook, 0, std::chrono::hours(1));
+    EXPECT_EQ(w, u * v);
+    EXPECT_TRUE(events.empty());
+
+    events.clear();
+    setTraceHook(hook, 0, std::chrono::hours(0));
+    EXPECT_EQ("10", (Unsigned(3) + Unsigned(7)).str());
+    ASSERT_EQ(2u, events.size());
+    EXPECT_EQ(Operation::add, events[0].operation);
+    EXPECT_EQ(Operation::format, events[1].operation);
+
+    events.clear();
+    setTraceHook(nullptr, 0, std::chrono::hours(0));
+    EXPECT_EQ(w, u * v);
+    EXPECT_TRUE(events.empty());
+}
+//------------------------------------------------------------------------------
+TEST(UnsignedTest, constructFromLiteral)
+{
+    Unsigned u = 123456789012345678901234567890_bn;
+    EXPECT_EQ("123456789012345678901234567890", u.str());
+    Unsigned p = 6277101735386680763835789423207666416083908700390324961279_bn;
+    EXPECT_EQ((Unsigned(1) << 192) - (Unsigned(1) << 64) - Unsigned(1), p);
+    EXPECT_TRUE(Unsigned(0_bn).empty());
+    // Leading zeros, as in 0777_bn, are rejected at compile time.
+    EXPECT_EQ(Unsigned(255), Unsigned(255_bn));
+    EXPECT_EQ(Unsigned(256), Unsigned(256_bn));
+    EXPECT_EQ(Unsigned(UINT64_MAX), Unsigned(18446744073709551615_bn));
+    Signed s = -18446744073709551616_bn;
+    EXPECT_EQ("-18446744073709551616", s.str());
+}
+//------------------------------------------------------------------------------
 TEST(UnsignedTest, randomCreate)
 {
     std::mt19937 gen(0);
@@ -777,6 +1238,34 @@ TEST(Unsigned, divQuotientFind)
     EXPECT_EQ(Unsigned("259"), qr.rem);
 }
 //------------------------------------------------------------------------------
+TEST(UnsignedTest, shortProducts)
+{
+    const Unsigned u("8683317618811886495518194401279999999");
+    const Unsigned v("1066340417491710595814572169");
+    const std::size_t bits = impl::bitsPerDigit;
+    const Unsigned p = u * v;
+
+    for (std::size_t n = 0; n <= p.digits() + 1; ++n) {
+        EXPECT_EQ(p % (Unsigned(1) << (n * bits)), mulLow(u, v, n)) << n;
+        const Unsigned high = p >> (n * bits);
+        const Unsigned r = mulHigh(u, v, n);
+        EXPECT_LE(r, high) << n;
+        EXPECT_LT(high, r + std::max(n, std::size_t(1))) << n;
+    }
+    EXPECT_EQ(Unsigned(), mulLow(u, Unsigned(), 3));
+    EXPECT_EQ(Unsigned(), mulHigh(u, Unsigned(), 0));
+    EXPECT_EQ(p, mulHigh(u, v, 0));
+
+    // With a single digit v the middle product is the full product.
+    EXPECT_EQ(u * 7, mulMiddle(u, Unsigned(7)));
+    EXPECT_EQ(Unsigned(), mulMiddle(u, Unsigned()));
+    // For equal lengths only the column of the highest digits remains.
+    const std::size_t top = (v.digits() - 1) * bits;
+    const Unsigned w = (Unsigned(3) << top) + 1;
+    EXPECT_EQ((v >> top) + 3 * (v % (Unsigned(1) << bits)), mulMiddle(v, w));
+    EXPECT_THROW(mulMiddle(v, u << bits), std::invalid_argument);
+}
+//------------------------------------------------------------------------------
 TEST(UnsignedTest, pow)
 {
     Unsigned base = 23;
@@ -803,6 +1292,155 @@ TEST(UnsignedTest, powmod)
     EXPECT_EQ(expected, actual);
 }
 //------------------------------------------------------------------------------
+TEST(UnsignedTest, outputParameters)
+{
+    std::mt19937 gen(7);
+    const Unsigned u = Unsigned::random(300, gen) | (Unsigned(1) << 299);
+    const Unsigned v = Unsigned::random(130, gen) | (Unsigned(1) << 129);
+    const Unsigned small = 77;
+
+    Unsigned w = Unsigned(1) << 2000;
+    add(w, u, v);
+    EXPECT_EQ(u + v, w);
+    sub(w, u, v);
+    EXPECT_EQ(u - v, w);
+    mul(w, u, v);
+    EXPECT_EQ(u * v, w);
+    EXPECT_THROW(sub(w, v, u), invalid_argument);
+
+    Unsigned q = 5;
+    Unsigned r;
+    divQR(q, r, u, v);
+    EXPECT_EQ(u / v, q);
+    EXPECT_EQ(u % v, r);
+    divQR(q, r, u, small);
+    EXPECT_EQ(u / small, q);
+    EXPECT_EQ(u % small, r);
+    divQR(q, r, v, u);
+    EXPECT_EQ(0, q);
+    EXPECT_EQ(v, r);
+    EXPECT_THROW(divQR(q, r, u, Unsigned()), invalid_argument);
+    EXPECT_THROW(divQR(q, q, u, v), invalid_argument);
+
+    // Every argument may be the destination.
+    Unsigned x = u;
+    add(x, x, v);
+    EXPECT_EQ(u + v, x);
+    x = v;
+    add(x, u, x);
+    EXPECT_EQ(u + v, x);
+    add(x, x, x);
+    EXPECT_EQ(2 * (u + v), x);
+    x = u;
+    sub(x, x, v);
+    EXPECT_EQ(u - v, x);
+    x = v;
+    sub(x, u, x);
+    EXPECT_EQ(u - v, x);
+    x = u;
+    mul(x, x, v);
+    EXPECT_EQ(u * v, x);
+    x = v;
+    mul(x, x, x);
+    EXPECT_EQ(v * v, x);
+    for (const Unsigned& d : {v, small}) {
+        q = u;
+        divQR(q, r, q, d);
+        EXPECT_EQ(u / d, q);
+        EXPECT_EQ(u % d, r);
+        r = u;
+        divQR(q, r, r, d);
+        EXPECT_EQ(u / d, q);
+        EXPECT_EQ(u % d, r);
+        q = d;
+        divQR(q, r, u, q);
+        EXPECT_EQ(u / d, q);
+        EXPECT_EQ(u % d, r);
+        r = d;
+        divQR(q, r, u, r);
+        EXPECT_EQ(u / d, q);
+        EXPECT_EQ(u % d, r);
+    }
+
+    const Unsigned e = 1000;
+    const Unsigned expected = powmod(u, 1000, v);
+    powmod(w, u, e, v);
+    EXPECT_EQ(expected, w);
+    x = u;
+    powmod(x, x, e, v);
+    EXPECT_EQ(expected, x);
+    x = e;
+    powmod(x, u, x, v);
+    EXPECT_EQ(expected, x);
+    x = v;
+    powmod(x, u, e, x);
+    EXPECT_EQ(expected, x);
+    powmod(w, u, Unsigned(), v);
+    EXPECT_EQ(1, w);
+    EXPECT_THROW(powmod(w, u, e, Unsigned()), invalid_argument);
+}
+//------------------------------------------------------------------------------
+TEST(UnsignedTest, nativeOperators)
+{
+    const Unsigned big = Unsigned("123456789012345678901234567890");
+    const uint64_t values[] = {0, 1, 7, 200, 255, 256, 65537, 1000003,
+                               uint64_t(1) << 40,
+                               numeric_limits<uint64_t>::max()};
+    for (const Unsigned& u : {big, Unsigned(5), Unsigned(300), Unsigned()}) {
+        for (uint64_t i : values) {
+            const Unsigned v = i;
+            EXPECT_EQ(u + v, u + i) << u << " " << i;
+            EXPECT_EQ(v + u, i + u) << u << " " << i;
+            EXPECT_EQ(u * v, u * i) << u << " " << i;
+            EXPECT_EQ(v * u, i * u) << u << " " << i;
+            EXPECT_EQ(u == v, u == i);
+            EXPECT_EQ(u != v, i != u);
+            EXPECT_EQ(u < v, u < i) << u << " " << i;
+            EXPECT_EQ(v < u, i < u) << u << " " << i;
+            EXPECT_EQ(u >= v, u >= i);
+            EXPECT_EQ(u > v, u > i);
+            EXPECT_EQ(u <= v, u <= i);
+            if (u >= v) {
+                EXPECT_EQ(u - v, u - i) << u << " " << i;
+            } else {
+                EXPECT_THROW(u - i, invalid_argument);
+            }
+            if (v >= u) {
+                EXPECT_EQ(v - u, i - u) << u << " " << i;
+            }
+            if (i != 0) {
+                EXPECT_EQ(u / v, u / i) << u << " " << i;
+                EXPECT_EQ(u % v, u % i) << u << " " << i;
+            } else {
+                EXPECT_THROW(u / i, invalid_argument);
+                EXPECT_THROW(u % i, invalid_argument);
+            }
+            if (!u.empty()) {
+                EXPECT_EQ(v / u, i / u) << u << " " << i;
+                EXPECT_EQ(v % u, i % u) << u << " " << i;
+            }
+        }
+    }
+    Unsigned w = 10;
+    w += 5;
+    EXPECT_EQ(15, w);
+    w -= 15u;
+    EXPECT_TRUE(w.empty());
+    w += 'a';
+    EXPECT_EQ(97, w);
+    w *= static_cast<unsigned short>(3);
+    EXPECT_EQ(291, w);
+    w /= 2L;
+    EXPECT_EQ(145, w);
+    w %= 100LL;
+    EXPECT_EQ(45, w);
+    w *= 0;
+    EXPECT_TRUE(w.empty());
+    EXPECT_THROW(w + (-1), invalid_argument);
+    EXPECT_THROW(w -= 1, invalid_argument);
+    EXPECT_THROW(w < -1, invalid_argument);
+}
+//------------------------------------------------------------------------------
 TEST(UnsignedTest, sqrt)
 {
     EXPECT_EQ(Unsigned(0), sqrt(Unsigned(0)));
@@ -813,6 +1451,45 @@ TEST(UnsignedTest, sqrt)
     }
 }
 //------------------------------------------------------------------------------
+TEST(UnsignedTest, binarySplit)
+{
+    // sum_{n=0}^{9} 2^n = 1023
+    PQT s = binarySplit(
+        0,
+        10,
+        [](size_t) -> Signed { return 1; },
+        [](size_t n) -> Signed { return (n == 0) ? 1 : 2; },
+        [](size_t) -> Signed { return 1; });
+    EXPECT_EQ(Signed(1024 / 2), s.p);
+    EXPECT_EQ(Signed(1), s.q);
+    EXPECT_EQ(Signed(1023), s.t);
+
+    PQT z = binarySplit(
+        3,
+        3,
+        [](size_t) -> Signed { return 1; },
+        [](size_t) -> Signed { return 1; },
+        [](size_t) -> Signed { return 1; });
+    EXPECT_EQ(Signed(0), z.t);
+    EXPECT_EQ(Signed(1), z.q);
+}
+//------------------------------------------------------------------------------
+TEST(UnsignedTest, constants)
+{
+    EXPECT_EQ(Unsigned(3), pi(0));
+    EXPECT_EQ(
+        Unsigned("314159265358979323846264338327950288419716939937510"),
+        pi(50));
+    EXPECT_EQ(Unsigned(2), e(0));
+    EXPECT_EQ(
+        Unsigned("271828182845904523536028747135266249775724709369995"),
+        e(50));
+    EXPECT_EQ(Unsigned(0), bn::log2(0));
+    EXPECT_EQ(
+        Unsigned("69314718055994530941723212145817656807550013436025"),
+        bn::log2(50));
+}
+//------------------------------------------------------------------------------
 TEST(UnsignedTest, zeroGcd)
 {
     Unsigned zero = 0;
@@ -877,6 +1554,74 @@ TEST(UnsignedTest, largeGcd)
     EXPECT_EQ(exp, gcd(u, v));
 }
 //------------------------------------------------------------------------------
+TEST(UnsignedTest, divexact)
+{
+    const Unsigned p("8683317618811886495518194401279999999");
+    const Unsigned q("1066340417491710595814572169");
+    const Unsigned r = Unsigned(1) << 100;
+    const Unsigned ones("340282366920938463463374607431768211455");
+
+    EXPECT_EQ(Unsigned(), divexact(Unsigned(), p));
+    EXPECT_EQ(Unsigned(1), divexact(p, p));
+    EXPECT_EQ(p, divexact(p, 1));
+    EXPECT_EQ(Unsigned(6), divexact(Unsigned(18), Unsigned(3)));
+    EXPECT_EQ(Unsigned(9), divexact(Unsigned(18), Unsigned(2)));
+    EXPECT_EQ(q, divexact(p * q, p));
+    EXPECT_EQ(p, divexact(p * q, q));
+    EXPECT_EQ(p * r, divexact(p * q * r * r, q * r));
+    EXPECT_EQ(r, divexact(r * r, r));
+    EXPECT_EQ(ones, divexact(ones * ones, ones));
+    EXPECT_EQ(ones * p, divexact(ones * p * 255, Unsigned(255)));
+    EXPECT_EQ(ones * p, divexact(ones * p * 1024, Unsigned(1024)));
+    EXPECT_EQ(Unsigned(), divexact(Unsigned(5), p));
+    EXPECT_THROW(divexact(p, Unsigned()), std::invalid_argument);
+}
+//------------------------------------------------------------------------------
+TEST(UnsignedTest, isDivisible)
+{
+    const Unsigned p("8683317618811886495518194401279999999");
+    const Unsigned q("1066340417491710595814572169");
+    const Unsigned r = Unsigned(1) << 100;
+
+    EXPECT_TRUE(isDivisible(Unsigned(), Unsigned()));
+    EXPECT_FALSE(isDivisible(p, Unsigned()));
+    EXPECT_TRUE(isDivisible(Unsigned(), p));
+    EXPECT_TRUE(isDivisible(p, 1));
+    EXPECT_TRUE(isDivisible(p, p));
+    EXPECT_FALSE(isDivisible(q, p));
+    EXPECT_TRUE(isDivisible(p * q, q));
+    EXPECT_FALSE(isDivisible(p * q + 1, q));
+    EXPECT_FALSE(isDivisible(p * q - 1, q));
+    EXPECT_TRUE(isDivisible(p * r, r));
+    EXPECT_TRUE(isDivisible(p * q * r, q * r));
+    EXPECT_FALSE(isDivisible(p * q * r, q * r * 2));
+    EXPECT_FALSE(isDivisible(p * q * (r >> 1), q * r));
+    for (unsigned d = 1; d < 100; ++d) {
+        for (unsigned i = 0; i < 2 * d; ++i) {
+            const Unsigned u = p + i;
+            EXPECT_EQ((u % d).empty(), isDivisible(u, d)) << u << " % " << d;
+        }
+    }
+
+    EXPECT_TRUE(isDivisibleBy2Exp(Unsigned(), 1000));
+    EXPECT_TRUE(isDivisibleBy2Exp(p, 0));
+    EXPECT_FALSE(isDivisibleBy2Exp(p, 1));
+    EXPECT_TRUE(isDivisibleBy2Exp(p * r, 100));
+    EXPECT_FALSE(isDivisibleBy2Exp(p * r, 101));
+    EXPECT_TRUE(isDivisibleBy2Exp(r, 100));
+    EXPECT_FALSE(isDivisibleBy2Exp(r, 101));
+    EXPECT_FALSE(isDivisibleBy2Exp(r, 1000));
+
+    EXPECT_TRUE(isCongruent(p, p, Unsigned()));
+    EXPECT_FALSE(isCongruent(p, q, Unsigned()));
+    EXPECT_TRUE(isCongruent(p, Unsigned(1), Unsigned(2)));
+    EXPECT_TRUE(isCongruent(p + 7, Unsigned(16), Unsigned(10)));
+    EXPECT_FALSE(isCongruent(p + 7, Unsigned(15), Unsigned(10)));
+    EXPECT_TRUE(isCongruent(p * q + 5, Unsigned(5), q));
+    EXPECT_TRUE(isCongruent(Unsigned(5), p * q + 5, q));
+    EXPECT_FALSE(isCongruent(p * q + 5, Unsigned(6), q));
+}
+//------------------------------------------------------------------------------
 TEST(UnsignedTest, operatorOut)
 {
     Unsigned u("123456789012345678901234567890");
@@ -884,3 +1629,15 @@ TEST(UnsignedTest, operatorOut)
     os << u;
     EXPECT_EQ(u.str(), os.str());
 }
+//------------------------------------------------------------------------------
+TEST(UnsignedTest, operatorOutBase)
+{
+    Unsigned u(0xabcdef);
+    ostringstream os;
+    os << hex << u << " " << oct << u << " " << dec << u;
+    EXPECT_EQ("abcdef 52746757 11259375", os.str());
+    ostringstream osb;
+    osb << showbase << uppercase << hex << u << " " << oct << u << " "
+        << Unsigned();
+    EXPECT_EQ("0XABCDEF 052746757 0", osb.str());
+}
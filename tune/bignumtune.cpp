@@ -0,0 +1,255 @@
+/**
+ * Copyright (c) 2024 Stefan Uhrig
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+//------------------------------------------------------------------------------
+// Measures the crossover points of the algorithms selected by the thresholds
+// of bignum.h on this machine and writes them as a header, which bignum.h
+// includes if it is found as bignum_tuning.h on the include path.
+//
+// Usage: bignumtune [output file]
+//------------------------------------------------------------------------------
+#define BN_TUNE_PROGRAM
+#include "bignum.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+//------------------------------------------------------------------------------
+using namespace bn;
+using namespace std;
+//------------------------------------------------------------------------------
+namespace {
+//------------------------------------------------------------------------------
+// Disables an algorithm. Small enough not to overflow when multiplied by the
+// number of characters per digit.
+constexpr size_t unlimited = numeric_limits<size_t>::max() / 64;
+//------------------------------------------------------------------------------
+volatile size_t sink;
+//------------------------------------------------------------------------------
+// Returns the time in seconds of one call of f as the minimum of three runs of
+// at least 10 ms each.
+double measure(const function<void()>& f)
+{
+    double best = numeric_limits<double>::max();
+    for (int run = 0; run < 3; ++run) {
+        size_t calls = 0;
+        const auto start = chrono::steady_clock::now();
+        chrono::duration<double> elapsed;
+        do {
+            f();
+            ++calls;
+            elapsed = chrono::steady_clock::now() - start;
+        } while (elapsed.count() < 0.01);
+        best = min(best, elapsed.count() / static_cast<double>(calls));
+    }
+    return best;
+}
+//------------------------------------------------------------------------------
+// Returns the smallest size n in [minSize, maxSize] for which time(n, true),
+// the time with the algorithm above the threshold, is clearly less than
+// time(n, false) for n and the next two sizes, or 0 if there is no such size or
+// if the algorithm above the threshold is not faster for maxSize.
+size_t findCrossover(
+    const char* name,
+    size_t minSize,
+    size_t maxSize,
+    const function<double(size_t, bool)>& time)
+{
+    auto faster = [&](size_t n) {
+        const double below = time(n, false);
+        const double above = time(n, true);
+        cerr << name << ": " << n << " " << below << " s " << above << " s\n";
+        return above < 0.98 * below;
+    };
+    size_t first = 0;
+    size_t wins = 0;
+    for (size_t n = minSize; n <= maxSize; n += max<size_t>(1, n / 8)) {
+        if (!faster(n)) {
+            wins = 0;
+        } else if (wins++ == 0) {
+            first = n;
+        } else if (wins == 3) {
+            return faster(maxSize) ? first : 0;
+        }
+    }
+    return 0;
+}
+//------------------------------------------------------------------------------
+// Returns a random number with exactly numDigits digits.
+Unsigned randomUnsigned(size_t numDigits, mt19937& gen)
+{
+    const size_t bits = numDigits * impl::bitsPerDigit;
+    return Unsigned::random(bits - 1, gen) | (Unsigned(1) << (bits - 1));
+}
+//------------------------------------------------------------------------------
+// Numbers with more than the threshold digits are formatted recursively.
+size_t tuneRadixFormat(size_t maxSize)
+{
+    const size_t n = findCrossover(
+        "BN_RADIX_FORMAT_THRESHOLD", 2, maxSize, [](size_t n, bool above) {
+            mt19937 gen(n);
+            const Unsigned u = randomUnsigned(n, gen);
+            impl::radixFormatThreshold = above ? n - 1 : unlimited;
+            return measure([&] { sink = u.str().size(); });
+        });
+    return (n == 0) ? 0 : n - 1;
+}
+//------------------------------------------------------------------------------
+// Strings with more than the threshold times chunkChars characters are parsed
+// recursively.
+size_t tuneRadixParse(size_t maxSize)
+{
+    const size_t chunkChars = impl::Radix(10).chunkChars;
+    const size_t n = findCrossover(
+        "BN_RADIX_PARSE_THRESHOLD", 2, maxSize, [&](size_t n, bool above) {
+            mt19937 gen(n);
+            string s(n * chunkChars, '0');
+            for (char& c : s) {
+                c = static_cast<char>('0' + gen() % 10);
+            }
+            s[0] = '1';
+            impl::radixParseThreshold = above ? n - 1 : unlimited;
+            return measure([&] { sink = Unsigned(s.c_str()).digits(); });
+        });
+    return (n == 0) ? 0 : n - 1;
+}
+//------------------------------------------------------------------------------
+// Products with at least the threshold digit multiplications are computed in
+// parallel.
+size_t tuneParallelMul(size_t maxSize)
+{
+    const size_t n = findCrossover(
+        "BN_PARALLEL_MUL_THRESHOLD", 8, maxSize, [](size_t n, bool above) {
+            mt19937 gen(n);
+            const Unsigned u = randomUnsigned(n, gen);
+            const Unsigned v = randomUnsigned(n, gen);
+            impl::parallelMulThreshold = above ? n * n : unlimited;
+            return measure([&] { sink = (u * v).digits(); });
+        });
+    return n * n;
+}
+//------------------------------------------------------------------------------
+// Numbers with at least the threshold digits are converted by converting both
+// halves in parallel.
+size_t tuneParallelRadix(size_t maxSize)
+{
+    return findCrossover(
+        "BN_PARALLEL_RADIX_THRESHOLD", 8, maxSize, [](size_t n, bool above) {
+            mt19937 gen(n);
+            const Unsigned u = randomUnsigned(n, gen);
+            impl::parallelRadixThreshold = above ? n : unlimited;
+            return measure([&] { sink = u.str().size(); });
+        });
+}
+//------------------------------------------------------------------------------
+// Binary splitting evaluates both halves of ranges with at least the
+// threshold terms in parallel.
+size_t tuneParallelSplit(size_t maxSize)
+{
+    return findCrossover(
+        "BN_PARALLEL_SPLIT_THRESHOLD", 8, maxSize, [](size_t n, bool above) {
+            impl::parallelSplitThreshold = above ? n : unlimited;
+            return measure([&] {
+                // The series of e.
+                const PQT s = binarySplit(
+                    0,
+                    n,
+                    [](size_t) -> Signed { return 1; },
+                    [](size_t) -> Signed { return 1; },
+                    [](size_t k) -> Signed { return (k == 0) ? 1 : k; });
+                sink = s.t.abs().digits();
+            });
+        });
+}
+//------------------------------------------------------------------------------
+void writeDefine(ostream& os, const char* name, size_t value, size_t maxSize)
+{
+    if (value == 0) {
+        os << "// " << name << ": no crossover up to " << maxSize
+           << ", the default is kept.\n";
+        return;
+    }
+    os << "#ifndef " << name << '\n'
+       << "#define " << name << ' ' << value << '\n'
+       << "#endif\n";
+}
+//------------------------------------------------------------------------------
+}  // namespace
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    if (argc > 2) {
+        cerr << "Usage: " << argv[0] << " [output file]\n";
+        return 1;
+    }
+    const size_t hardwareThreads = thread::hardware_concurrency();
+    const size_t maxRadix = 1 << 12;
+    const size_t maxMul = 1 << 12;
+    const size_t maxSplit = 1 << 14;
+
+    impl::parallelMulThreshold = unlimited;
+    impl::parallelRadixThreshold = unlimited;
+    impl::parallelSplitThreshold = unlimited;
+    const size_t radixFormat = tuneRadixFormat(maxRadix);
+    const size_t radixParse = tuneRadixParse(maxRadix);
+    if (radixFormat != 0) {
+        impl::radixFormatThreshold = radixFormat;
+    }
+    size_t parallelMul = 0;
+    size_t parallelRadix = 0;
+    size_t parallelSplit = 0;
+    if (hardwareThreads > 1) {
+        setThreadCount(0);
+        parallelMul = tuneParallelMul(maxMul);
+        parallelRadix = tuneParallelRadix(maxRadix);
+        parallelSplit = tuneParallelSplit(maxSplit);
+        setThreadCount(1);
+    }
+
+    ofstream file;
+    if (argc == 2) {
+        file.open(argv[1]);
+        if (!file) {
+            cerr << "Cannot open " << argv[1] << '\n';
+            return 1;
+        }
+    }
+    ostream& os = (argc == 2) ? file : cout;
+    os << "// Generated by bignumtune for " << impl::bitsPerDigit
+       << "-bit digits and " << hardwareThreads << " hardware threads.\n"
+       << "#ifndef BN_TUNED_DIGIT_BITS\n"
+       << "#define BN_TUNED_DIGIT_BITS " << impl::bitsPerDigit << '\n'
+       << "#endif\n";
+    writeDefine(os, "BN_RADIX_FORMAT_THRESHOLD", radixFormat, maxRadix);
+    writeDefine(os, "BN_RADIX_PARSE_THRESHOLD", radixParse, maxRadix);
+    if (hardwareThreads > 1) {
+        writeDefine(os, "BN_PARALLEL_MUL_THRESHOLD", parallelMul, maxMul);
+        writeDefine(os, "BN_PARALLEL_RADIX_THRESHOLD", parallelRadix, maxRadix);
+        writeDefine(os, "BN_PARALLEL_SPLIT_THRESHOLD", parallelSplit, maxSplit);
+    } else {
+        os << "// The parallel thresholds are not tuned on a single hardware "
+              "thread.\n";
+    }
+    return os ? 0 : 1;
+}